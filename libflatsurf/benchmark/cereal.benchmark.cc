@@ -0,0 +1,102 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019-2020 Vincent Delecroix
+ *        Copyright (C) 2019-2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+
+#include <benchmark/benchmark.h>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/archives/json.hpp>
+#include <sstream>
+
+#include "../flatsurf/cereal.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../test/surfaces.hpp"
+#include "random_surfaces.hpp"
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+
+namespace flatsurf::benchmark {
+using namespace flatsurf::test;
+
+namespace {
+
+// Load a surface and a saddle connection on it from an archive of type
+// InputArchive that was written with OutputArchive.
+template <typename OutputArchive, typename InputArchive, typename R2>
+void load(State& state, const FlatTriangulation<typename R2::Coordinate>& surface, const SaddleConnection<FlatTriangulation<typename R2::Coordinate>>& connection) {
+  using Surface = FlatTriangulation<typename R2::Coordinate>;
+
+  std::string serialized;
+  {
+    std::stringstream s;
+    {
+      OutputArchive archive(s);
+      archive(cereal::make_nvp("surface", surface), cereal::make_nvp("connection", connection));
+    }
+    serialized = s.str();
+  }
+
+  for (auto _ : state) {
+    std::stringstream s(serialized);
+    InputArchive archive(s);
+
+    Surface loadedSurface;
+    SaddleConnection<Surface> loadedConnection(surface, HalfEdge(1));
+    archive(cereal::make_nvp("surface", loadedSurface), cereal::make_nvp("connection", loadedConnection));
+
+    DoNotOptimize(loadedConnection);
+  }
+
+  state.counters["bytes"] = serialized.size();
+}
+
+}  // namespace
+
+template <typename R2>
+void CerealLoadJSON(State& state) {
+  const auto surface = makeMcMullenL3125<R2>();
+  load<cereal::JSONOutputArchive, cereal::JSONInputArchive, R2>(state, *surface, SaddleConnection<FlatTriangulation<typename R2::Coordinate>>::inSector(*surface, HalfEdge(1), R2(1337, 1)));
+}
+BENCHMARK_TEMPLATE(CerealLoadJSON, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(CerealLoadJSON, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void CerealLoadBinary(State& state) {
+  const auto surface = makeMcMullenL3125<R2>();
+  load<cereal::BinaryOutputArchive, cereal::BinaryInputArchive, R2>(state, *surface, SaddleConnection<FlatTriangulation<typename R2::Coordinate>>::inSector(*surface, HalfEdge(1), R2(1337, 1)));
+}
+BENCHMARK_TEMPLATE(CerealLoadBinary, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(CerealLoadBinary, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void CerealLoadJSONRandom(State& state) {
+  const auto surface = makeRandomSurface<R2>(state);
+  load<cereal::JSONOutputArchive, cereal::JSONInputArchive, R2>(state, *surface, SaddleConnection<FlatTriangulation<typename R2::Coordinate>>(*surface, HalfEdge(1)));
+}
+BENCHMARK_TEMPLATE(CerealLoadJSONRandom, Vector<mpq_class>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(CerealLoadJSONRandom, Vector<eantic::renf_elem_class>)->Apply(RandomSurfaces);
+
+template <typename R2>
+void CerealLoadBinaryRandom(State& state) {
+  const auto surface = makeRandomSurface<R2>(state);
+  load<cereal::BinaryOutputArchive, cereal::BinaryInputArchive, R2>(state, *surface, SaddleConnection<FlatTriangulation<typename R2::Coordinate>>(*surface, HalfEdge(1)));
+}
+BENCHMARK_TEMPLATE(CerealLoadBinaryRandom, Vector<mpq_class>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(CerealLoadBinaryRandom, Vector<eantic::renf_elem_class>)->Apply(RandomSurfaces);
+
+}  // namespace flatsurf::benchmark
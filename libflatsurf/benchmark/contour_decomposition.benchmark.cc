@@ -0,0 +1,117 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019-2020 Vincent Delecroix
+ *        Copyright (C) 2019-2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <type_traits>
+
+#include "../flatsurf/contour_decomposition.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/vector.hpp"
+#include "../test/surfaces.hpp"
+#include "random_surfaces.hpp"
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+
+namespace flatsurf::benchmark {
+using namespace flatsurf::test;
+
+// Construct a contour decomposition in a direction that is almost horizontal,
+// i.e., many edges need to be flipped before each component has a unique
+// large edge.
+template <typename SurfacePointer>
+void decompose(State& state, const SurfacePointer& surface) {
+  using T = typename std::decay_t<decltype(*surface)>::Coordinate;
+
+  const auto vertical = Vector<T>(1000000007, 1);
+
+  for (auto _ : state) {
+    DoNotOptimize(ContourDecomposition<FlatTriangulation<T>>(surface->clone(), vertical));
+  }
+}
+
+template <typename R2>
+void ContourDecompositionConstruct(State& state) {
+  decompose(state, makeCathedral<R2>());
+}
+BENCHMARK_TEMPLATE(ContourDecompositionConstruct, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(ContourDecompositionConstruct, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void ContourDecompositionConstructL(State& state) {
+  decompose(state, makeL<R2>());
+}
+BENCHMARK_TEMPLATE(ContourDecompositionConstructL, Vector<long long>);
+BENCHMARK_TEMPLATE(ContourDecompositionConstructL, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(ContourDecompositionConstructL, Vector<eantic::renf_elem_class>);
+BENCHMARK_TEMPLATE(ContourDecompositionConstructL, Vector<exactreal::Element<exactreal::IntegerRing>>);
+
+template <typename R2>
+void ContourDecompositionConstructGoldenL(State& state) {
+  decompose(state, makeGoldenL<R2>());
+}
+BENCHMARK_TEMPLATE(ContourDecompositionConstructGoldenL, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void ContourDecompositionConstructMcMullenL3125(State& state) {
+  decompose(state, makeMcMullenL3125<R2>());
+}
+BENCHMARK_TEMPLATE(ContourDecompositionConstructMcMullenL3125, Vector<long long>);
+BENCHMARK_TEMPLATE(ContourDecompositionConstructMcMullenL3125, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(ContourDecompositionConstructMcMullenL3125, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void ContourDecompositionConstructOctagon(State& state) {
+  decompose(state, makeOctagon<R2>());
+}
+BENCHMARK_TEMPLATE(ContourDecompositionConstructOctagon, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void ContourDecompositionConstructHeptagonL(State& state) {
+  decompose(state, makeHeptagonL<R2>());
+}
+BENCHMARK_TEMPLATE(ContourDecompositionConstructHeptagonL, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void ContourDecompositionConstruct235(State& state) {
+  decompose(state, make235<R2>());
+}
+BENCHMARK_TEMPLATE(ContourDecompositionConstruct235, Vector<eantic::renf_elem_class>);
+
+// Construct a contour decomposition of a cyclic cover of degree "range" of an
+// L, i.e., measure how the construction scales with the genus of the surface.
+template <typename R2>
+void ContourDecompositionConstructCover(State& state) {
+  decompose(state, makeCyclicCover(*makeL<R2>(), static_cast<int>(state.range(0))));
+}
+BENCHMARK_TEMPLATE(ContourDecompositionConstructCover, Vector<long long>)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_TEMPLATE(ContourDecompositionConstructCover, Vector<mpq_class>)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_TEMPLATE(ContourDecompositionConstructCover, Vector<eantic::renf_elem_class>)->RangeMultiplier(4)->Range(1, 64);
+
+template <typename R2>
+void ContourDecompositionConstructRandom(State& state) {
+  decompose(state, makeRandomSurface<R2>(state));
+}
+BENCHMARK_TEMPLATE(ContourDecompositionConstructRandom, Vector<long long>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(ContourDecompositionConstructRandom, Vector<mpq_class>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(ContourDecompositionConstructRandom, Vector<eantic::renf_elem_class>)->Apply(RandomSurfaces);
+
+}  // namespace flatsurf::benchmark
@@ -20,9 +20,18 @@
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include "../flatsurf/deformation.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
 #include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/isomorphism.hpp"
+#include "../flatsurf/odd_half_edge_map.hpp"
 #include "../flatsurf/vertical.hpp"
 #include "../test/surfaces.hpp"
+#include "random_surfaces.hpp"
 
 using benchmark::DoNotOptimize;
 using benchmark::State;
@@ -30,6 +39,25 @@ using benchmark::State;
 namespace flatsurf::benchmark {
 using namespace flatsurf::test;
 
+// Return a copy of surface whose triangles have been made very thin by
+// flipping edges that are large with respect to an almost horizontal
+// direction.
+template <typename T>
+FlatTriangulation<T> skew(const FlatTriangulation<T>& surface, int flips) {
+  auto skewed = surface.clone();
+
+  const auto vertical = Vertical(skewed, Vector<T>(1000000007, 1));
+
+  for (int i = 0; i < flips; i++)
+    for (auto e : skewed.halfEdges())
+      if (vertical.large(e)) {
+        skewed.flip(e);
+        break;
+      }
+
+  return skewed;
+}
+
 template <typename R2>
 void FlatTriangulationFlip(State& state) {
   auto L = makeL<R2>();
@@ -49,4 +77,179 @@ BENCHMARK_TEMPLATE(FlatTriangulationFlip, Vector<mpq_class>);
 BENCHMARK_TEMPLATE(FlatTriangulationFlip, Vector<eantic::renf_elem_class>);
 BENCHMARK_TEMPLATE(FlatTriangulationFlip, Vector<exactreal::Element<exactreal::IntegerRing>>);
 
+// Flip large edges of a random surface, i.e., measure how the bookkeeping of
+// a flip scales with the size of the surface.
+template <typename R2>
+void FlatTriangulationFlipRandom(State& state) {
+  auto surface = makeRandomSurface<R2>(state);
+
+  auto vertical = Vertical(*surface, R2(1000000007, 1));
+
+  for (auto _ : state) {
+    for (auto e : surface->halfEdges())
+      if (vertical.large(e)) {
+        surface->flip(e);
+        break;
+      }
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationFlipRandom, Vector<long long>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(FlatTriangulationFlipRandom, Vector<mpq_class>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(FlatTriangulationFlipRandom, Vector<eantic::renf_elem_class>)->Apply(RandomSurfaces);
+
+// Determine all automorphisms of the Delaunay cells of a surface with many
+// symmetries by searching for isomorphisms that we have not found yet.
+template <typename R2>
+void FlatTriangulationAutomorphisms(State& state) {
+  using T = typename R2::Coordinate;
+  using Transformation = std::tuple<T, T, T, T>;
+
+  auto octagon = makeOctagon<R2>();
+  octagon->delaunay();
+
+  for (auto _ : state) {
+    std::vector<Transformation> transformations;
+    while (true) {
+      const auto isomorphism = octagon->isomorphism(*octagon, ISOMORPHISM::DELAUNAY_CELLS, [&](const T& a, const T& b, const T& c, const T& d) {
+        const auto candidate = Transformation{a, b, c, d};
+        if (std::find(begin(transformations), end(transformations), candidate) != end(transformations))
+          return false;
+        transformations.push_back(candidate);
+        return true;
+      });
+      if (!isomorphism)
+        break;
+    }
+    DoNotOptimize(transformations);
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationAutomorphisms, Vector<eantic::renf_elem_class>);
+
+// Restore the Delaunay condition in a cyclic cover of degree "range" of an L
+// whose triangles have been skewed by many flips.
+template <typename R2>
+void FlatTriangulationDelaunay(State& state) {
+  const auto cover = makeCyclicCover(*makeL<R2>(), static_cast<int>(state.range(0)));
+  const auto skewed = skew(*cover, 64);
+
+  for (auto _ : state) {
+    auto surface = skewed.clone();
+    surface.delaunay();
+    DoNotOptimize(surface);
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunay, Vector<long long>)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunay, Vector<mpq_class>)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunay, Vector<eantic::renf_elem_class>)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunay, Vector<exactreal::Element<exactreal::IntegerRing>>)->RangeMultiplier(4)->Range(1, 64);
+
+// Search for an isomorphism between two differently labeled Delaunay
+// triangulations of a cyclic cover of degree "range" of an L.
+template <typename R2>
+void FlatTriangulationIsomorphism(State& state) {
+  const auto cover = makeCyclicCover(*makeL<R2>(), static_cast<int>(state.range(0)));
+
+  auto delaunay = cover->clone();
+  delaunay.delaunay();
+
+  auto skewed = skew(*cover, 64);
+  skewed.delaunay();
+
+  for (auto _ : state) {
+    DoNotOptimize(delaunay.isomorphism(skewed, ISOMORPHISM::DELAUNAY_CELLS));
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationIsomorphism, Vector<long long>)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlatTriangulationIsomorphism, Vector<mpq_class>)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlatTriangulationIsomorphism, Vector<eantic::renf_elem_class>)->RangeMultiplier(4)->Range(1, 64);
+
+// Search for an isomorphism between two differently labeled Delaunay
+// triangulations of a random surface.
+template <typename R2>
+void FlatTriangulationIsomorphismRandom(State& state) {
+  const auto original = makeRandomSurface<R2>(state);
+
+  auto delaunay = original->clone();
+  delaunay.delaunay();
+
+  auto skewed = skew(*original, 64);
+  skewed.delaunay();
+
+  for (auto _ : state) {
+    DoNotOptimize(delaunay.isomorphism(skewed, ISOMORPHISM::DELAUNAY_CELLS));
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationIsomorphismRandom, Vector<long long>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(FlatTriangulationIsomorphismRandom, Vector<mpq_class>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(FlatTriangulationIsomorphismRandom, Vector<eantic::renf_elem_class>)->Apply(RandomSurfaces);
+
+// Stretch the top square of an L by "range", i.e., deform the surface such
+// that many flips are necessary along the way.
+template <typename R2>
+void FlatTriangulationDeform(State& state) {
+  const auto L = makeL<R2>();
+
+  const auto stretch = static_cast<int>(state.range(0));
+
+  auto shift = OddHalfEdgeMap<R2>(*L);
+  shift.set(HalfEdge(7), R2(0, stretch));
+  shift.set(HalfEdge(8), R2(0, stretch));
+
+  for (auto _ : state) {
+    DoNotOptimize(L->operator+(shift));
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationDeform, Vector<long long>)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlatTriangulationDeform, Vector<mpq_class>)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlatTriangulationDeform, Vector<eantic::renf_elem_class>)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlatTriangulationDeform, Vector<exactreal::Element<exactreal::IntegerRing>>)->Range(1, 64);
+
+// Insert a marked point into an L such that some flips are necessary to make
+// room for it.
+template <typename R2>
+void FlatTriangulationInsertAt(State& state) {
+  const auto L = makeL<R2>()->scale(3);
+
+  for (auto _ : state) {
+    HalfEdge sector(1);
+    DoNotOptimize(L.insertAt(sector, R2(5, 1)));
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationInsertAt, Vector<long long>);
+BENCHMARK_TEMPLATE(FlatTriangulationInsertAt, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(FlatTriangulationInsertAt, Vector<eantic::renf_elem_class>);
+BENCHMARK_TEMPLATE(FlatTriangulationInsertAt, Vector<exactreal::Element<exactreal::IntegerRing>>);
+
+// Remove a marked point that has been inserted into an L again.
+template <typename R2>
+void FlatTriangulationEliminateMarkedPoints(State& state) {
+  HalfEdge sector(1);
+  const auto L = makeL<R2>()->scale(3).insertAt(sector, R2(5, 1)).surface();
+
+  for (auto _ : state) {
+    DoNotOptimize(L.eliminateMarkedPoints());
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationEliminateMarkedPoints, Vector<long long>);
+BENCHMARK_TEMPLATE(FlatTriangulationEliminateMarkedPoints, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(FlatTriangulationEliminateMarkedPoints, Vector<eantic::renf_elem_class>);
+BENCHMARK_TEMPLATE(FlatTriangulationEliminateMarkedPoints, Vector<exactreal::Element<exactreal::IntegerRing>>);
+
+// Restore the Delaunay condition in a random surface. (The triangulations of
+// random polygons are far from Delaunay.)
+template <typename R2>
+void FlatTriangulationDelaunayRandom(State& state) {
+  const auto original = makeRandomSurface<R2>(state);
+
+  for (auto _ : state) {
+    auto surface = original->clone();
+    surface.delaunay();
+    DoNotOptimize(surface);
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunayRandom, Vector<long long>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunayRandom, Vector<mpq_class>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunayRandom, Vector<eantic::renf_elem_class>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunayRandom, Vector<exactreal::Element<exactreal::IntegerRing>>)->Apply(RandomSurfaces);
+
 }  // namespace flatsurf::benchmark
@@ -24,6 +24,7 @@
 #include "../flatsurf/half_edge.hpp"
 #include "../flatsurf/vertical.hpp"
 #include "../test/surfaces.hpp"
+#include "random_surfaces.hpp"
 
 using benchmark::DoNotOptimize;
 using benchmark::State;
@@ -98,4 +99,33 @@ BENCHMARK_TEMPLATE(FlatTriangulationCollapsedFlipCollapsed, Vector<mpq_class>);
 BENCHMARK_TEMPLATE(FlatTriangulationCollapsedFlipCollapsed, Vector<eantic::renf_elem_class>);
 BENCHMARK_TEMPLATE(FlatTriangulationCollapsedFlipCollapsed, Vector<exactreal::Element<exactreal::IntegerRing>>);
 
+// Collapse all the vertical edges of a surface that has many of them.
+template <typename R2>
+void FlatTriangulationCollapsedConstruct(State& state) {
+  using T = typename R2::Coordinate;
+
+  const auto cathedral = makeCathedral<R2>();
+
+  for (auto _ : state) {
+    DoNotOptimize(FlatTriangulationCollapsed<T>(cathedral->clone(), Vector<T>(0, 1)));
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationCollapsedConstruct, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(FlatTriangulationCollapsedConstruct, Vector<eantic::renf_elem_class>);
+
+// Collapse all the vertical edges of a random surface. (Random origamis and
+// their covers have many vertical edges.)
+template <typename R2>
+void FlatTriangulationCollapsedConstructRandom(State& state) {
+  using T = typename R2::Coordinate;
+
+  const auto surface = makeRandomSurface<R2>(state);
+
+  for (auto _ : state) {
+    DoNotOptimize(FlatTriangulationCollapsed<T>(surface->clone(), Vector<T>(0, 1)));
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationCollapsedConstructRandom, Vector<mpq_class>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(FlatTriangulationCollapsedConstructRandom, Vector<eantic::renf_elem_class>)->Apply(RandomSurfaces);
+
 }  // namespace flatsurf::benchmark
@@ -22,6 +22,7 @@
 
 #include "../flatsurf/half_edge.hpp"
 #include "../test/surfaces.hpp"
+#include "random_surfaces.hpp"
 
 using benchmark::DoNotOptimize;
 using benchmark::State;
@@ -43,4 +44,18 @@ void FlatTriangulationCombinatorialFlip(State& state) {
 }
 BENCHMARK(FlatTriangulationCombinatorialFlip);
 
+void FlatTriangulationCombinatorialFlipRandom(State& state) {
+  auto surface = static_cast<const FlatTriangulationCombinatorial&>(*makeRandomSurface<Vector<long long>>(state)).clone();
+
+  const int N = static_cast<int>(surface.size());
+
+  int idx = 0;
+
+  for (auto _ : state) {
+    HalfEdge e = HalfEdge::fromIndex(idx++ % N);
+    surface.flip(e);
+  }
+}
+BENCHMARK(FlatTriangulationCombinatorialFlipRandom)->Apply(RandomSurfaces);
+
 }  // namespace flatsurf::benchmark
@@ -0,0 +1,116 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019-2020 Vincent Delecroix
+ *        Copyright (C) 2019-2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "../flatsurf/flow_component.hpp"
+#include "../flatsurf/flow_decomposition.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/vector.hpp"
+#include "../test/surfaces.hpp"
+#include "random_surfaces.hpp"
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+
+namespace flatsurf::benchmark {
+using namespace flatsurf::test;
+
+// Decompose a surface in the direction of one of its edges. Such a
+// decomposition needs to discover vertical saddle connections in the
+// interval exchange transformations and turn them into actual
+// SaddleConnections on the surface.
+template <typename T, typename Surface>
+void decomposeAlongEdge(State& state, const Surface& surface) {
+  const auto vertical = surface->fromHalfEdge(HalfEdge(1));
+
+  for (auto _ : state) {
+    auto decomposition = FlowDecomposition<FlatTriangulation<T>>(surface->clone(), vertical);
+    DoNotOptimize(decomposition.decompose());
+  }
+}
+
+template <typename R2>
+void FlowComponentDecomposeMcMullenL(State& state) {
+  decomposeAlongEdge<typename R2::Coordinate>(state, makeMcMullenL3125<R2>());
+}
+BENCHMARK_TEMPLATE(FlowComponentDecomposeMcMullenL, Vector<long long>);
+BENCHMARK_TEMPLATE(FlowComponentDecomposeMcMullenL, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(FlowComponentDecomposeMcMullenL, Vector<eantic::renf_elem_class>);
+BENCHMARK_TEMPLATE(FlowComponentDecomposeMcMullenL, Vector<exactreal::Element<exactreal::IntegerRing>>);
+
+template <typename R2>
+void FlowComponentDecomposeCathedral(State& state) {
+  decomposeAlongEdge<typename R2::Coordinate>(state, makeCathedral<R2>());
+}
+BENCHMARK_TEMPLATE(FlowComponentDecomposeCathedral, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(FlowComponentDecomposeCathedral, Vector<eantic::renf_elem_class>);
+
+void FlowComponentDecomposeCathedralVeech(State& state) {
+  using T = eantic::renf_elem_class;
+  decomposeAlongEdge<T>(state, makeCathedralVeech<Vector<T>>());
+}
+BENCHMARK(FlowComponentDecomposeCathedralVeech);
+
+template <typename R2>
+void FlowComponentDecomposeGoldenL(State& state) {
+  decomposeAlongEdge<typename R2::Coordinate>(state, makeGoldenL<R2>());
+}
+BENCHMARK_TEMPLATE(FlowComponentDecomposeGoldenL, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowComponentDecomposeOctagon(State& state) {
+  decomposeAlongEdge<typename R2::Coordinate>(state, makeOctagon<R2>());
+}
+BENCHMARK_TEMPLATE(FlowComponentDecomposeOctagon, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowComponentDecomposeHeptagonL(State& state) {
+  decomposeAlongEdge<typename R2::Coordinate>(state, makeHeptagonL<R2>());
+}
+BENCHMARK_TEMPLATE(FlowComponentDecomposeHeptagonL, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowComponentDecompose235(State& state) {
+  decomposeAlongEdge<typename R2::Coordinate>(state, make235<R2>());
+}
+BENCHMARK_TEMPLATE(FlowComponentDecompose235, Vector<eantic::renf_elem_class>);
+
+// Decompose a cyclic cover of degree "range" of a McMullen L, i.e., measure
+// how the decomposition scales with the genus of the surface.
+template <typename R2>
+void FlowComponentDecomposeCover(State& state) {
+  decomposeAlongEdge<typename R2::Coordinate>(state, makeCyclicCover(*makeMcMullenL3125<R2>(), static_cast<int>(state.range(0))));
+}
+BENCHMARK_TEMPLATE(FlowComponentDecomposeCover, Vector<long long>)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlowComponentDecomposeCover, Vector<mpq_class>)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlowComponentDecomposeCover, Vector<eantic::renf_elem_class>)->RangeMultiplier(4)->Range(1, 64);
+
+// Decompose a random surface in the direction of one of its edges. We only
+// run this for rational coordinates where every such direction is
+// completely periodic so the decomposition terminates quickly.
+template <typename R2>
+void FlowComponentDecomposeRandom(State& state) {
+  decomposeAlongEdge<typename R2::Coordinate>(state, makeRandomSurface<R2>(state));
+}
+BENCHMARK_TEMPLATE(FlowComponentDecomposeRandom, Vector<long long>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(FlowComponentDecomposeRandom, Vector<mpq_class>)->Apply(RandomSurfaces);
+
+}  // namespace flatsurf::benchmark
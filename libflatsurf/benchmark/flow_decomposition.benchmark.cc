@@ -0,0 +1,139 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019-2020 Vincent Delecroix
+ *        Copyright (C) 2019-2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flow_decomposition.hpp"
+#include "../flatsurf/vector.hpp"
+#include "../test/surfaces.hpp"
+#include "random_surfaces.hpp"
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+
+namespace flatsurf::benchmark {
+using namespace flatsurf::test;
+
+// Construct a flow decomposition without decomposing it any further, i.e.,
+// only time the contour decomposition and the setup of the interval exchange
+// transformations of its components.
+template <typename SurfacePointer, typename R2>
+void construct(State& state, const SurfacePointer& surface, const R2& vertical) {
+  for (auto _ : state) {
+    DoNotOptimize(FlowDecomposition<FlatTriangulation<typename R2::Coordinate>>(surface->clone(), vertical));
+  }
+}
+
+template <typename R2>
+void FlowDecompositionConstructL(State& state) {
+  construct(state, makeL<R2>(), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstructL, Vector<long long>);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructL, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructL, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowDecompositionConstructGoldenL(State& state) {
+  construct(state, makeGoldenL<R2>(), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstructGoldenL, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowDecompositionConstructMcMullenL3125(State& state) {
+  construct(state, makeMcMullenL3125<R2>(), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstructMcMullenL3125, Vector<long long>);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructMcMullenL3125, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructMcMullenL3125, Vector<eantic::renf_elem_class>);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructMcMullenL3125, Vector<exactreal::Element<exactreal::IntegerRing>>);
+
+template <typename R2>
+void FlowDecompositionConstructMcMullenL1114(State& state) {
+  construct(state, makeMcMullenL1114<R2>(), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstructMcMullenL1114, Vector<long long>);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructMcMullenL1114, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructMcMullenL1114, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowDecompositionConstructMcMullenL2111(State& state) {
+  construct(state, makeMcMullenL2111<R2>(), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstructMcMullenL2111, Vector<long long>);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructMcMullenL2111, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructMcMullenL2111, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowDecompositionConstructCathedral(State& state) {
+  construct(state, makeCathedral<R2>(), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstructCathedral, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructCathedral, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowDecompositionConstructCathedralVeech(State& state) {
+  construct(state, makeCathedralVeech<R2>(), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstructCathedralVeech, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowDecompositionConstructOctagon(State& state) {
+  construct(state, makeOctagon<R2>(), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstructOctagon, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowDecompositionConstructHeptagonL(State& state) {
+  construct(state, makeHeptagonL<R2>(), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstructHeptagonL, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowDecompositionConstruct123(State& state) {
+  construct(state, make123<R2>(), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstruct123, Vector<eantic::renf_elem_class>);
+
+template <typename R2>
+void FlowDecompositionConstruct235(State& state) {
+  construct(state, make235<R2>(), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstruct235, Vector<eantic::renf_elem_class>);
+
+// Construct a flow decomposition of a cyclic cover of degree "range" of an L,
+// i.e., measure how the construction scales with the genus of the surface.
+template <typename R2>
+void FlowDecompositionConstructCover(State& state) {
+  construct(state, makeCyclicCover(*makeL<R2>(), static_cast<int>(state.range(0))), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstructCover, Vector<long long>)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructCover, Vector<mpq_class>)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructCover, Vector<eantic::renf_elem_class>)->RangeMultiplier(4)->Range(1, 64);
+
+template <typename R2>
+void FlowDecompositionConstructRandom(State& state) {
+  construct(state, makeRandomSurface<R2>(state), R2(1000000007, 1));
+}
+BENCHMARK_TEMPLATE(FlowDecompositionConstructRandom, Vector<long long>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructRandom, Vector<mpq_class>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(FlowDecompositionConstructRandom, Vector<eantic::renf_elem_class>)->Apply(RandomSurfaces);
+
+}  // namespace flatsurf::benchmark
@@ -0,0 +1,120 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019-2020 Vincent Delecroix
+ *        Copyright (C) 2019-2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "../flatsurf/flow_component.hpp"
+#include "../flatsurf/flow_decomposition.hpp"
+#include "../flatsurf/interval_exchange_transformation.hpp"
+#include "../flatsurf/vector.hpp"
+#include "../test/surfaces.hpp"
+#include "random_surfaces.hpp"
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+
+namespace flatsurf::benchmark {
+using namespace flatsurf::test;
+
+// Run the induction on the interval exchange transformations in a direction
+// that is almost horizontal, i.e., that needs a long Zorich induction before
+// it terminates.
+template <typename R2>
+void IntervalExchangeTransformationInduction(State& state) {
+  using T = typename R2::Coordinate;
+
+  auto L = makeMcMullenL3125<R2>();
+
+  const auto vertical = R2(1000000007, 1);
+
+  for (auto _ : state) {
+    auto decomposition = FlowDecomposition<FlatTriangulation<T>>(L->clone(), vertical);
+    DoNotOptimize(decomposition.decompose());
+  }
+}
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInduction, Vector<long long>);
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInduction, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInduction, Vector<eantic::renf_elem_class>);
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInduction, Vector<exactreal::Element<exactreal::IntegerRing>>);
+
+// Run the induction and then report the connections of all the resulting
+// components, i.e., force the lengths of the interval exchange
+// transformations to be turned into saddle connections.
+template <typename R2>
+void IntervalExchangeTransformationInductionPerimeter(State& state) {
+  using T = typename R2::Coordinate;
+
+  auto L = makeMcMullenL3125<R2>();
+
+  const auto vertical = R2(1000000007, 1);
+
+  for (auto _ : state) {
+    auto decomposition = FlowDecomposition<FlatTriangulation<T>>(L->clone(), vertical);
+    decomposition.decompose();
+    for (const auto& component : decomposition.components())
+      DoNotOptimize(component.perimeter());
+  }
+}
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInductionPerimeter, Vector<long long>);
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInductionPerimeter, Vector<mpq_class>);
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInductionPerimeter, Vector<eantic::renf_elem_class>);
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInductionPerimeter, Vector<exactreal::Element<exactreal::IntegerRing>>);
+
+// Run the induction on the interval exchange transformations of a cyclic
+// cover of degree "range" of a McMullen L, i.e., measure how the induction and
+// the bookkeeping of the lengths of the intervals scale with the number of
+// labels.
+template <typename R2>
+void IntervalExchangeTransformationInductionCover(State& state) {
+  using T = typename R2::Coordinate;
+
+  auto cover = makeCyclicCover(*makeMcMullenL3125<R2>(), static_cast<int>(state.range(0)));
+
+  const auto vertical = R2(1000000007, 1);
+
+  for (auto _ : state) {
+    auto decomposition = FlowDecomposition<FlatTriangulation<T>>(cover->clone(), vertical);
+    DoNotOptimize(decomposition.decompose());
+  }
+}
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInductionCover, Vector<long long>)->RangeMultiplier(2)->Range(1, 16);
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInductionCover, Vector<mpq_class>)->RangeMultiplier(2)->Range(1, 16);
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInductionCover, Vector<eantic::renf_elem_class>)->RangeMultiplier(2)->Range(1, 16);
+
+// Run the induction on the interval exchange transformations of a random
+// surface. As for FlowComponentDecomposeRandom, we only use rational
+// coordinates so that the induction is guaranteed to terminate.
+template <typename R2>
+void IntervalExchangeTransformationInductionRandom(State& state) {
+  using T = typename R2::Coordinate;
+
+  const auto surface = makeRandomSurface<R2>(state);
+
+  const auto vertical = R2(1000000007, 1);
+
+  for (auto _ : state) {
+    auto decomposition = FlowDecomposition<FlatTriangulation<T>>(surface->clone(), vertical);
+    DoNotOptimize(decomposition.decompose());
+  }
+}
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInductionRandom, Vector<long long>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(IntervalExchangeTransformationInductionRandom, Vector<mpq_class>)->Apply(RandomSurfaces);
+
+}  // namespace flatsurf::benchmark
@@ -0,0 +1,48 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_BENCHMARK_RANDOM_SURFACES_HPP
+#define LIBFLATSURF_BENCHMARK_RANDOM_SURFACES_HPP
+
+#include <benchmark/benchmark.h>
+
+#include "../test/random_surfaces.hpp"
+
+namespace flatsurf::benchmark {
+
+// Run a benchmark on random surfaces of all kinds with 10 to 10⁴ edges. Use
+// as BENCHMARK(…)->Apply(RandomSurfaces) and create the surface with
+// makeRandomSurface(state).
+inline void RandomSurfaces(::benchmark::internal::Benchmark* benchmark) {
+  for (const auto kind : {test::RANDOM_SURFACE::ORIGAMI, test::RANDOM_SURFACE::POLYGON, test::RANDOM_SURFACE::COVER})
+    for (int edges = 10; edges <= 10000; edges *= 10)
+      benchmark->Args({edges, static_cast<int>(kind)});
+  benchmark->ArgNames({"edges", "kind"});
+}
+
+// Return the random surface selected by the arguments registered with
+// RandomSurfaces().
+template <typename R2>
+auto makeRandomSurface(const ::benchmark::State& state) {
+  return test::makeRandomSurface<R2>(static_cast<test::RANDOM_SURFACE>(state.range(1)), static_cast<int>(state.range(0)));
+}
+
+}  // namespace flatsurf::benchmark
+
+#endif
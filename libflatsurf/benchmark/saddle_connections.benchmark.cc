@@ -33,6 +33,7 @@
 #include "../flatsurf/saddle_connections_iterator.hpp"
 #include "../flatsurf/vector.hpp"
 #include "../test/surfaces.hpp"
+#include "random_surfaces.hpp"
 
 using benchmark::DoNotOptimize;
 using benchmark::State;
@@ -136,4 +137,21 @@ void SaddleConnectionsLWithSlit(State& state) {
 BENCHMARK_TEMPLATE(SaddleConnectionsLWithSlit, Vector<mpq_class>)->Range(1, 64);
 BENCHMARK_TEMPLATE(SaddleConnectionsLWithSlit, Vector<eantic::renf_elem_class>)->Range(1, 64);
 
+// Benchmark how long it takes to enumerate all short saddle connections in a
+// random surface, i.e., how the enumeration scales with the number of
+// vertices and edges.
+template <typename R2>
+void SaddleConnectionsRandom(State& state) {
+  const auto surface = makeRandomSurface<R2>(state);
+  const auto bound = Bound(2, 0);
+
+  for (auto _ : state) {
+    const auto connections = SaddleConnections<FlatTriangulation<typename R2::Coordinate>>(*surface).bound(bound);
+    DoNotOptimize(std::distance(begin(connections), end(connections)));
+  }
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsRandom, Vector<long long>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(SaddleConnectionsRandom, Vector<mpq_class>)->Apply(RandomSurfaces);
+BENCHMARK_TEMPLATE(SaddleConnectionsRandom, Vector<eantic::renf_elem_class>)->Apply(RandomSurfaces);
+
 }  // namespace flatsurf::benchmark
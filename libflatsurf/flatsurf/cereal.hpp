@@ -21,10 +21,14 @@
 #ifndef LIBFLATSURF_CEREAL_HPP
 #define LIBFLATSURF_CEREAL_HPP
 
+#include <e-antic/renfxx.h>
 #include <e-antic/renfxx_cereal.h>
 #include <fmt/format.h>
 #include <fmt/ostream.h>
+#include <gmpxx.h>
 
+#include <boost/intrusive_ptr.hpp>
+#include <cereal/details/traits.hpp>
 #include <cereal/types/memory.hpp>
 #include <cereal/types/unordered_map.hpp>
 #include <cereal/types/utility.hpp>
@@ -33,6 +37,7 @@
 
 #include "bound.hpp"
 #include "chain.hpp"
+#include "chain_iterator.hpp"
 #include "edge.hpp"
 #include "flat_triangulation.hpp"
 #include "flat_triangulation_combinatorial.hpp"
@@ -50,6 +55,52 @@ namespace flatsurf {
 
 namespace {
 
+// Whether Archive is a binary archive such as cereal's BinaryOutputArchive or
+// PortableBinaryOutputArchive. For such archives we write a compact
+// representation of numbers, permutations, and chains since text archives
+// spend most of their loading time parsing decimal strings.
+template <typename Archive>
+constexpr bool isBinaryArchive = !cereal::traits::is_text_archive<Archive>::value;
+
+// Serialize an integer to a binary archive as its signed number of 64 bit
+// words followed by the words of its absolute value, least significant word
+// first and each word in little endian byte order. This does not depend on
+// the size of GMP's mp_limb_t or on the byte order of the platform, so such
+// archives can be read on any platform.
+template <typename Archive>
+void saveLimbs(Archive& archive, const mpz_class& value) {
+  const int sign = mpz_sgn(value.get_mpz_t());
+  if (sign == 0) {
+    archive(int64_t{0});
+    return;
+  }
+
+  std::vector<unsigned char> words(8 * ((mpz_sizeinbase(value.get_mpz_t(), 2) + 63) / 64));
+  size_t count;
+  mpz_export(words.data(), &count, -1, 8, -1, 0, value.get_mpz_t());
+  words.resize(8 * count);
+
+  archive(sign * static_cast<int64_t>(count));
+  archive(cereal::binary_data(words.data(), words.size()));
+}
+
+// Deserialize an integer written with saveLimbs().
+template <typename Archive>
+void loadLimbs(Archive& archive, mpz_class& value) {
+  int64_t size;
+  archive(size);
+  if (size == 0) {
+    value = 0;
+    return;
+  }
+
+  std::vector<unsigned char> words(8 * static_cast<size_t>(std::abs(size)));
+  archive(cereal::binary_data(words.data(), words.size()));
+  mpz_import(value.get_mpz_t(), std::abs(size), -1, 8, -1, 0, words.data());
+  if (size < 0)
+    mpz_neg(value.get_mpz_t(), value.get_mpz_t());
+}
+
 // Defines serialization for a type T without polluting the global namespace,
 // i.e., other libraries might still decide to serialize this type differently.
 // This is used for types such as mpz_class which do not provide an official
@@ -79,14 +130,71 @@ struct ReplacementSerialization {
 
   template <typename Archive>
   static void save(Archive& archive, const std::string key, const T& value) {
-    archive(cereal::make_nvp(key, serializable(value)));
+    if constexpr (isBinaryArchive<Archive>) {
+      saveBinary(archive, value);
+    } else {
+      archive(cereal::make_nvp(key, serializable(value)));
+    }
   }
 
   template <typename Archive>
   static void load(Archive& archive, const std::string key, T& value) {
-    decltype(serializable(std::declval<T>())) s;
-    archive(cereal::make_nvp(key, s));
-    value = deserializable(s);
+    if constexpr (isBinaryArchive<Archive>) {
+      loadBinary(archive, value);
+    } else {
+      decltype(serializable(std::declval<T>())) s;
+      archive(cereal::make_nvp(key, s));
+      value = deserializable(s);
+    }
+  }
+
+  // Write value to a binary archive without going through its decimal
+  // representation.
+  template <typename Archive>
+  static void saveBinary(Archive& archive, const T& value) {
+    if constexpr (std::is_same_v<T, mpz_class>) {
+      saveLimbs(archive, value);
+    } else if constexpr (std::is_same_v<T, mpq_class>) {
+      saveLimbs(archive, value.get_num());
+      saveLimbs(archive, value.get_den());
+    } else if constexpr (std::is_same_v<T, eantic::renf_elem_class>) {
+      // The number field is shared between all elements, so it is only
+      // written once per archive; the element itself is written as the
+      // coefficients of its numerator and its denominator.
+      archive(boost::intrusive_ptr<const eantic::renf_class>(&value.parent()));
+      const auto coefficients = value.num_vector();
+      archive(static_cast<uint64_t>(coefficients.size()));
+      for (const auto& coefficient : coefficients)
+        saveLimbs(archive, coefficient);
+      saveLimbs(archive, value.den());
+    } else {
+      archive(value);
+    }
+  }
+
+  // Read value from a binary archive written with saveBinary().
+  template <typename Archive>
+  static void loadBinary(Archive& archive, T& value) {
+    if constexpr (std::is_same_v<T, mpz_class>) {
+      loadLimbs(archive, value);
+    } else if constexpr (std::is_same_v<T, mpq_class>) {
+      loadLimbs(archive, value.get_num());
+      loadLimbs(archive, value.get_den());
+      value.canonicalize();
+    } else if constexpr (std::is_same_v<T, eantic::renf_elem_class>) {
+      boost::intrusive_ptr<const eantic::renf_class> parent;
+      archive(parent);
+      uint64_t degree;
+      archive(degree);
+      std::vector<mpz_class> coefficients(degree);
+      for (auto& coefficient : coefficients)
+        loadLimbs(archive, coefficient);
+      mpz_class denominator;
+      loadLimbs(archive, denominator);
+      value = eantic::renf_elem_class(*parent, coefficients) / denominator;
+    } else {
+      archive(value);
+    }
   }
 };
 
@@ -129,17 +237,42 @@ void Bound::load(Archive& archive) {
 }
 
 // Serialize a permutation to an archive.
+// Text archives store the permutation as its cycles. Binary archives store
+// the flat array of images, i.e., the image of the element with index i at
+// position i.
 template <typename Archive, typename T>
 void save(Archive& archive, const Permutation<T>& self) {
-  archive(cereal::make_nvp("cycles", self.cycles()));
+  if constexpr (isBinaryArchive<Archive>) {
+    archive(cereal::make_nvp("images", self.domain()));
+  } else {
+    archive(cereal::make_nvp("cycles", self.cycles()));
+  }
 }
 
 // Deserialize a permutation from an archive.
 template <typename Archive, typename T>
 void load(Archive& archive, Permutation<T>& self) {
-  std::vector<std::vector<T>> cycles;
-  archive(cereal::make_nvp("cycles", cycles));
-  self = Permutation(cycles);
+  if constexpr (isBinaryArchive<Archive>) {
+    std::vector<T> images;
+    archive(cereal::make_nvp("images", images));
+
+    // The images are the elements of the domain, so we can recover the
+    // preimage of the ith image by looking up the element with index i.
+    std::vector<T> preimages(images.size());
+    for (const auto& image : images)
+      preimages.at(image.index()) = image;
+
+    std::vector<std::pair<T, T>> permutation;
+    permutation.reserve(images.size());
+    for (size_t i = 0; i < images.size(); i++)
+      permutation.push_back(std::pair(preimages[i], images[i]));
+
+    self = Permutation(permutation);
+  } else {
+    std::vector<std::vector<T>> cycles;
+    archive(cereal::make_nvp("cycles", cycles));
+    self = Permutation(cycles);
+  }
 }
 
 // Serialize a vector to an archive.
@@ -250,21 +383,42 @@ struct Serialization<FlatTriangulation<T>> {
   void save(Archive& archive, const FlatTriangulation<T>& self) {
     archive(cereal::make_nvp("combinatorial", static_cast<const FlatTriangulationCombinatorial&>(self)));
 
-    std::unordered_map<HalfEdge, Vector<T>> vectors;
-    for (auto& edge : self.halfEdges())
-      vectors[edge] = self.fromHalfEdge(edge);
+    if constexpr (isBinaryArchive<Archive>) {
+      // Binary archives only store the vectors of the positive half edges,
+      // ordered by the index of their edge.
+      std::vector<Vector<T>> vectors(self.edges().size());
+      for (auto& edge : self.edges())
+        vectors[edge.index()] = self.fromHalfEdge(edge.positive());
 
-    archive(cereal::make_nvp("vectors", vectors));
+      archive(cereal::make_nvp("vectors", vectors));
+    } else {
+      std::unordered_map<HalfEdge, Vector<T>> vectors;
+      for (auto& edge : self.halfEdges())
+        vectors[edge] = self.fromHalfEdge(edge);
+
+      archive(cereal::make_nvp("vectors", vectors));
+    }
   }
 
   template <typename Archive>
   void load(Archive& archive, FlatTriangulation<T>& self) {
     FlatTriangulationCombinatorial combinatorial;
     archive(cereal::make_nvp("combinatorial", combinatorial));
-    std::unordered_map<HalfEdge, Vector<T>> map;
-    archive(cereal::make_nvp("vectors", map));
 
-    self = FlatTriangulation<T>(std::move(std::move(combinatorial)), [&](HalfEdge e) { return map.at(e); });
+    if constexpr (isBinaryArchive<Archive>) {
+      std::vector<Vector<T>> vectors;
+      archive(cereal::make_nvp("vectors", vectors));
+
+      self = FlatTriangulation<T>(std::move(combinatorial), [&](HalfEdge e) {
+        const auto& v = vectors.at(e.edge().index());
+        return e == e.edge().positive() ? v : -v;
+      });
+    } else {
+      std::unordered_map<HalfEdge, Vector<T>> map;
+      archive(cereal::make_nvp("vectors", map));
+
+      self = FlatTriangulation<T>(std::move(std::move(combinatorial)), [&](HalfEdge e) { return map.at(e); });
+    }
   }
 };
 
@@ -275,22 +429,47 @@ struct Serialization<Chain<Surface>> {
   void save(Archive& archive, const Chain<Surface>& self) {
     archive(cereal::make_nvp("surface", self.surface()));
 
-    std::vector<std::string> coefficients;
-    for (auto edge : self.surface().edges())
-      coefficients.push_back(fmt::format("{}", self[edge]));
-    archive(cereal::make_nvp("coefficients", coefficients));
+    if constexpr (isBinaryArchive<Archive>) {
+      // Binary archives only store the non-zero coefficients as a sequence
+      // of (edge, coefficient) pairs.
+      const uint64_t nonzero = std::distance(self.begin(), self.end());
+      archive(nonzero);
+      for (const auto& [edge, coefficient] : self) {
+        archive(edge);
+        saveLimbs(archive, *coefficient);
+      }
+    } else {
+      std::vector<std::string> coefficients;
+      for (auto edge : self.surface().edges())
+        coefficients.push_back(fmt::format("{}", self[edge]));
+      archive(cereal::make_nvp("coefficients", coefficients));
+    }
   }
 
   template <typename Archive>
   void load(Archive& archive, Chain<Surface>& self) {
     Surface surface;
     archive(cereal::make_nvp("surface", surface));
-    std::vector<std::string> coefficients;
-    archive(cereal::make_nvp("coefficients", coefficients));
 
     self = Chain(surface);
-    for (size_t i = 0; i < coefficients.size(); i++)
-      self += ((Chain<Surface>(surface) += surface.edges()[i].positive()) *= mpz_class(coefficients[i]));
+
+    if constexpr (isBinaryArchive<Archive>) {
+      uint64_t nonzero;
+      archive(nonzero);
+      for (uint64_t i = 0; i < nonzero; i++) {
+        Edge edge;
+        archive(edge);
+        mpz_class coefficient;
+        loadLimbs(archive, coefficient);
+        self += ((Chain<Surface>(surface) += edge.positive()) *= coefficient);
+      }
+    } else {
+      std::vector<std::string> coefficients;
+      archive(cereal::make_nvp("coefficients", coefficients));
+
+      for (size_t i = 0; i < coefficients.size(); i++)
+        self += ((Chain<Surface>(surface) += surface.edges()[i].positive()) *= mpz_class(coefficients[i]));
+    }
   }
 };
 
@@ -28,6 +28,7 @@
 
 #include "chain_iterator.hpp"
 #include "copyable.hpp"
+#include "memory_usage.hpp"
 #include "serializable.hpp"
 
 namespace flatsurf {
@@ -83,6 +84,10 @@ class Chain : public Serializable<Chain<Surface>>,
   // Return a reference to the surface where this chain is defined.
   const Surface& surface() const;
 
+  // Return an estimate of the memory held by this chain, i.e., by its
+  // coefficients and the vectors it caches.
+  MemoryUsage memoryUsage() const;
+
   template <typename S>
   friend std::ostream& operator<<(std::ostream&, const Chain<S>&);
 
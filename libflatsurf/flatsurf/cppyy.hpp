@@ -21,6 +21,9 @@
 #define LIBFLATSURF_CPPYY_HPP
 
 #include <iosfwd>
+#include <mutex>
+#include <type_traits>
+#include <vector>
 
 #include "flatsurf.hpp"
 
@@ -75,6 +78,109 @@ std::optional<Deformation<FlatTriangulation<T>>> isomorphism(const FlatTriangula
       filter_map);
 }
 
+// Determine an isomorphism whose matrix is checked by a predefined filter in
+// C++, i.e., without calling back into Python for every candidate.
+template <typename T>
+std::optional<Deformation<FlatTriangulation<T>>> isomorphism(const FlatTriangulation<T> &preimage, const FlatTriangulation<T> &image, ISOMORPHISM kind, ISOMORPHISM_FILTER filter) {
+  return preimage.isomorphism(image, kind, filter);
+}
+
+// Determine an isomorphism whose matrix is one of the given matrices without
+// calling back into Python for every candidate.
+template <typename T>
+std::optional<Deformation<FlatTriangulation<T>>> isomorphism(const FlatTriangulation<T> &preimage, const FlatTriangulation<T> &image, ISOMORPHISM kind, const std::vector<IsomorphismFilterMatrix<T>> &filter_matrices) {
+  std::vector<std::tuple<T, T, T, T>> matrices;
+  for (const auto &matrix : filter_matrices)
+    matrices.emplace_back(matrix.a, matrix.b, matrix.c, matrix.d);
+  return preimage.isomorphism(image, kind, matrices);
+}
+
+// Entry points for long running computations that pyflatsurf calls without
+// holding the GIL if their coordinates are threadsafe(), so that several
+// Python threads can run them concurrently. These functions must not call
+// back into Python.
+namespace concurrent {
+
+// The coordinate type of T, i.e., T itself or T::Coordinate if T is a surface.
+template <typename T, typename = void>
+struct CoordinateOf {
+  using type = T;
+};
+
+template <typename T>
+struct CoordinateOf<T, std::void_t<typename T::Coordinate>> {
+  using type = typename T::Coordinate;
+};
+
+// Return whether computations with coordinates T (or on surfaces of type T)
+// can run while other threads use the same coordinate type. Number fields
+// refine their (shared) embeddings and exact-real elements cache
+// approximations in shared state, so any arithmetic with such coordinates,
+// even on distinct surfaces, must not run concurrently. pyflatsurf keeps the
+// GIL for these, since Python threads do arithmetic with them all the time.
+template <typename T>
+constexpr bool threadsafe() {
+  using C = typename CoordinateOf<T>::type;
+  return std::is_same_v<C, long long> || std::is_same_v<C, mpz_class> || std::is_same_v<C, mpq_class>;
+}
+
+// Serializes the calls of the entry points below for coordinates T that are
+// not threadsafe(). There is a single such lock per coordinate type.
+template <typename T>
+inline std::mutex serialized;
+
+// Run task, serialized with other entry points using coordinates T unless
+// these coordinates are threadsafe().
+template <typename T, typename F>
+auto run(F &&task) {
+  if constexpr (threadsafe<T>()) {
+    return task();
+  } else {
+    std::lock_guard<std::mutex> lock(serialized<T>);
+    return task();
+  }
+}
+
+template <typename Surface>
+bool decompose(FlowDecomposition<Surface> &decomposition, int limit = -1) {
+  return run<typename Surface::Coordinate>([&]() { return decomposition.decompose(FlowDecomposition<Surface>::defaultTarget, limit); });
+}
+
+template <typename T>
+void delaunay(FlatTriangulation<T> &surface) {
+  run<T>([&]() { surface.delaunay(); });
+}
+
+// Return all the saddle connections of a range which must be bounded.
+template <typename Surface>
+std::vector<SaddleConnection<Surface>> connections(const SaddleConnections<Surface> &connections) {
+  if (!connections.bound())
+    throw std::invalid_argument("saddle connections must be bounded to be collected");
+  return run<typename Surface::Coordinate>([&]() { return std::vector<SaddleConnection<Surface>>(connections.begin(), connections.end()); });
+}
+
+template <typename Surface>
+SaddleConnectionsExport<Surface> exportConnections(const SaddleConnections<Surface> &connections, bool chains) {
+  return run<typename Surface::Coordinate>([&]() { return SaddleConnectionsExport<Surface>(connections, chains); });
+}
+
+template <typename Surface>
+SaddleConnectionsExport<Surface> exportConnections(const SaddleConnectionsByLength<Surface> &connections, bool chains) {
+  return run<typename Surface::Coordinate>([&]() { return SaddleConnectionsExport<Surface>(connections, chains); });
+}
+
+template <typename T>
+std::optional<Deformation<FlatTriangulation<T>>> isomorphism(const FlatTriangulation<T> &preimage, const FlatTriangulation<T> &image, ISOMORPHISM kind, ISOMORPHISM_FILTER filter) {
+  return run<T>([&]() { return ::flatsurf::isomorphism(preimage, image, kind, filter); });
+}
+
+template <typename T>
+std::optional<Deformation<FlatTriangulation<T>>> isomorphism(const FlatTriangulation<T> &preimage, const FlatTriangulation<T> &image, ISOMORPHISM kind, const std::vector<IsomorphismFilterMatrix<T>> &filter_matrices) {
+  return run<T>([&]() { return ::flatsurf::isomorphism(preimage, image, kind, filter_matrices); });
+}
+
+}  // namespace concurrent
+
 }  // namespace flatsurf
 
 #endif
@@ -26,17 +26,30 @@
 #include <exact-real/forward.hpp>
 #include <functional>
 #include <iosfwd>
+#include <tuple>
 #include <vector>
 
 #include "flat_triangulation_combinatorial.hpp"
 #include "half_edge.hpp"
+#include "isomorphism.hpp"
 #include "managed_movable.hpp"
+#include "memory_usage.hpp"
 #include "serializable.hpp"
 
 namespace flatsurf {
 
 // A triangulated translation surface. For most purposes this is the central
 // object of the flatsurf library.
+//
+// Concurrency: Once no thread modifies a surface anymore, i.e., nobody calls
+// non-const methods such as flip() or delaunay() on it, the surface is frozen
+// and any number of threads can query it and the objects derived from it
+// (its saddle connections and their chains, Vertical, …) through const
+// methods at the same time. The caches that these objects fill lazily are
+// thread-safe. This only holds for coordinates that are themselves
+// thread-safe, namely long long, mpz_class, and mpq_class. Number field
+// elements and exact reals share mutable state with other elements and must
+// only be used from one thread at a time.
 template <class T>
 class FlatTriangulation : public FlatTriangulationCombinatorics<FlatTriangulation<T>>,
                           Serializable<FlatTriangulation<T>>,
@@ -103,6 +116,33 @@ class FlatTriangulation : public FlatTriangulationCombinatorics<FlatTriangulatio
       std::function<bool(const T &, const T &, const T &, const T &)> = [](const T &a, const T &b, const T &c, const T &d) { return a == 1 && b == 0 && c == 0 && d == 1; },
       std::function<bool(HalfEdge, HalfEdge)> = [](HalfEdge, HalfEdge) { return true; }) const;
 
+  // Return an isomorphism to the given surface whose matrix is accepted by
+  // the predefined filter.
+  std::optional<Deformation<FlatTriangulation<T>>> isomorphism(const FlatTriangulation &, ISOMORPHISM kind, ISOMORPHISM_FILTER) const;
+
+  // Return an isomorphism to the given surface whose matrix (a b c d) is one
+  // of the given matrices.
+  std::optional<Deformation<FlatTriangulation<T>>> isomorphism(const FlatTriangulation &, ISOMORPHISM kind, const std::vector<std::tuple<T, T, T, T>> &matrices) const;
+
+  // Return a relabelling of this surface to a canonical representative of
+  // its isomorphism class, i.e., two surfaces are isomorphic by an
+  // isomorphism of the given kind which does not change the vectors of the
+  // half edges (the default for isomorphism()) iff their canonical surfaces
+  // are equal.
+  // For DELAUNAY_CELLS, the surface must be Delaunay triangulated and the
+  // Delaunay cells are retriangulated canonically.
+  // Currently, only the IDENTITY filter is supported, i.e., surfaces that
+  // are only isomorphic up to a rotation or another non-trivial linear map
+  // have different canonical surfaces. Other filters throw a
+  // std::logic_error.
+  Deformation<FlatTriangulation<T>> canonical(ISOMORPHISM kind, ISOMORPHISM_FILTER filter = ISOMORPHISM_FILTER::IDENTITY) const;
+
+  // Return a hash of this surface that is invariant under the isomorphisms
+  // considered by canonical(kind, filter), i.e., surfaces with equal
+  // canonical surfaces have the same hash. As for canonical(), only the
+  // IDENTITY filter is supported.
+  size_t hash(ISOMORPHISM kind, ISOMORPHISM_FILTER filter = ISOMORPHISM_FILTER::IDENTITY) const;
+
   Vector<T> shortest() const;
 
   // Return the shortest vector relative to this direction which is not orthogonal to it.
@@ -127,6 +167,11 @@ class FlatTriangulation : public FlatTriangulationCombinatorics<FlatTriangulatio
 
   const ::flatsurf::Vector<exactreal::Arb> &fromHalfEdgeApproximate(HalfEdge) const;
 
+  // Return an estimate of the memory held by this surface, its cached
+  // approximations, and the caches of the Verticals on this surface that
+  // are alive on the calling thread.
+  MemoryUsage memoryUsage() const;
+
   bool operator==(const FlatTriangulation<T> &) const;
 
   template <typename W>
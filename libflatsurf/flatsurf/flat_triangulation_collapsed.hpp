@@ -25,6 +25,7 @@
 
 #include "flat_triangulation_combinatorics.hpp"
 #include "managed_movable.hpp"
+#include "memory_usage.hpp"
 #include "serializable.hpp"
 
 namespace flatsurf {
@@ -73,6 +74,11 @@ class FlatTriangulationCollapsed : public FlatTriangulationCombinatorics<FlatTri
   // Return the collapsed saddle connections to turn from one half edge clockwise to the other.
   Path<FlatTriangulation<T>> turn(HalfEdge, HalfEdge) const;
 
+  // Return an estimate of the memory held by this surface and the saddle
+  // connections that describe its half edges. The uncollapsed surface is
+  // not included.
+  MemoryUsage memoryUsage() const;
+
   // Return whether two collapsed surfaces are equivalent, i.e., they were
   // constructed from equal surfaces that have been collapsed with respect to a
   // parallel vertical direction.
@@ -0,0 +1,73 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_FLAT_TRIANGULATION_LIBRARY_HPP
+#define LIBFLATSURF_FLAT_TRIANGULATION_LIBRARY_HPP
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "copyable.hpp"
+
+namespace flatsurf {
+
+// A read-only collection of flat triangulations stored in a file which is
+// mapped into memory.
+// Opening a library only validates the header of the file and the positions
+// of its records. The record of a surface is validated when a
+// FlatTriangulationView of it is created; its coordinates are decoded lazily
+// when they are queried. Since the file is mapped read-only,
+// processes that open the same library share its pages in the page cache.
+// The file uses the native byte order, so a library can only be opened on a
+// platform with the same endianness as the one that wrote it.
+// Libraries are only implemented for long long, mpz_class, mpq_class, and
+// eantic::renf_elem_class coordinates.
+template <typename T>
+class FlatTriangulationLibrary {
+ public:
+  // Open the library stored at path.
+  explicit FlatTriangulationLibrary(const std::string& path);
+
+  // Write surfaces as a new library to path.
+  // For number field coordinates, all surfaces must be defined over the same
+  // number field, which is only stored once in the header of the file.
+  static void write(const std::string& path, const std::vector<FlatTriangulation<T>>& surfaces);
+
+  // Return the number of surfaces in this library.
+  size_t size() const;
+
+  // Return a read-only view of the surface at this position in the library.
+  // This checks that the record of the surface is well-formed, which takes
+  // time linear in its size, but does not decode any coordinates yet.
+  // Throws std::invalid_argument if the record is corrupt.
+  FlatTriangulationView<T> operator[](size_t) const;
+
+  template <typename S>
+  friend std::ostream& operator<<(std::ostream&, const FlatTriangulationLibrary<S>&);
+
+ private:
+  Copyable<FlatTriangulationLibrary> self;
+
+  friend ImplementationOf<FlatTriangulationLibrary>;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,65 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_FLAT_TRIANGULATION_VIEW_HPP
+#define LIBFLATSURF_FLAT_TRIANGULATION_VIEW_HPP
+
+#include <iosfwd>
+#include <vector>
+
+#include "copyable.hpp"
+
+namespace flatsurf {
+
+// A read-only flat triangulation in a FlatTriangulationLibrary.
+// The view reads the combinatorics and coordinates directly from the memory
+// mapped file. Only the coordinates that are queried are decoded, in
+// particular no Vector is created for half edges that are never queried.
+template <typename T>
+class FlatTriangulationView {
+  template <typename... Args>
+  FlatTriangulationView(PrivateConstructor, Args&&...);
+
+ public:
+  // Return the half edges of this surface, in the same order as
+  // FlatTriangulation::halfEdges() on the decoded surface.
+  std::vector<HalfEdge> halfEdges() const;
+
+  HalfEdge nextAtVertex(HalfEdge) const;
+  HalfEdge nextInFace(HalfEdge) const;
+
+  // Return the vector of this half edge, decoded from the library.
+  Vector<T> fromHalfEdge(HalfEdge) const;
+
+  // Return the surface described by this view. This decodes all the
+  // coordinates of the surface.
+  FlatTriangulation<T> surface() const;
+
+  template <typename S>
+  friend std::ostream& operator<<(std::ostream&, const FlatTriangulationView<S>&);
+
+ private:
+  Copyable<FlatTriangulationView> self;
+
+  friend ImplementationOf<FlatTriangulationView>;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -43,6 +43,8 @@
 #include "flat_triangulation_collapsed.hpp"
 #include "flat_triangulation_combinatorial.hpp"
 #include "flat_triangulation_combinatorics.hpp"
+#include "flat_triangulation_library.hpp"
+#include "flat_triangulation_view.hpp"
 #include "flow_component.hpp"
 #include "flow_connection.hpp"
 #include "flow_decomposition.hpp"
@@ -57,9 +59,11 @@
 #include "isomorphism.hpp"
 #include "local.hpp"
 #include "managed_movable.hpp"
+#include "memory_usage.hpp"
 #include "movable.hpp"
 #include "odd_half_edge_map.hpp"
 #include "orientation.hpp"
+#include "parallelism.hpp"
 #include "path.hpp"
 #include "path_iterator.hpp"
 #include "permutation.hpp"
@@ -67,10 +71,15 @@
 #include "saddle_connections.hpp"
 #include "saddle_connections_by_length.hpp"
 #include "saddle_connections_by_length_iterator.hpp"
+#include "saddle_connections_export.hpp"
 #include "saddle_connections_iterator.hpp"
+#include "saddle_connections_reader.hpp"
 #include "saddle_connections_sample.hpp"
 #include "saddle_connections_sample_iterator.hpp"
+#include "saddle_connections_writer.hpp"
 #include "serializable.hpp"
+#include "statistics.hpp"
+#include "tracing.hpp"
 #include "tracked.hpp"
 #include "vector.hpp"
 #include "vertex.hpp"
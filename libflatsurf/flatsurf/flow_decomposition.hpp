@@ -25,6 +25,7 @@
 #include <iosfwd>
 #include <vector>
 
+#include "memory_usage.hpp"
 #include "movable.hpp"
 
 namespace flatsurf {
@@ -74,6 +75,10 @@ class FlowDecomposition {
   //   unknown: otherwise
   boost::logic::tribool parabolic() const;
 
+  // Return an estimate of the memory held by this decomposition, including
+  // the surface it was created from and its collapsed version.
+  MemoryUsage memoryUsage() const;
+
   template <typename S>
   friend std::ostream& operator<<(std::ostream&, const FlowDecomposition<S>&);
 
@@ -75,6 +75,12 @@ class FlatTriangulationCombinatorics;
 template <typename T>
 class FlatTriangulationCollapsed;
 
+template <typename T>
+class FlatTriangulationLibrary;
+
+template <typename T>
+class FlatTriangulationView;
+
 template <typename Surface>
 class FlowComponent;
 
@@ -104,12 +110,16 @@ class IntervalExchangeTransformation;
 
 enum class ISOMORPHISM;
 
+enum class ISOMORPHISM_FILTER;
+
 template <typename T>
 class ManagedMovable;
 
 template <typename Surface>
 class MaybeVerticalFlowConnection;
 
+struct MemoryUsage;
+
 template <typename T>
 class OddHalfEdgeMap;
 
@@ -140,21 +150,34 @@ class SaddleConnectionsByLength;
 template <typename Surface>
 class SaddleConnectionsByLengthIterator;
 
+template <typename Surface>
+class SaddleConnectionsExport;
+
 template <typename Surface>
 class SaddleConnectionsIterator;
 
+template <typename Surface>
+class SaddleConnectionsReader;
+
 template <typename Surface>
 class SaddleConnectionsSample;
 
 template <typename Surface>
 class SaddleConnectionsSampleIterator;
 
+template <typename Surface>
+class SaddleConnectionsWriter;
+
 template <typename T>
 class Serializable;
 
 template <typename T>
 struct Serialization;
 
+struct Statistics;
+
+struct Tracing;
+
 template <typename T>
 class Vector;
 
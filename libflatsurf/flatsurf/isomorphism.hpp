@@ -36,6 +36,21 @@ enum class ISOMORPHISM {
   DELAUNAY_CELLS = 1,
 };
 
+// Predefined filters for the linear part of an isomorphism, see
+// FlatTriangulation::isomorphism(). Other than an arbitrary filter function,
+// these can be evaluated without calling back into a (Python) callable for
+// every candidate.
+enum class ISOMORPHISM_FILTER {
+  // Only the identity matrix, i.e., isomorphisms that are translations.
+  IDENTITY = 0,
+  // Matrices with determinant ±1.
+  UNIMODULAR = 1,
+  // Orthogonal matrices, i.e., rotations and reflections.
+  ORTHOGONAL = 2,
+  // Matrices in SL(2, Z).
+  SL2Z = 3,
+};
+
 }  // namespace flatsurf
 
 #endif
@@ -0,0 +1,82 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_MEMORY_USAGE_HPP
+#define LIBFLATSURF_MEMORY_USAGE_HPP
+
+#include <boost/operators.hpp>
+#include <cstddef>
+#include <iosfwd>
+
+#include "forward.hpp"
+
+namespace flatsurf {
+
+// An estimate of the memory held by a surface or a decomposition, in bytes,
+// broken down by the kind of structure that holds it.
+// The estimate includes the limbs of GMP integers and the heap storage of
+// e-antic elements and Arb balls. It does not include the overhead of the
+// memory allocator. Structures that are shared between several objects, such
+// as the caches of a Vertical, are counted once for every object that refers
+// to them.
+// Such an estimate must not be computed while the structures it walks are
+// being modified.
+struct MemoryUsage : boost::equality_comparable<MemoryUsage>,
+                     boost::additive<MemoryUsage> {
+  // The combinatorics of a FlatTriangulation and the vectors of its edges.
+  size_t surface = 0;
+
+  // The approximations of the vectors of the edges that a
+  // FlatTriangulation caches.
+  size_t approximations = 0;
+
+  // The caches of the Vertical directions on a FlatTriangulation that are
+  // alive on the calling thread, i.e., projections, orientations, and
+  // largeness of edges.
+  size_t vertical = 0;
+
+  // The combinatorics of a FlatTriangulationCollapsed, the collapsed
+  // vertical connections and the vectors of its half edges (not counting
+  // the saddle connections and chains that make up these vectors.)
+  size_t collapsed = 0;
+
+  // The bookkeeping of a FlowDecomposition, i.e., its components and
+  // the saddle connections known to its interval exchange transformations.
+  size_t decomposition = 0;
+
+  // The SaddleConnection objects themselves (not counting their chains.)
+  size_t connections = 0;
+
+  // The coefficients of Chain objects and the vectors they cache.
+  size_t chains = 0;
+
+  // Return the sum of all of the above.
+  size_t total() const;
+
+  bool operator==(const MemoryUsage&) const;
+
+  MemoryUsage& operator+=(const MemoryUsage&);
+  MemoryUsage& operator-=(const MemoryUsage&);
+
+  friend std::ostream& operator<<(std::ostream&, const MemoryUsage&);
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,43 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_PARALLELISM_HPP
+#define LIBFLATSURF_PARALLELISM_HPP
+
+namespace flatsurf {
+
+// Limits the number of threads that libflatsurf starts internally, e.g., to
+// build the components of a FlowDecomposition or to check the candidates of
+// FlatTriangulation::isomorphism() in parallel.
+// Callers that already run many computations in parallel, e.g., a pool of
+// threads that each decompose a surface, should set this to 1 to avoid
+// oversubscribing the machine.
+struct Parallelism {
+  // Return the maximum number of threads a single computation uses; this
+  // defaults to std::thread::hardware_concurrency().
+  static unsigned threads();
+
+  // Set the maximum number of threads a single computation uses in any
+  // thread of this process; 0 restores the default.
+  static void threads(unsigned);
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -30,6 +30,7 @@
 #include "bound.hpp"
 #include "copyable.hpp"
 #include "half_edge.hpp"
+#include "memory_usage.hpp"
 #include "serializable.hpp"
 
 namespace flatsurf {
@@ -81,6 +82,10 @@ class SaddleConnection : public Serializable<SaddleConnection<Surface>>,
 
   std::optional<int> angle(const SaddleConnection<Surface> &) const;
 
+  // Return an estimate of the memory held by this saddle connection and its
+  // chain.
+  MemoryUsage memoryUsage() const;
+
   SaddleConnection<Surface> operator-() const;
 
   bool operator==(const SaddleConnection<Surface> &) const;
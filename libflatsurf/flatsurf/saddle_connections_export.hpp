@@ -0,0 +1,88 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_EXPORT_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_EXPORT_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <type_traits>
+#include <vector>
+
+#include "copyable.hpp"
+
+namespace flatsurf {
+
+// The data of a range of saddle connections in contiguous buffers.
+// All the saddle connections are enumerated once when this object is
+// created. This is meant for consumers such as NumPy that want to work on
+// many saddle connections at once without creating an object for each of
+// them.
+template <typename Surface>
+class SaddleConnectionsExport {
+  static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
+
+ public:
+  // Export the saddle connections of this range. If chains is set, the
+  // (exact) chains of the saddle connections are exported as well.
+  explicit SaddleConnectionsExport(const SaddleConnections<Surface>&, bool chains = false);
+  explicit SaddleConnectionsExport(const SaddleConnectionsByLength<Surface>&, bool chains = false);
+
+  // Return the number of exported saddle connections.
+  size_t size() const;
+
+  // Return the number of edges of the underlying surface, i.e., the number of
+  // columns of chains().
+  size_t edges() const;
+
+  // Return double approximations of the holonomies of the saddle
+  // connections, as x and y coordinate of the first connection, x and y of
+  // the second connection, …
+  const std::vector<double>& holonomies() const;
+
+  // Return the ids of the source half edges of the saddle connections.
+  const std::vector<int32_t>& sources() const;
+
+  // Return the ids of the target half edges of the saddle connections.
+  const std::vector<int32_t>& targets() const;
+
+  // Return the coefficients of the chains of the saddle connections as a
+  // row-major size() × edges() matrix, i.e., the exact holonomy of the ith
+  // connection is the sum of chains()[i * edges() + j] times the vector of
+  // the jth edge. This is empty if chains have not been exported.
+  const std::vector<int64_t>& chains() const;
+
+  template <typename S>
+  friend std::ostream& operator<<(std::ostream&, const SaddleConnectionsExport<S>&);
+
+ private:
+  Copyable<SaddleConnectionsExport> self;
+
+  friend ImplementationOf<SaddleConnectionsExport>;
+};
+
+template <typename Surface, typename... Args>
+SaddleConnectionsExport(const SaddleConnections<Surface>&, Args&&...) -> SaddleConnectionsExport<Surface>;
+
+template <typename Surface, typename... Args>
+SaddleConnectionsExport(const SaddleConnectionsByLength<Surface>&, Args&&...) -> SaddleConnectionsExport<Surface>;
+
+}  // namespace flatsurf
+
+#endif
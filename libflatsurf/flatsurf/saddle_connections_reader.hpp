@@ -0,0 +1,80 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_READER_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_READER_HPP
+
+#include <iosfwd>
+#include <type_traits>
+
+#include "half_edge.hpp"
+#include "movable.hpp"
+
+namespace flatsurf {
+
+// Reads the records written by a SaddleConnectionsWriter back from a stream,
+// one record at a time, so that the full list of saddle connections never
+// needs to be held in memory.
+template <typename Surface>
+class SaddleConnectionsReader {
+  static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
+
+ public:
+  // Read records from the binary stream is. The records must have been
+  // written for saddle connections on this surface.
+  SaddleConnectionsReader(const Surface&, std::istream& is);
+
+  // Advance to the next record. Return whether there was such a record, i.e.,
+  // return false once the end of the stream has been reached.
+  bool next();
+
+  // Return the source half edge of the current record.
+  HalfEdge source() const;
+
+  // Return the target half edge of the current record.
+  HalfEdge target() const;
+
+  // Return a double approximation of the holonomy of the current record.
+  double x() const;
+  double y() const;
+
+  // Return whether the records contain the chains of the saddle connections.
+  bool chains() const;
+
+  // Return the saddle connection of the current record.
+  // This requires that the records contain the chains.
+  SaddleConnection<Surface> connection() const;
+
+  const Surface& surface() const;
+
+  template <typename S>
+  friend std::ostream& operator<<(std::ostream&, const SaddleConnectionsReader<S>&);
+
+ private:
+  Movable<SaddleConnectionsReader> self;
+
+  friend ImplementationOf<SaddleConnectionsReader>;
+};
+
+template <typename Surface>
+SaddleConnectionsReader(const Surface&, std::istream&) -> SaddleConnectionsReader<Surface>;
+
+}  // namespace flatsurf
+
+#endif
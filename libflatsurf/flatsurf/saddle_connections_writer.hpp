@@ -0,0 +1,74 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_WRITER_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_WRITER_HPP
+
+#include <iosfwd>
+#include <type_traits>
+
+#include "movable.hpp"
+
+namespace flatsurf {
+
+// A sink that writes saddle connections as compact binary records to a
+// stream, e.g., while enumerating saddle connections up to a large bound.
+// Each record consists of the source and target half edge, a double
+// approximation of the holonomy, and (optionally) the chain of the connection
+// as a sparse sequence of (edge, coefficient) pairs. Records are collected in
+// chunks which are written to the stream when they are full, either directly
+// or from a background thread. The surface itself is not written; use a
+// SaddleConnectionsReader to read the records back for a given surface.
+// Note that records are written in the native byte order.
+template <typename Surface>
+class SaddleConnectionsWriter {
+  static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
+
+ public:
+  // Create a sink that writes to the binary stream os. If chains is false,
+  // only the source, target, and approximate holonomy are written, and the
+  // records cannot be turned back into SaddleConnection objects. If
+  // background is set, chunks are written to os from a separate thread;
+  // os must then not be used otherwise until this writer is flushed.
+  explicit SaddleConnectionsWriter(std::ostream& os, bool chains = true, bool background = false);
+
+  SaddleConnectionsWriter& operator<<(const SaddleConnection<Surface>&);
+  SaddleConnectionsWriter& operator<<(const SaddleConnections<Surface>&);
+  SaddleConnectionsWriter& operator<<(const SaddleConnectionsByLength<Surface>&);
+
+  // Write all pending records to the stream and flush it.
+  // This is also done implicitly when the writer is destroyed; however,
+  // errors that occur then are lost.
+  void flush();
+
+  // Return the number of records that have been passed to this writer.
+  size_t size() const;
+
+  template <typename S>
+  friend std::ostream& operator<<(std::ostream&, const SaddleConnectionsWriter<S>&);
+
+ private:
+  Movable<SaddleConnectionsWriter> self;
+
+  friend ImplementationOf<SaddleConnectionsWriter>;
+};
+
+}  // namespace flatsurf
+
+#endif
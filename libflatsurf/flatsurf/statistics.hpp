@@ -0,0 +1,129 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_STATISTICS_HPP
+#define LIBFLATSURF_STATISTICS_HPP
+
+#include <array>
+#include <boost/operators.hpp>
+#include <iosfwd>
+
+#include "forward.hpp"
+
+namespace flatsurf {
+
+// Counters of the operations that typically dominate the runtime of
+// libflatsurf.
+// The counters are only maintained when libflatsurf has been configured with
+// --enable-statistics. Otherwise, counting compiles to nothing and all
+// counters remain zero.
+// Every thread counts separately. To attribute counts to a particular
+// computation, e.g., the decomposition of a single FlowComponent, take the
+// difference of thread() before and after that computation.
+struct Statistics : boost::equality_comparable<Statistics>,
+                    boost::additive<Statistics> {
+  // The predicates on Vector and Chain that are first attempted with ball
+  // arithmetic, namely Vector::ccw(), Vector::orientation(), comparisons of a
+  // Vector to a Bound, comparisons of the lengths of two vectors, and
+  // comparisons of a Chain to a Bound.
+  enum class PREDICATE {
+    CCW,
+    ORIENTATION,
+    BOUND,
+    LENGTH,
+    CHAIN_BOUND,
+  };
+
+  static constexpr size_t PREDICATES = static_cast<size_t>(PREDICATE::CHAIN_BOUND) + 1;
+
+  // The number of precisions at which such a predicate is attempted with
+  // ball arithmetic before falling back to exact arithmetic; we start at 64
+  // bits and double the precision with every attempt.
+  static constexpr size_t PRECISIONS = 3;
+
+  // The number of edge flips in any triangulation.
+  unsigned long long flips = 0;
+
+  // The number of edges collapsed in any triangulation.
+  unsigned long long collapses = 0;
+
+  // The number of times a Tracked object was notified about a change to its
+  // surface.
+  unsigned long long trackedNotifications = 0;
+
+  // The number of predicates on Vector and Chain, such as ccw() or
+  // comparisons to a Bound, that could be decided with ball arithmetic.
+  unsigned long long approximatePredicates = 0;
+
+  // The number of predicates on Vector and Chain that could not be decided
+  // with ball arithmetic at any of the precisions below and had to fall back
+  // to exact arithmetic.
+  unsigned long long exactPredicates = 0;
+
+  // The precisions at which the predicates above were decided, i.e.,
+  // precisions[p][i] is the number of predicates p that were decided with
+  // ball arithmetic at 64·2^i bits and precisions[p][PRECISIONS] is the
+  // number of predicates p that had to fall back to exact arithmetic.
+  std::array<std::array<unsigned long long, PRECISIONS + 1>, PREDICATES> precisions = {};
+
+  // The number of times the vector of a Chain had to be recomputed from its
+  // coefficients.
+  unsigned long long chainRecomputations = 0;
+
+  // The number of triangles visited during searches for saddle connections.
+  unsigned long long searchNodesVisited = 0;
+
+  // The number of triangles not visited during searches for saddle
+  // connections since they could not contain any connection in the search
+  // sector or in the search radius.
+  unsigned long long searchNodesPruned = 0;
+
+  // The number of calls to intervalxt to perform a decomposition step on a
+  // FlowComponent.
+  unsigned long long decompositionSteps = 0;
+
+  // The number of induction steps, i.e., subtractions of lengths, that
+  // intervalxt performed.
+  unsigned long long inductionSteps = 0;
+
+  // Return whether libflatsurf has been built with statistics enabled.
+  static bool enabled();
+
+  // Return the counters of the calling thread.
+  static Statistics thread();
+
+  // Return the sum of the counters of all threads, including threads that
+  // have terminated already.
+  static Statistics total();
+
+  // Reset the counters of all threads to zero. Counts that happen in other
+  // threads while resetting might be lost.
+  static void reset();
+
+  bool operator==(const Statistics&) const;
+
+  Statistics& operator+=(const Statistics&);
+  Statistics& operator-=(const Statistics&);
+
+  friend std::ostream& operator<<(std::ostream&, const Statistics&);
+};
+
+}  // namespace flatsurf
+
+#endif
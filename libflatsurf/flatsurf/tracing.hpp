@@ -0,0 +1,49 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_TRACING_HPP
+#define LIBFLATSURF_TRACING_HPP
+
+#include <string>
+
+#include "forward.hpp"
+
+namespace flatsurf {
+
+// Records the phases of expensive computations, such as the construction of
+// a FlowDecomposition, in a local file in the Chrome trace event format. Such
+// a file can be inspected with chrome://tracing or https://ui.perfetto.dev.
+// Tracing can also be enabled by setting the environment variable
+// LIBFLATSURF_TRACE to the path of the trace file. When tracing is off, the
+// phases are not timed at all.
+struct Tracing {
+  // Start writing trace events to the file at `path`, replacing its
+  // contents. A trace that is currently being written is finished first.
+  static void start(const std::string& path);
+
+  // Finish the trace that is currently being written, if any.
+  static void stop();
+
+  // Return whether trace events are currently being written.
+  static bool enabled();
+};
+
+}  // namespace flatsurf
+
+#endif
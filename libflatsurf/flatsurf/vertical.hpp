@@ -32,6 +32,9 @@
 namespace flatsurf {
 
 // A vertical direction on a translation surface.
+// The projections of half edges are cached lazily. These caches are
+// thread-safe, see FlatTriangulation for details. Verticals in the same
+// direction on the same surface share their caches.
 template <typename Surface>
 class Vertical : Serializable<Vertical<Surface>>,
                  boost::equality_comparable<Vertical<Surface>> {
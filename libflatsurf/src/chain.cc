@@ -25,14 +25,19 @@
 #include <fmt/ostream.h>
 #include <gmp.h>
 #include <gmpxx.h>
+#include <gmpxxll/mpz_class.hpp>
 
 #include "../flatsurf/bound.hpp"
 #include "../flatsurf/fmt.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
+#include "impl/approximation.hpp"
 #include "impl/chain.impl.hpp"
 #include "impl/chain_iterator.impl.hpp"
 #include "util/assert.ipp"
 #include "util/hash.ipp"
+#include "util/memory.ipp"
+#include "util/precision.ipp"
+#include "util/statistics.ipp"
 
 namespace flatsurf {
 
@@ -77,18 +82,38 @@ Chain<Surface>::operator bool() const {
 
 template <typename Surface>
 bool Chain<Surface>::operator<(const Bound rhs) const {
-  const auto approx = static_cast<const Vector<exactreal::Arb>&>(*this) < rhs;
+  const auto approx = decideAdaptively(Statistics::PREDICATE::CHAIN_BOUND, [&](slong prec) -> std::optional<bool> {
+    if (prec == exactreal::ARB_PRECISION_FAST)
+      return static_cast<const Vector<exactreal::Arb>&>(*this) < rhs;
+    if (!rhs)
+      return false;
+    return self->norm(prec) < rhs.squared();
+  });
   if (approx)
     return *approx;
-  return static_cast<const Vector<T>&>(*this) < rhs;
+
+  // We do not use the predicate on the exact vector since it would first
+  // try all the precisions again.
+  const Vector<T>& exact = *this;
+  return exact.x() * exact.x() + exact.y() * exact.y() < ::gmpxxll::mpz_class(rhs.squared());
 }
 
 template <typename Surface>
 bool Chain<Surface>::operator>(const Bound rhs) const {
-  const auto approx = static_cast<const Vector<exactreal::Arb>&>(*this) > rhs;
+  const auto approx = decideAdaptively(Statistics::PREDICATE::CHAIN_BOUND, [&](slong prec) -> std::optional<bool> {
+    if (prec == exactreal::ARB_PRECISION_FAST)
+      return static_cast<const Vector<exactreal::Arb>&>(*this) > rhs;
+    if (!rhs)
+      return std::nullopt;
+    return self->norm(prec) > rhs.squared();
+  });
   if (approx)
     return *approx;
-  return static_cast<const Vector<T>&>(*this) > rhs;
+
+  const Vector<T>& exact = *this;
+  if (!rhs)
+    return static_cast<bool>(exact);
+  return exact.x() * exact.x() + exact.y() * exact.y() > ::gmpxxll::mpz_class(rhs.squared());
 }
 
 template <typename Surface>
@@ -179,6 +204,15 @@ const Surface& Chain<Surface>::surface() const {
   return self->surface;
 }
 
+template <typename Surface>
+MemoryUsage Chain<Surface>::memoryUsage() const {
+  MemoryUsage usage;
+  usage.chains = sizeof(ImplementationOf<Chain>) + self->vector.allocated() + self->approximateVector.allocated();
+  for (size_t i = 0; i < surface().size(); i++)
+    usage.chains += sizeof(fmpz) + allocatedFmpz(self->coefficients[i]);
+  return usage;
+}
+
 template <typename Surface>
 ChainIterator<Surface> Chain<Surface>::begin() const {
   return ImplementationOf<ChainIterator<Surface>>::begin(this);
@@ -237,6 +271,21 @@ std::optional<const mpz_class*> ImplementationOf<Chain<Surface>>::operator[](con
   return reinterpret_cast<const mpz_class*>(promoted);
 }
 
+template <typename Surface>
+exactreal::Arb ImplementationOf<Chain<Surface>>::norm(slong prec) const {
+  exactreal::Arb x, y;
+
+  for (const Edge edge : surface->edges()) {
+    if (fmpz_is_zero(coefficients + edge.index())) continue;
+
+    const Vector<T>& v = surface->fromHalfEdge(edge.positive());
+    arb_addmul_fmpz(x.arb_t(), Approximation<T>::arb(v.x(), prec).arb_t(), coefficients + edge.index(), prec);
+    arb_addmul_fmpz(y.arb_t(), Approximation<T>::arb(v.y(), prec).arb_t(), coefficients + edge.index(), prec);
+  }
+
+  return approximateNorm(x, y, prec);
+}
+
 template <typename Surface>
 size_t ImplementationOf<Chain<Surface>>::hash(const Chain<Surface>& self) {
   const auto hash_fmpz = [](fmpz_t x) -> size_t {
@@ -22,7 +22,10 @@
 #include <optional>
 
 #include "impl/chain.impl.hpp"
+#include "impl/vector.impl.hpp"
 #include "util/assert.ipp"
+#include "util/spin_lock.ipp"
+#include "util/statistics.ipp"
 
 namespace flatsurf {
 
@@ -93,7 +96,8 @@ ChainVector<Surface, T>::ChainVector(const ImplementationOf<Chain<Surface>>* cha
 template <typename Surface, typename T>
 ChainVector<Surface, T>::ChainVector(const ImplementationOf<Chain<Surface>>* chain, Vector<T> value) :
   chain(*chain),
-  value(std::move(value)) {
+  value(std::move(value)),
+  clean(true) {
 }
 
 template <typename Surface, typename T>
@@ -105,6 +109,7 @@ ChainVector<Surface, T>& ChainVector<Surface, T>::operator=(const Vector<T>& val
   this->value = value;
   pendingMoves.clear();
   pendingMovesCost = 0;
+  clean = true;
   return *this;
 }
 
@@ -113,12 +118,14 @@ ChainVector<Surface, T>& ChainVector<Surface, T>::operator=(Vector<T>&& value) n
   this->value = std::move(value);
   pendingMoves.clear();
   pendingMovesCost = 0;
+  clean = true;
   return *this;
 }
 
 template <typename Surface, typename T>
 ChainVector<Surface, T>& ChainVector<Surface, T>::operator+=(HalfEdge halfEdge) {
   (void)halfEdge;
+  clean = false;
   if (value) {
     const double storeAsPendingCost = pendingMovesCost + Cost<T>::copy() + Cost<T>::add();
     if (storeAsPendingCost > recomputeCost()) {
@@ -166,6 +173,7 @@ ChainVector<Surface, T>& ChainVector<Surface, T>::operator-=(ChainVector<Surface
 template <typename Surface, typename T>
 template <typename V>
 ChainVector<Surface, T>& ChainVector<Surface, T>::record(MOVE move, V&& rhs) {
+  clean = false;
   if (value) {
     if (rhs.value) {
       // Both operands have a valid Vector<T>. We now have to decide whether
@@ -208,8 +216,57 @@ double ChainVector<Surface, T>::recomputeCost() {
                                            : (chain.vector.value ? chain.vector.pendingMovesCost : Cost<T>::recompute(chain.surface->size()));
 }
 
+template <typename Surface, typename T>
+void ChainVector<Surface, T>::fill(const Vector<T>& value) const {
+  if (clean.load(std::memory_order_acquire))
+    return;
+
+  SpinLock lock(updating);
+
+  if (clean.load(std::memory_order_relaxed))
+    return;
+
+  this->value = value;
+  pendingMoves.clear();
+  pendingMovesCost = 0;
+  clean.store(true, std::memory_order_release);
+}
+
+template <typename Surface, typename T>
+size_t ChainVector<Surface, T>::allocated() const {
+  SpinLock lock(updating);
+
+  size_t bytes = 0;
+  if (value)
+    bytes += ImplementationOf<Vector<T>>::allocated(*value);
+  for (const auto& move : pendingMoves)
+    bytes += sizeof(move) + ImplementationOf<Vector<T>>::allocated(move.second);
+  return bytes;
+}
+
 template <typename Surface, typename T>
 ChainVector<Surface, T>::operator const Vector<T> &() const {
+  // Once the vector is up to date, it does not change anymore until the chain
+  // is modified, so we can hand it out without taking the lock.
+  if (clean.load(std::memory_order_acquire))
+    return *value;
+
+  using Coordinate = typename Surface::Coordinate;
+
+  if constexpr (std::is_same_v<T, exactreal::Arb>) {
+    // Computing the exact vector also fills in this approximation. We do this
+    // before taking our lock since the exact vector takes our lock to fill us
+    // in.
+    (void)static_cast<const Vector<Coordinate>&>(chain);
+    if (clean.load(std::memory_order_acquire))
+      return *value;
+  }
+
+  SpinLock lock(updating);
+
+  if (clean.load(std::memory_order_relaxed))
+    return *value;
+
   if (value) {
     for (const auto& [move, v] : pendingMoves) {
       switch (move) {
@@ -229,15 +286,13 @@ ChainVector<Surface, T>::operator const Vector<T> &() const {
     ASSERT(pendingMoves.empty(), "value and pendingMoves are out of sync");
     ASSERT(pendingMovesCost == 0, "value and pendingMovesCost are out of sync");
 
-    using Coordinate = typename Surface::Coordinate;
-
     if constexpr (std::is_same_v<T, exactreal::Arb>) {
-      const Vector<Coordinate>& exact = static_cast<const Vector<Coordinate>&>(chain);
-      if (!value)
-        value.emplace(exact);
+      value.emplace(static_cast<const Vector<Coordinate>&>(chain));
     } else {
       static_assert(std::is_same_v<T, Coordinate>);
 
+      LIBFLATSURF_COUNT(CHAIN_RECOMPUTATIONS);
+
       Vector<T> exact;
 
       for (const Edge edge : chain.surface->edges()) {
@@ -248,10 +303,12 @@ ChainVector<Surface, T>::operator const Vector<T> &() const {
 
       value.emplace(std::move(exact));
 
-      chain.approximateVector = static_cast<Vector<exactreal::Arb>>(*value);
+      chain.approximateVector.fill(static_cast<Vector<exactreal::Arb>>(*value));
     }
   }
 
+  clean.store(true, std::memory_order_release);
+
   return *value;
 }
 
@@ -35,6 +35,7 @@
 #include "../flatsurf/vertical.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
 #include "impl/contour_decomposition.impl.hpp"
+#include "impl/vertical.impl.hpp"
 #include "util/assert.ipp"
 
 namespace flatsurf {
@@ -46,7 +47,7 @@ template <typename Surface>
 ContourDecomposition<Surface>::ContourDecomposition(Surface surface, const Vector<T>& vertical) :
   self(spimpl::make_unique_impl<ImplementationOf<ContourDecomposition>>(std::move(surface), vertical)) {
   ASSERTIONS([&]() {
-    ImplementationOf<ContourDecomposition>::check(components() | rx::transform([&](const auto& component) { return component.perimeter(); }) | rx::to_vector(), Vertical(self->state->surface.uncollapsed(), vertical));
+    ImplementationOf<ContourDecomposition>::check(components() | rx::transform([&](const auto& component) { return component.perimeter(); }) | rx::to_vector(), ImplementationOf<Vertical<FlatTriangulation<T>>>::view(self->state->surface.uncollapsed(), vertical));
   });
 }
 
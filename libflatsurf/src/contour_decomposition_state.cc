@@ -26,6 +26,7 @@
 #include "../flatsurf/vertical.hpp"
 #include "impl/contour_component.impl.hpp"
 #include "util/assert.ipp"
+#include "util/tracing.ipp"
 
 namespace flatsurf {
 
@@ -36,12 +37,19 @@ ContourDecompositionState<Surface>::ContourDecompositionState(Surface surface, c
       CHECK_ARGUMENT(surface->vertical().vertical() == vert, "can only decompose with respect to the existing vertical " << surface->vertical().vertical() << " of this surface");
       return surface;
     } else {
-      auto collapsed = FlatTriangulationCollapsed<T>(surface, vert);
-      IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>::makeUniqueLargeEdges(collapsed, vert);
+      auto collapsed = [&]() {
+        LIBFLATSURF_TRACE("FlatTriangulationCollapsed", "surface", surface, "direction", vert);
+        return FlatTriangulationCollapsed<T>(surface, vert);
+      }();
+      {
+        LIBFLATSURF_TRACE("makeUniqueLargeEdges", "surface", surface, "direction", vert);
+        IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>::makeUniqueLargeEdges(collapsed, vert);
+      }
       return collapsed;
     }
   }()),
   components([&]() {
+    LIBFLATSURF_TRACE("ContourDecomposition", "surface", this->surface.uncollapsed(), "direction", vert);
     std::list<ComponentState> components;
     for (auto& component : this->surface.vertical().components()) {
       components.push_back(ComponentState(*this, component));
@@ -25,10 +25,13 @@
 #include <exact-real/number_field.hpp>
 #include <exact-real/rational_field.hpp>
 #include <exact-real/yap/arb.hpp>
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <iosfwd>
 #include <map>
 #include <ostream>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
@@ -39,6 +42,7 @@
 #include "../flatsurf/edge.hpp"
 #include "../flatsurf/edge_set.hpp"
 #include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/half_edge_map.hpp"
 #include "../flatsurf/half_edge_set.hpp"
 #include "../flatsurf/isomorphism.hpp"
 #include "../flatsurf/odd_half_edge_map.hpp"
@@ -54,7 +58,11 @@
 #include "impl/flat_triangulation_combinatorial.impl.hpp"
 #include "impl/quadratic_polynomial.hpp"
 #include "impl/transformation_deformation.hpp"
+#include "impl/vector.impl.hpp"
+#include "impl/vertical.impl.hpp"
 #include "util/assert.ipp"
+#include "util/hash.ipp"
+#include "util/parallel.ipp"
 
 namespace flatsurf {
 
@@ -317,7 +325,34 @@ const Vector<T> &FlatTriangulation<T>::fromHalfEdge(const HalfEdge e) const {
 
 template <typename T>
 const flatsurf::Vector<exactreal::Arb> &FlatTriangulation<T>::fromHalfEdgeApproximate(HalfEdge e) const {
-  return self->approximations->get(e);
+  if constexpr (!concurrent<T>) {
+    // Surfaces over these coordinates are not shared between threads so we
+    // can fill the cache without taking a lock, see ImplementationOf().
+    if (!self->approximations->get(e))
+      self->approximations->set(e, static_cast<flatsurf::Vector<exactreal::Arb>>(fromHalfEdge(e)));
+  }
+
+  return *self->approximations->get(e);
+}
+
+template <typename T>
+MemoryUsage FlatTriangulation<T>::memoryUsage() const {
+  MemoryUsage usage;
+
+  usage.surface = sizeof(ImplementationOf<FlatTriangulation>) + self->allocated();
+  usage.vertical = ImplementationOf<Vertical<FlatTriangulation>>::allocated(*this);
+
+  for (const auto halfEdge : this->halfEdges()) {
+    usage.surface += sizeof(Vector<T>) + ImplementationOf<Vector<T>>::allocated(self->vectors->get(halfEdge));
+
+    // Some approximations are only computed on demand, see fromHalfEdgeApproximate().
+    const auto &approximation = self->approximations->get(halfEdge);
+    usage.approximations += sizeof(approximation);
+    if (approximation)
+      usage.approximations += ImplementationOf<Vector<exactreal::Arb>>::allocated(*approximation);
+  }
+
+  return usage;
 }
 
 template <typename T>
@@ -624,137 +659,474 @@ std::optional<Deformation<FlatTriangulation<T>>> FlatTriangulation<T>::isomorphi
   if (this->hasBoundary())
     throw std::logic_error("not implemented: isomorphism() not implemented for surfaces with boundary");
 
-  const auto ignore = [&](HalfEdge he) {
-    return kind == ISOMORPHISM::FACES ? false : this->delaunay(he.edge()) == DELAUNAY::AMBIGUOUS;
-  };
-  const auto ignoreImage = [&](HalfEdge he) {
-    return kind == ISOMORPHISM::FACES ? false : this->delaunay(he.edge()) == DELAUNAY::AMBIGUOUS;
-  };
-
   if (kind == ISOMORPHISM::DELAUNAY_CELLS) {
     ASSERT(this->edges() | rx::all_of([&](const auto e) { return this->delaunay(e) != DELAUNAY::NON_DELAUNAY; }), "source surface not Delaunay triangulated");
     ASSERT(other.edges() | rx::all_of([&](const auto e) { return other.delaunay(e) != DELAUNAY::NON_DELAUNAY; }), "target surface not Delaunay triangulated");
   }
 
-  // We pick a fixed half edge of this surfaces and try to map it to every
-  // other half edge in the other surface. Taking into account another half
-  // edge in the same face, we get a single possible 2×2 transformation matrix.
-  // (Or rather two possible matrices, if we allow reflections.)
-  HalfEdge preimage = [&]() {
-    for (HalfEdge he : this->halfEdges())
-      if (!ignore(he))
-        return he;
-    throw std::logic_error("cannot detect isomorphism in surface without Delaunay cells");
-  }();
+  const auto ignored = ImplementationOf<FlatTriangulation>::ignored(*this, kind);
+  const auto ignoredImage = ImplementationOf<FlatTriangulation>::ignored(other, kind);
+
+  // The successor of each half edge in its face/cell; or, if reversed, its
+  // predecessor, i.e., its successor after a reflection.
+  const auto cells = [](const FlatTriangulation &surface, const EdgeSet &ignored, bool reversed) {
+    return HalfEdgeMap<HalfEdge>(surface, [&](HalfEdge e) {
+      if (ignored.contains(e))
+        return HalfEdge();
+      e = -e;
+      do {
+        e = reversed ? surface.nextAtVertex(e) : surface.previousAtVertex(e);
+      } while (ignored.contains(e));
+      return e;
+    });
+  };
+
+  const auto nextInCell = cells(*this, ignored, false);
+  const std::array<HalfEdgeMap<HalfEdge>, 2> nextInImageCell = {cells(other, ignoredImage, false), cells(other, ignoredImage, true)};
+
+  // Combinatorial invariants of a half edge that are preserved by any
+  // isomorphism: the total angle at its source, the number of half edges at
+  // its source, and the number of sides of its face/cell.
+  using Invariant = std::tuple<int, int, int>;
+  const auto invariants = [](const FlatTriangulation &surface, const EdgeSet &ignored, const HalfEdgeMap<HalfEdge> &next) {
+    auto invariants = HalfEdgeMap<Invariant>(surface);
+    for (const auto &vertex : surface.vertices()) {
+      const auto outgoing = surface.atVertex(vertex);
+      const int angle = surface.angle(vertex);
+      const int degree = static_cast<int>(std::count_if(begin(outgoing), end(outgoing), [&](HalfEdge he) { return !ignored.contains(he); }));
+      for (const auto he : outgoing) {
+        if (ignored.contains(he))
+          continue;
+        int sides = 0;
+        HalfEdge e = he;
+        do {
+          sides++;
+          e = next[e];
+        } while (e != he);
+        invariants[he] = Invariant{angle, degree, sides};
+      }
+    }
+    return invariants;
+  };
 
-  for (auto image : other.halfEdges()) {
-    if (ignoreImage(image))
+  const auto preimageInvariants = invariants(*this, ignored, nextInCell);
+  // The invariants of the half edges of the other surface when the
+  // isomorphism is a reflection. Then the face/cell of a half edge maps to
+  // the face/cell of the negative of its image, i.e., the cell that we walk
+  // with nextInImageCell[true].
+  const std::array<HalfEdgeMap<Invariant>, 2> imageInvariants = {invariants(other, ignoredImage, nextInImageCell[0]), invariants(other, ignoredImage, nextInImageCell[1])};
+
+  std::map<Invariant, size_t> images;
+  for (HalfEdge he : other.halfEdges())
+    if (!ignoredImage.contains(he))
+      for (bool reflect : {false, true})
+        images[imageInvariants[reflect][he]]++;
+
+  // We pick a fixed half edge of this surface and try to map it to every
+  // half edge with the same invariants in the other surface. Taking into
+  // account another half edge in the same face/cell, we get a single possible
+  // 2×2 transformation matrix. (Or rather two possible matrices, if we allow
+  // reflections.) We pick the half edge whose invariants are the rarest in
+  // the other surface to get as few candidates as possible.
+  std::optional<HalfEdge> preimage;
+  for (HalfEdge he : this->halfEdges()) {
+    if (ignored.contains(he))
       continue;
 
-    for (int sgn : {1, -1}) {
-      const auto nextInCell = [&](auto e) {
-        e = -e;
-        do {
-          e = this->previousAtVertex(e);
-        } while (ignore(e));
-        return e;
-      };
+    const auto candidates = images.find(preimageInvariants[he]);
+    if (candidates == images.end())
+      return std::nullopt;
 
-      const auto nextInImageCell = [&](auto e) {
-        e = -e;
-        if (sgn == 1) {
-          do {
-            e = other.previousAtVertex(e);
-          } while (ignoreImage(e));
-        } else {
-          do {
-            e = other.nextAtVertex(e);
-          } while (ignoreImage(e));
-        }
-        return e;
-      };
+    if (!preimage || candidates->second < images.at(preimageInvariants[*preimage]))
+      preimage = he;
+  }
 
-      auto v = this->fromHalfEdge(preimage);
-      auto w = this->fromHalfEdge(nextInCell(preimage));
-      auto v_ = other.fromHalfEdge(image);
-      auto w_ = other.fromHalfEdge(nextInImageCell(image));
-
-      // To determine the matrix 2×2 matrix (a b c d) that sends v to v_ and w to w_ note that:
-      // ┌ v.x v.y   0   0 ┐ ┌ a ┐   ┌ v_.x ┐
-      // | w.x w.y   0   0 | | b |   | w_.x |
-      // |   0   0 v.x v.y | | c | = | v_.y |
-      // └   0   0 w.x w.y ┘ └ d ┘   └ w_.y ┘
-      // Hence, we can determine (a b) and (c d) by solving a 2×2 system for each.
-      const T denominator = v.x() * w.y() - v.y() * w.x();
-      T a = v_.x() * w.y() - v.y() * w_.x();
-      T b = v.x() * w_.x() - v_.x() * w.x();
-      T c = v_.y() * w.y() - v.y() * w_.y();
-      T d = v.x() * w_.y() - v_.y() * w.x();
-
-      if constexpr (boost::is_detected_v<truediv_t, T>) {
-        a /= denominator;
-        b /= denominator;
-        c /= denominator;
-        d /= denominator;
-      } else {
-        auto maybe = a.truediv(denominator);
-        if (!maybe) continue;
-        a = *maybe;
-
-        maybe = b.truediv(denominator);
-        if (!maybe) continue;
-        b = *maybe;
-
-        maybe = c.truediv(denominator);
-        if (!maybe) continue;
-        c = *maybe;
-
-        maybe = d.truediv(denominator);
-        if (!maybe) continue;
-        d = *maybe;
-      }
+  if (!preimage)
+    throw std::logic_error("cannot detect isomorphism in surface without Delaunay cells");
 
-      if (!filterMatrix(a, b, c, d))
+  std::vector<std::pair<HalfEdge, bool>> candidates;
+  for (HalfEdge image : other.halfEdges())
+    if (!ignoredImage.contains(image))
+      for (bool reflect : {false, true})
+        if (imageInvariants[reflect][image] == preimageInvariants[*preimage])
+          candidates.emplace_back(image, reflect);
+
+  // Walk the half edges starting from preimage ↦ image through the adjacent
+  // faces/cells and return the map of half edges that this determines or
+  // nothing if the map is inconsistent or some pair is rejected by check.
+  const auto walk = [&](HalfEdge image, bool reflect, const auto &check) -> std::optional<HalfEdgeMap<HalfEdge>> {
+    auto isomorphism = HalfEdgeMap<HalfEdge>(*this);
+    std::vector<std::pair<HalfEdge, HalfEdge>> pending = {{*preimage, image}};
+    while (!pending.empty()) {
+      const auto [from, to] = pending.back();
+      pending.pop_back();
+
+      if (isomorphism[from] != HalfEdge()) {
+        if (isomorphism[from] != to)
+          return std::nullopt;
         continue;
+      }
+
+      if (!check(from, to))
+        return std::nullopt;
+
+      isomorphism[from] = to;
+
+      pending.emplace_back(nextInCell[from], nextInImageCell[reflect][to]);
+      pending.emplace_back(-from, -to);
+    }
+    return isomorphism;
+  };
+
+  const auto &v = fromHalfEdge(*preimage);
+  const auto &w = fromHalfEdge(nextInCell[*preimage]);
+
+  const auto &va = fromHalfEdgeApproximate(*preimage);
+  const auto &wa = fromHalfEdgeApproximate(nextInCell[*preimage]);
+
+  // To determine the matrix 2×2 matrix (a b c d) that sends v to v_ and w to w_ note that:
+  // ┌ v.x v.y   0   0 ┐ ┌ a ┐   ┌ v_.x ┐
+  // | w.x w.y   0   0 | | b |   | w_.x |
+  // |   0   0 v.x v.y | | c | = | v_.y |
+  // └   0   0 w.x w.y ┘ └ d ┘   └ w_.y ┘
+  // Hence, we can determine (a b) and (c d) by solving a 2×2 system for each.
+  const T denominator = v.x() * w.y() - v.y() * w.x();
+  const exactreal::Arb denominatorApproximate = (va.x() * wa.y() - va.y() * wa.x())(exactreal::ARB_PRECISION_FAST);
+
+  // Return whether preimage ↦ image could possibly extend to an isomorphism.
+  // This is decided in ball arithmetic, so a negative answer is rigorous.
+  // Instead of the matrix itself, we use the matrix scaled by the
+  // denominator so that no divisions are necessary.
+  const auto approximately = [&](HalfEdge image, bool reflect) {
+    const auto &v_ = other.fromHalfEdgeApproximate(image);
+    const auto &w_ = other.fromHalfEdgeApproximate(nextInImageCell[reflect][image]);
+
+    const exactreal::Arb a = (v_.x() * wa.y() - va.y() * w_.x())(exactreal::ARB_PRECISION_FAST);
+    const exactreal::Arb b = (va.x() * w_.x() - v_.x() * wa.x())(exactreal::ARB_PRECISION_FAST);
+    const exactreal::Arb c = (v_.y() * wa.y() - va.y() * w_.y())(exactreal::ARB_PRECISION_FAST);
+    const exactreal::Arb d = (va.x() * w_.y() - v_.y() * wa.x())(exactreal::ARB_PRECISION_FAST);
+
+    return walk(image, reflect, [&](HalfEdge from, HalfEdge to) {
+      if (preimageInvariants[from] != imageInvariants[reflect][to])
+        return false;
+
+      const auto &u = fromHalfEdgeApproximate(from);
+      const auto &u_ = other.fromHalfEdgeApproximate(to);
+
+      const exactreal::Arb x = (u.x() * a + u.y() * b - u_.x() * denominatorApproximate)(exactreal::ARB_PRECISION_FAST);
+      if (!arb_contains_zero(x.arb_t()))
+        return false;
+
+      const exactreal::Arb y = (u.x() * c + u.y() * d - u_.y() * denominatorApproximate)(exactreal::ARB_PRECISION_FAST);
+      return static_cast<bool>(arb_contains_zero(y.arb_t()));
+    }).has_value();
+  };
+
+  using Matrix = std::tuple<T, T, T, T>;
+
+  // Return the matrix that sends preimage to image (exactly.)
+  const auto matrix = [&](HalfEdge image, bool reflect) -> std::optional<Matrix> {
+    const auto &v_ = other.fromHalfEdge(image);
+    const auto &w_ = other.fromHalfEdge(nextInImageCell[reflect][image]);
+
+    T a = v_.x() * w.y() - v.y() * w_.x();
+    T b = v.x() * w_.x() - v_.x() * w.x();
+    T c = v_.y() * w.y() - v.y() * w_.y();
+    T d = v.x() * w_.y() - v_.y() * w.x();
+
+    if constexpr (boost::is_detected_v<truediv_t, T>) {
+      a /= denominator;
+      b /= denominator;
+      c /= denominator;
+      d /= denominator;
+    } else {
+      auto maybe = a.truediv(denominator);
+      if (!maybe) return std::nullopt;
+      a = *maybe;
+
+      maybe = b.truediv(denominator);
+      if (!maybe) return std::nullopt;
+      b = *maybe;
+
+      maybe = c.truediv(denominator);
+      if (!maybe) return std::nullopt;
+      c = *maybe;
+
+      maybe = d.truediv(denominator);
+      if (!maybe) return std::nullopt;
+      d = *maybe;
+    }
+
+    return Matrix{a, b, c, d};
+  };
+
+  // Return whether the matrix sends the vector of from to the vector of to.
+  const auto maps = [&](const Matrix &matrix, HalfEdge from, HalfEdge to) {
+    const auto &[a, b, c, d] = matrix;
+    const auto &u = fromHalfEdge(from);
+    const auto &u_ = other.fromHalfEdge(to);
+    return u.x() * a + u.y() * b == u_.x() && u.x() * c + u.y() * d == u_.y();
+  };
 
-      // The isomorphism of half edges can now be determined by starting with
-      // the half edges of this face/cell and depth-first searching through all
-      // the adjacent faces/cells until we find a contradiction.
-      auto isomorphism = HalfEdgeMap<HalfEdge>(*this);
+  // Determine the candidates that are isomorphisms if we do not take the
+  // filters into account. This does not call any of the callbacks, so we can
+  // process the candidates in parallel.
+  std::vector<std::optional<Matrix>> matrices(candidates.size());
 
-      const std::function<bool(HalfEdge, HalfEdge)> match = [&](const HalfEdge from, const HalfEdge to) {
-        if (!filterHalfEdgeMap(from, to))
-          return false;
+  const auto prune = [&](size_t i) {
+    const auto [image, reflect] = candidates[i];
 
-        if (isomorphism[from] != HalfEdge())
-          return isomorphism[from] == to;
+    if (!approximately(image, reflect))
+      return;
 
-        isomorphism[from] = to;
+    auto candidate = matrix(image, reflect);
+    if (!candidate)
+      return;
 
-        if (this->fromHalfEdge(from).x() * a + this->fromHalfEdge(from).y() * b != other.fromHalfEdge(to).x())
-          return false;
+    if (!walk(image, reflect, [&](HalfEdge from, HalfEdge to) { return maps(*candidate, from, to); }))
+      return;
 
-        if (this->fromHalfEdge(from).x() * c + this->fromHalfEdge(from).y() * d != other.fromHalfEdge(to).y())
-          return false;
+    matrices[i] = std::move(candidate);
+  };
+
+  if constexpr (concurrent<T>) {
+    parallel(candidates.size(), prune);
+  } else {
+    for (size_t i = 0; i < candidates.size(); i++)
+      prune(i);
+  }
+
+  // Apply the filters to the remaining candidates in order.
+  for (size_t i = 0; i < candidates.size(); i++) {
+    if (!matrices[i])
+      continue;
+
+    const auto &[a, b, c, d] = *matrices[i];
+    if (!filterMatrix(a, b, c, d))
+      continue;
 
-        // We found that this half edge is mapped in a consistent way. Now
-        // check its negative.
-        if (!match(-from, -to))
-          return false;
+    auto isomorphism = walk(candidates[i].first, candidates[i].second, [&](HalfEdge from, HalfEdge to) {
+      return filterHalfEdgeMap(from, to) && maps(*matrices[i], from, to);
+    });
 
-        // And check that every other edge in its face/cell maps consistently
-        if (!match(nextInCell(from), nextInImageCell(to)))
-          return false;
+    if (isomorphism)
+      return TransformationDeformation<FlatTriangulation>::make(other.clone(), std::move(*isomorphism));
+  }
 
+  return std::nullopt;
+}
+
+template <typename T>
+std::optional<Deformation<FlatTriangulation<T>>> FlatTriangulation<T>::isomorphism(const FlatTriangulation<T> &other, ISOMORPHISM kind, ISOMORPHISM_FILTER filter) const {
+  switch (filter) {
+    case ISOMORPHISM_FILTER::IDENTITY:
+      return isomorphism(other, kind);
+    case ISOMORPHISM_FILTER::UNIMODULAR:
+      return isomorphism(other, kind, [](const T &a, const T &b, const T &c, const T &d) {
+        const T det = a * d - b * c;
+        return det == 1 || det == -1;
+      });
+    case ISOMORPHISM_FILTER::ORTHOGONAL:
+      return isomorphism(other, kind, [](const T &a, const T &b, const T &c, const T &d) {
+        return a * b + c * d == 0 && a * a + c * c == 1 && b * b + d * d == 1;
+      });
+    case ISOMORPHISM_FILTER::SL2Z:
+      return isomorphism(other, kind, [](const T &a, const T &b, const T &c, const T &d) {
+        const auto integer = [](const T &x) {
+          if constexpr (std::is_integral_v<T> || std::is_same_v<T, mpz_class>)
+            return true;
+          else if constexpr (std::is_same_v<T, mpq_class>)
+            return x.get_den() == 1;
+          else
+            return x.floor() == x.ceil();
+        };
+        return a * d - b * c == 1 && integer(a) && integer(b) && integer(c) && integer(d);
+      });
+  }
+
+  UNREACHABLE("unknown isomorphism filter");
+}
+
+template <typename T>
+std::optional<Deformation<FlatTriangulation<T>>> FlatTriangulation<T>::isomorphism(const FlatTriangulation<T> &other, ISOMORPHISM kind, const std::vector<std::tuple<T, T, T, T>> &matrices) const {
+  return isomorphism(other, kind, [&](const T &a, const T &b, const T &c, const T &d) {
+    return std::any_of(begin(matrices), end(matrices), [&](const auto &matrix) { return std::tie(a, b, c, d) == matrix; });
+  });
+}
+
+template <typename T>
+Deformation<FlatTriangulation<T>> FlatTriangulation<T>::canonical(ISOMORPHISM kind, ISOMORPHISM_FILTER filter) const {
+  if (this->hasBoundary())
+    throw std::logic_error("not implemented: canonical() not implemented for surfaces with boundary");
+  if (filter != ISOMORPHISM_FILTER::IDENTITY)
+    throw std::logic_error("not implemented: canonical() only supports isomorphisms that are translations");
+
+  if (kind == ISOMORPHISM::DELAUNAY_CELLS)
+    ASSERT(this->edges() | rx::all_of([&](const auto e) { return this->delaunay(e) != DELAUNAY::NON_DELAUNAY; }), "surface not Delaunay triangulated");
+
+  const auto ignored = ImplementationOf<FlatTriangulation>::ignored(*this, kind);
+
+  // The successor of each half edge in its face/cell.
+  const auto nextInCell = HalfEdgeMap<HalfEdge>(*this, [&](HalfEdge e) {
+    if (ignored.contains(e))
+      return HalfEdge();
+    e = -e;
+    do {
+      e = this->previousAtVertex(e);
+    } while (ignored.contains(e));
+    return e;
+  });
+
+  const auto less = [](const Vector<T> &v, const Vector<T> &w) {
+    return v.x() < w.x() || (v.x() == w.x() && v.y() < w.y());
+  };
+
+  // The canonical labelling starts at a half edge with minimal vector. Since
+  // isomorphisms preserve vectors, only these half edges need to be tried.
+  std::vector<HalfEdge> starts;
+  for (HalfEdge he : this->halfEdges()) {
+    if (ignored.contains(he))
+      continue;
+    if (starts.empty() || less(fromHalfEdge(he), fromHalfEdge(starts[0])))
+      starts = {he};
+    else if (!less(fromHalfEdge(starts[0]), fromHalfEdge(he)))
+      starts.push_back(he);
+  }
+
+  if (starts.empty())
+    throw std::logic_error("cannot create canonical form of surface without Delaunay cells");
+
+  using Labelling = std::pair<std::vector<HalfEdge>, HalfEdgeMap<HalfEdge>>;
+
+  // Label the half edges by walking the faces/cells in breadth-first order
+  // starting from start. Since this walk only depends on the combinatorics,
+  // an isomorphism maps it to the walk in the image starting from the image
+  // of start.
+  const auto label = [&](HalfEdge start) {
+    Labelling labelling{{}, HalfEdgeMap<HalfEdge>(*this)};
+    auto &order = labelling.first;
+    auto &labels = labelling.second;
+
+    const auto visit = [&](HalfEdge he) {
+      if (labels[he] != HalfEdge())
+        return;
+      const int id = static_cast<int>(order.size() / 2 + 1);
+      labels[he] = HalfEdge(id);
+      labels[-he] = HalfEdge(-id);
+      order.push_back(he);
+      order.push_back(-he);
+    };
+
+    visit(start);
+    for (size_t i = 0; i < order.size(); i++)
+      visit(nextInCell[order[i]]);
+
+    return labelling;
+  };
+
+  // Return whether the surface encoded by the labelling lhs, i.e., the
+  // successors and vectors of the half edges in the order of their labels,
+  // is lexicographically smaller than the one encoded by rhs.
+  const auto smaller = [&](const Labelling &lhs, const Labelling &rhs) {
+    for (size_t i = 0; i < lhs.first.size(); i++) {
+      const HalfEdge l = lhs.first[i];
+      const HalfEdge r = rhs.first[i];
+
+      const int lnext = lhs.second[nextInCell[l]].id();
+      const int rnext = rhs.second[nextInCell[r]].id();
+      if (lnext != rnext)
+        return lnext < rnext;
+
+      if (less(fromHalfEdge(l), fromHalfEdge(r)))
         return true;
-      };
+      if (less(fromHalfEdge(r), fromHalfEdge(l)))
+        return false;
+    }
+    return false;
+  };
+
+  Labelling canonical = label(starts[0]);
+  for (size_t i = 1; i < starts.size(); i++) {
+    auto candidate = label(starts[i]);
+    if (smaller(candidate, canonical))
+      canonical = std::move(candidate);
+  }
+
+  const auto &order = canonical.first;
+  auto &labels = canonical.second;
+
+  std::vector<Vector<T>> vectors;
+  for (size_t i = 0; i < order.size(); i += 2)
+    vectors.push_back(fromHalfEdge(order[i]));
+
+  // Build the faces of the canonical surface. Each cell is triangulated by
+  // a fan from the source of its half edge with the smallest label.
+  std::vector<std::tuple<HalfEdge, HalfEdge, HalfEdge>> faces;
+  int diagonals = static_cast<int>(vectors.size());
+  HalfEdgeSet done;
+  for (const auto he : order) {
+    if (done.contains(he))
+      continue;
+
+    std::vector<HalfEdge> cell;
+    for (auto e = he; !done.contains(e); e = nextInCell[e]) {
+      done.insert(e);
+      cell.push_back(e);
+    }
+
+    ASSERT(cell.size() >= 3, "cell must have at least three sides but " << he << " is in a cell with " << cell.size() << " sides");
 
-      if (match(preimage, image))
-        return TransformationDeformation<FlatTriangulation>::make(other.clone(), std::move(isomorphism));
+    HalfEdge diagonal = labels[cell[0]];
+    Vector<T> sum = fromHalfEdge(cell[0]);
+    for (size_t i = 1; i + 2 < cell.size(); i++) {
+      sum += fromHalfEdge(cell[i]);
+      const auto next = HalfEdge(++diagonals);
+      vectors.push_back(-sum);
+      faces.emplace_back(diagonal, labels[cell[i]], next);
+      diagonal = -next;
     }
+    faces.emplace_back(diagonal, labels[cell[cell.size() - 2]], labels[cell.back()]);
   }
 
-  return std::nullopt;
+  ASSERT(vectors.size() == this->edges().size(), "canonical surface must have the same number of edges as the original surface");
+
+  return TransformationDeformation<FlatTriangulation>::make(FlatTriangulation(FlatTriangulationCombinatorial(faces), vectors), std::move(labels), kind == ISOMORPHISM::DELAUNAY_CELLS);
+}
+
+template <typename T>
+size_t FlatTriangulation<T>::hash(ISOMORPHISM kind, ISOMORPHISM_FILTER filter) const {
+  if (filter != ISOMORPHISM_FILTER::IDENTITY)
+    throw std::logic_error("not implemented: hash() only supports isomorphisms that are translations");
+
+  const auto ignored = ImplementationOf<FlatTriangulation>::ignored(*this, kind);
+
+  // The vectors of the half edges are preserved by the isomorphisms of
+  // canonical(), so we combine their hashes in a way that does not depend on
+  // their order.
+  size_t vectors = 0;
+  for (HalfEdge he : this->halfEdges())
+    if (!ignored.contains(he))
+      vectors += hash_combine(static_cast<size_t>(kind), fromHalfEdge(he));
+
+  std::vector<int> angles;
+  for (const auto &vertex : this->vertices())
+    angles.push_back(angle(vertex));
+  std::sort(begin(angles), end(angles));
+
+  size_t ret = hash_combine(this->halfEdges().size(), this->vertices().size(), vectors);
+  for (const int angle : angles)
+    ret = hash_combine(ret, angle);
+  return ret;
+}
+
+template <typename T>
+EdgeSet ImplementationOf<FlatTriangulation<T>>::ignored(const FlatTriangulation<T> &surface, ISOMORPHISM kind) {
+  EdgeSet ignored;
+  if (kind == ISOMORPHISM::DELAUNAY_CELLS)
+    for (const auto edge : surface.edges())
+      if (surface.delaunay(edge) == DELAUNAY::AMBIGUOUS)
+        ignored.insert(edge);
+  return ignored;
 }
 
 template <typename T>
@@ -782,20 +1154,18 @@ ImplementationOf<FlatTriangulation<T>>::ImplementationOf(FlatTriangulationCombin
     return ret;
   }()),
   approximations([&]() {
-    // We keep track of the vectors attached to the half edges in a Tracked<>
-    // object. To construct such an object, we need the surface it is tracking.
-    // However, that surface is the surface we are in the process of building.
-    // In particular it is not referenced by shared pointer yet. Therefore, we
-    // now build a combinatorial triangulation from the data we are building
-    // and wrap it in a shared pointer that does *not* free its memory when it
-    // goes out of scope.
+    // We keep track of the approximations attached to the half edges in a
+    // Tracked<> object, see above.
     auto self = from_this(std::shared_ptr<ImplementationOf>(this, [](auto *) {}));
-    auto ret = Tracked<OddHalfEdgeMap<Vector<exactreal::Arb>>>(
+    auto ret = Tracked<OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>>(
         self,
-        OddHalfEdgeMap<Vector<exactreal::Arb>>(
+        OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>(
             self,
-            [&](const HalfEdge e) {
-              return static_cast<flatsurf::Vector<exactreal::Arb>>(this->vectors->get(e));
+            [&](const HalfEdge e) -> std::optional<Vector<exactreal::Arb>> {
+              if constexpr (concurrent<T>)
+                return static_cast<flatsurf::Vector<exactreal::Arb>>(this->vectors->get(e));
+              else
+                return std::nullopt;
             }),
         ImplementationOf::updateApproximationAfterFlip);
     // The shared pointer we used to build the Tracked is not going to remain
@@ -811,9 +1181,15 @@ void ImplementationOf<FlatTriangulation<T>>::updateAfterFlip(OddHalfEdgeMap<Vect
 }
 
 template <typename T>
-void ImplementationOf<FlatTriangulation<T>>::updateApproximationAfterFlip(OddHalfEdgeMap<flatsurf::Vector<exactreal::Arb>> &vectors, const FlatTriangulationCombinatorial &combinatorial, HalfEdge flip) {
-  const auto &surface = reinterpret_cast<const FlatTriangulation<T> &>(combinatorial);
-  vectors.set(flip, static_cast<flatsurf::Vector<exactreal::Arb>>(surface.fromHalfEdge(-surface.nextInFace(flip)) + surface.fromHalfEdge(-surface.previousInFace(flip))));
+void ImplementationOf<FlatTriangulation<T>>::updateApproximationAfterFlip(OddHalfEdgeMap<std::optional<flatsurf::Vector<exactreal::Arb>>> &approximations, const FlatTriangulationCombinatorial &combinatorial, HalfEdge flip) {
+  if constexpr (concurrent<T>) {
+    const auto &surface = reinterpret_cast<const FlatTriangulation<T> &>(combinatorial);
+    approximations.set(flip, static_cast<flatsurf::Vector<exactreal::Arb>>(surface.fromHalfEdge(-surface.nextInFace(flip)) + surface.fromHalfEdge(-surface.previousInFace(flip))));
+  } else {
+    // The approximation is recomputed from the new vector when it is
+    // requested next.
+    approximations.set(flip, std::nullopt);
+  }
 }
 
 template <typename T>
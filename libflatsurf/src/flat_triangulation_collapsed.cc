@@ -37,6 +37,8 @@
 #include "../flatsurf/bound.hpp"
 #include "../flatsurf/ccw.hpp"
 #include "../flatsurf/edge.hpp"
+#include "../flatsurf/edge_set.hpp"
+#include "../flatsurf/edge_set_iterator.hpp"
 #include "../flatsurf/flat_triangulation.hpp"
 #include "../flatsurf/flat_triangulation_combinatorial.hpp"
 #include "../flatsurf/half_edge.hpp"
@@ -45,6 +47,7 @@
 #include "../flatsurf/path.hpp"
 #include "../flatsurf/path_iterator.hpp"
 #include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/tracked.hpp"
 #include "../flatsurf/vector.hpp"
 #include "../flatsurf/vertex.hpp"
 #include "../flatsurf/vertical.hpp"
@@ -55,6 +58,8 @@
 #include "impl/flat_triangulation_collapsed.impl.hpp"
 #include "impl/flat_triangulation_combinatorial.impl.hpp"
 #include "impl/saddle_connection.impl.hpp"
+#include "impl/vector.impl.hpp"
+#include "impl/vertical.impl.hpp"
 #include "util/assert.ipp"
 #include "util/union_find.ipp"
 
@@ -70,16 +75,7 @@ FlatTriangulationCollapsed<T>::FlatTriangulationCollapsed() noexcept :
 template <typename T>
 FlatTriangulationCollapsed<T>::FlatTriangulationCollapsed(const FlatTriangulation<T>& surface, const Vector<T>& vertical) :
   FlatTriangulationCombinatorics<FlatTriangulationCollapsed>(ProtectedConstructor{}, std::make_shared<ImplementationOf<FlatTriangulationCollapsed>>(surface, vertical)) {
-  while ([&]() {
-    for (auto e : this->halfEdges()) {
-      if (this->vertical().ccw(e) == CCW::COLLINEAR) {
-        self->collapse(e);
-        return true;
-      }
-    }
-    return false;
-  }())
-    ;
+  self->collapseVertical();
 }
 
 template <typename T>
@@ -132,6 +128,24 @@ Path<FlatTriangulation<T>> FlatTriangulationCollapsed<T>::turn(HalfEdge from, Ha
   return connections;
 }
 
+template <typename T>
+MemoryUsage FlatTriangulationCollapsed<T>::memoryUsage() const {
+  MemoryUsage usage;
+
+  usage.collapsed = sizeof(ImplementationOf<FlatTriangulationCollapsed>) + self->allocated() + ImplementationOf<Vector<T>>::allocated(self->vertical);
+
+  for (const auto halfEdge : this->halfEdges()) {
+    usage.collapsed += sizeof(CollapsedHalfEdge<T>) + sizeof(SaddleConnection);
+    usage += fromHalfEdge(halfEdge).memoryUsage();
+    for (const auto& connection : self->collapsedHalfEdges->operator[](halfEdge).connections)
+      usage += connection.memoryUsage();
+  }
+
+  usage.vertical += ImplementationOf<Vertical<FlatTriangulationCollapsed>>::allocated(*this);
+
+  return usage;
+}
+
 template <typename T>
 const FlatTriangulation<T>& FlatTriangulationCollapsed<T>::uncollapsed() const {
   return self->original;
@@ -285,9 +299,11 @@ void ImplementationOf<FlatTriangulationCollapsed<T>>::updateBeforeCollapse(HalfE
 
   HalfEdge collapse = collapse_.positive();
 
-  ASSERT(surface.vertical().ccw(collapse) == CCW::COLLINEAR, "cannot collapse non-vertical edge " << collapse);
+  const auto& vertical = surface.self->vertical;
+
+  ASSERT(vertical.ccw(vectors[collapse]) == CCW::COLLINEAR, "cannot collapse non-vertical edge " << collapse);
 
-  if (surface.vertical().orientation(collapse) == ORIENTATION::OPPOSITE)
+  if (vertical.orientation(vectors[collapse]) == ORIENTATION::OPPOSITE)
     collapse = -collapse;
 
   auto& collapsedHalfEdges = surface.self->collapsedHalfEdges;
@@ -463,26 +479,80 @@ std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCollapsed<T>>::c
     }
   }));
 
-  ASSERTIONS(([&]() {
-    std::unordered_map<Vertex, int> vertices;
-    for (auto& vertex : original->vertices())
-      vertices[vertex] = 0;
+  ASSERTIONS(([&]() { checkVertices(); }));
 
-    for (auto halfEdge : self.halfEdges()) {
-      const auto& connection = self.fromHalfEdge(halfEdge);
-      vertices[Vertex::source(connection.source(), *original)]++;
+  return ret;
+}
 
-      for (auto& collapsed : self.cross(halfEdge))
-        vertices[Vertex::source(collapsed.source(), *original)]++;
-    }
+template <typename T>
+void ImplementationOf<FlatTriangulationCollapsed<T>>::collapseVertical() {
+  auto self = from_this();
 
-    for (auto& count : vertices) {
-      ASSERT(count.second != 0, "Vertex " << count.first << " disappeared from surface after collapse; the vertex was still there in the original surface " << original << " but is gone in the collapsed surface " << self);
-      ASSERT(count.second >= 2, "Vertex " << count.first << " almost disappeared from surface after collapse; the vertex was still there in the original surface " << original << " but it has only one outgoing edge in the collapsed surface " << self);
+  const auto collinear = [&](HalfEdge e) { return vertical.ccw(vectors->operator[](e)) == CCW::COLLINEAR; };
+
+  const auto isVertical = [&](Edge e) { return collinear(e.positive()) || collinear(e.negative()); };
+
+  // Collapsing an edge only reshuffles the vectors in the gadget around it,
+  // so typically all the vertical edges are known after a single scan of the
+  // surface. We collapse them in a batch and rebuild the vertices and the
+  // list of edges only once. (Each collapse still moves the dropped edges to
+  // the end and renumbers them right away, since the following collapses
+  // need a surface without gaps in its edge numbering.) We then scan again
+  // to make sure no vertical edges remain.
+  while (true) {
+    // The vertical edges that we still need to collapse. Collapsing edges
+    // renumbers edges so we track this set.
+    Tracked<EdgeSet> pending(
+        self, EdgeSet(self.edges() | rx::filter(isVertical) | rx::to_vector()),
+        Tracked<EdgeSet>::defaultFlip,
+        [](auto&, const auto&, Edge) {});
+
+    if (pending->empty())
+      break;
+
+    while (!pending->empty()) {
+      // Collapse the vertical edge of minimal index first, i.e., the edge
+      // that a scan over all half edges would find first.
+      const Edge e = *std::min_element(begin(*pending), end(*pending), [](const Edge lhs, const Edge rhs) { return lhs.index() < rhs.index(); });
+
+      if (!isVertical(e)) {
+        pending->erase(e);
+        continue;
+      }
+
+      ImplementationOf<FlatTriangulationCombinatorial>::collapseWithoutReset(collinear(e.positive()) ? e.positive() : e.negative());
+
+      ASSERT(!pending->contains(e) || !isVertical(e), "Collapsed edge " << e << " must have been removed from the surface.");
     }
-  }));
 
-  return ret;
+    resetAfterCollapse();
+
+    ASSERT(area() == self.area(), "Area inconsistent after collapse of vertical edges. Area is " << area() << " but should still be " << self.area());
+    ASSERT(self.halfEdges() | rx::all_of([&](const auto e) { return faceClosed(e); }), "Some faces are not closed after collapse of vertical edges in " << self);
+    ASSERTIONS(([&]() { checkVertices(); }));
+  }
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulationCollapsed<T>>::checkVertices() {
+  auto self = from_this();
+
+  std::unordered_map<Vertex, int> vertices;
+  for (auto& vertex : original->vertices())
+    vertices[vertex] = 0;
+
+  for (auto halfEdge : self.halfEdges()) {
+    const auto& connection = self.fromHalfEdge(halfEdge);
+    vertices[Vertex::source(connection.source(), *original)]++;
+
+    for (auto& collapsed : self.cross(halfEdge))
+      vertices[Vertex::source(collapsed.source(), *original)]++;
+  }
+
+  for (auto& count : vertices) {
+    ASSERT(count.second != 0, "Vertex " << count.first << " disappeared from surface; the vertex was still there in the original surface " << original << " but is gone in the collapsed surface " << self);
+    ASSERT(count.second >= 2, "Vertex " << count.first << " almost disappeared from surface; the vertex was still there in the original surface " << original << " but it has only one outgoing edge in the collapsed surface " << self);
+  }
 }
 
 template <typename T>
@@ -21,6 +21,7 @@
 
 #include <fmt/format.h>
 
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -30,8 +31,10 @@
 #include "../flatsurf/half_edge_set_iterator.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
 #include "impl/flat_triangulation_combinatorial.impl.hpp"
+#include "impl/half_edge_set.impl.hpp"
 #include "impl/vertex.impl.hpp"
 #include "util/assert.ipp"
+#include "util/statistics.ipp"
 
 namespace flatsurf {
 
@@ -132,9 +135,30 @@ ImplementationOf<FlatTriangulationCombinatorial>::ImplementationOf(const Permuta
 }
 
 sigslot::connection ImplementationOf<FlatTriangulationCombinatorial>::connect(const ImplementationOf* surface, std::function<void(Message)> handler) {
+  const std::lock_guard<std::mutex> lock(surface->connections);
   return surface->change.connect(handler);
 }
 
+void ImplementationOf<FlatTriangulationCombinatorial>::disconnect(const ImplementationOf* surface, sigslot::connection& connection) {
+  const std::lock_guard<std::mutex> lock(surface->connections);
+  connection.disconnect();
+}
+
+size_t ImplementationOf<FlatTriangulationCombinatorial>::allocated() const {
+  size_t bytes = edges.capacity() * sizeof(Edge);
+  bytes += halfEdges.capacity() * sizeof(HalfEdge);
+
+  // A permutation stores itself and its inverse.
+  bytes += 2 * (vertices.size() + faces.size()) * sizeof(HalfEdge);
+
+  // Every vertex stores the set of its outgoing half edges as a bitset
+  // that can be as long as there are half edges.
+  bytes += vertexes.capacity() * sizeof(Vertex);
+  bytes += vertexes.size() * (sizeof(ImplementationOf<Vertex>) + sizeof(ImplementationOf<HalfEdgeSet>) + (halfEdges.size() + 7) / 8);
+
+  return bytes;
+}
+
 void ImplementationOf<FlatTriangulationCombinatorial>::check() const {
   assert(faces.domain().size() == vertices.domain().size() && "faces and vertices must have the same half edges as domain");
   assert([&]() {
@@ -196,6 +220,14 @@ void ImplementationOf<FlatTriangulationCombinatorial>::resetEdges() {
 void ImplementationOf<FlatTriangulationCombinatorial>::swap(HalfEdge a, HalfEdge b) {
   if (a == b) return;
 
+  swapWithoutReset(a, b);
+
+  resetVertexes();
+}
+
+void ImplementationOf<FlatTriangulationCombinatorial>::swapWithoutReset(HalfEdge a, HalfEdge b) {
+  if (a == b) return;
+
   change(ImplementationOf::MessageBeforeSwap{a, b});
 
   vertices *= {a, b};
@@ -213,8 +245,6 @@ void ImplementationOf<FlatTriangulationCombinatorial>::swap(HalfEdge a, HalfEdge
     faces *= {-a, -b};
     std::vector{-a, -b} *= faces;
   }
-
-  resetVertexes();
 }
 
 void ImplementationOf<FlatTriangulationCombinatorial>::flip(HalfEdge e) {
@@ -245,6 +275,8 @@ void ImplementationOf<FlatTriangulationCombinatorial>::flip(HalfEdge e) {
   for (auto& vertex : vertexes)
     ImplementationOf<Vertex>::afterFlip(vertex, self, e);
 
+  LIBFLATSURF_COUNT(FLIPS);
+
   // notify attached structures about this flip
   change(ImplementationOf<FlatTriangulationCombinatorial>::MessageAfterFlip{e});
 
@@ -252,6 +284,28 @@ void ImplementationOf<FlatTriangulationCombinatorial>::flip(HalfEdge e) {
 }
 
 std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCombinatorial>::collapse(HalfEdge collapse) {
+  const auto ret = collapseWithoutReset(collapse);
+
+  resetAfterCollapse();
+
+  return ret;
+}
+
+void ImplementationOf<FlatTriangulationCombinatorial>::resetAfterCollapse() {
+  // Calculate vertex permutation from half edges, note that this might
+  // separate vertices when a connection from a vertex to itself has been
+  // collapsed.
+  resetVertices();
+
+  // The vertices at the end of collapsed edges need to merge (or separate.)
+  resetVertexes();
+
+  resetEdges();
+
+  check();
+}
+
+std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCombinatorial>::collapseWithoutReset(HalfEdge collapse) {
   auto self = from_this();
 
   if (self.boundary(collapse) || self.boundary(-collapse))
@@ -260,6 +314,8 @@ std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCombinatorial>::
   if (self.nextInFace(self.nextInFace(self.nextInFace(collapse))) != collapse || self.nextInFace(self.nextInFace(self.nextInFace(-collapse))) != -collapse)
     throw std::logic_error("not implemented: cannot collapse collapsed edge yet");
 
+  LIBFLATSURF_COUNT(COLLAPSES);
+
   // notify attached structures about this collapse
   change(ImplementationOf<FlatTriangulationCombinatorial>::MessageBeforeCollapse{collapse});
 
@@ -297,13 +353,17 @@ std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCombinatorial>::
     // This is probably necessary to correctly identify the maxEdge, see https://github.com/flatsurf/flatsurf/issues/147
     std::sort(begin(originalDropEdges), end(originalDropEdges), [&](const auto& lhs, const auto& rhs) { return lhs.index() < rhs.index(); });
 
-    int maxEdge = static_cast<int>(self.edges().size());
+    // Note that we cannot use self.edges() here since it is not updated
+    // during a batch of collapses.
+    const size_t edges = faces.size() / 2;
+
+    int maxEdge = static_cast<int>(edges);
     for (auto d : originalDropEdges) {
       while (maxEdge && dropEdges.find(Edge(maxEdge)) != end(dropEdges))
         maxEdge--;
-      if (d.index() < self.edges().size() - dropEdges.size()) {
+      if (d.index() < edges - dropEdges.size()) {
         HalfEdge swap = Edge(maxEdge).positive();
-        this->swap(d.positive(), swap);
+        this->swapWithoutReset(d.positive(), swap);
         if (d.positive() == collapse)
           collapse = swap;
         else if (d.negative() == collapse)
@@ -354,20 +414,6 @@ std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCombinatorial>::
 
   faces.drop(dropHalfEdges | rx::to_vector());
 
-  // Calculate vertex permutation from half edges, note that this might
-  // separate vertices when a connection from a vertex to itself has been
-  // collapsed.
-  resetVertices();
-
-  // The vertices at the end of e need to merge (or separate.) We could do this
-  // more efficiently, but it's probably not worth it.
-  resetVertexes();
-
-  // This could also be done more efficiently.
-  resetEdges();
-
-  check();
-
   if (dropEdges.find(a) != end(dropEdges)) {
     assert(dropEdges.find(c) == end(dropEdges) && "an entire horizontal part of the surface has been dropped out of existence");
     return std::make_pair(-c, c);
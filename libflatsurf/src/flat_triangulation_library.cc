@@ -0,0 +1,410 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/flat_triangulation_library.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <system_error>
+
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flat_triangulation_view.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/vector.hpp"
+#include "impl/flat_triangulation_library.impl.hpp"
+#include "impl/flat_triangulation_view.impl.hpp"
+#include "util/assert.ipp"
+#include "util/false.ipp"
+
+namespace flatsurf {
+
+namespace {
+
+// Return the number of words needed to store this many bytes.
+size_t words(size_t bytes) {
+  return (bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+}
+
+void encodeString(std::vector<uint64_t>& encoded, const std::string& s) {
+  encoded.push_back(s.size());
+  const size_t begin = encoded.size();
+  encoded.resize(begin + words(s.size()));
+  std::memcpy(encoded.data() + begin, s.data(), s.size());
+}
+
+std::string decodeString(const uint64_t*& encoded, const uint64_t* end) {
+  CHECK_ARGUMENT(encoded < end, "library is corrupt: string is truncated");
+  const size_t size = *encoded++;
+  CHECK_ARGUMENT(words(size) >= size / sizeof(uint64_t) && words(size) <= static_cast<size_t>(end - encoded), "library is corrupt: string is truncated");
+  std::string ret(reinterpret_cast<const char*>(encoded), size);
+  encoded += words(size);
+  return ret;
+}
+
+// Encode x as its signed number of 64-bit words followed by the words of its
+// absolute value, least significant word first. Unlike GMP limbs, this does
+// not depend on the size of mp_limb_t.
+void encodeInteger(std::vector<uint64_t>& encoded, const mpz_class& x) {
+  const size_t size = x == 0 ? 0 : words((mpz_sizeinbase(x.get_mpz_t(), 2) + 7) / 8);
+  encoded.push_back(static_cast<uint64_t>(mpz_sgn(x.get_mpz_t()) * static_cast<int64_t>(size)));
+  const size_t begin = encoded.size();
+  encoded.resize(begin + size);
+  size_t count = 0;
+  mpz_export(encoded.data() + begin, &count, -1, sizeof(uint64_t), 0, 0, x.get_mpz_t());
+  ASSERT(count == size, "integer " << x << " must be encoded in " << size << " words but GMP wrote " << count);
+}
+
+// Return the number of words of the absolute value of an integer encoded
+// at encoded.
+size_t integerSize(const uint64_t* encoded) {
+  const int64_t size = static_cast<int64_t>(*encoded);
+  return size < 0 ? -static_cast<uint64_t>(size) : static_cast<uint64_t>(size);
+}
+
+mpz_class decodeInteger(const uint64_t*& encoded) {
+  const bool negative = static_cast<int64_t>(*encoded) < 0;
+  const size_t size = integerSize(encoded++);
+  mpz_class ret;
+  if (size != 0) {
+    mpz_import(ret.get_mpz_t(), size, -1, sizeof(uint64_t), 0, 0, encoded);
+    if (negative)
+      mpz_neg(ret.get_mpz_t(), ret.get_mpz_t());
+    encoded += size;
+  }
+  return ret;
+}
+
+// Advance encoded over an integer encoded with encodeInteger() and return
+// its sign; throw if the integer does not end before end.
+int checkInteger(const uint64_t*& encoded, const uint64_t* end) {
+  CHECK_ARGUMENT(encoded < end, "library is corrupt: integer is truncated");
+  const int sign = static_cast<int64_t>(*encoded) < 0 ? -1 : *encoded == 0 ? 0 : 1;
+  const size_t size = integerSize(encoded++);
+  CHECK_ARGUMENT(size <= static_cast<size_t>(end - encoded), "library is corrupt: integer is truncated");
+  encoded += size;
+  return sign;
+}
+
+void writeWords(std::ofstream& out, const std::string& path, const std::vector<uint64_t>& words) {
+  out.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint64_t));
+  if (!out)
+    throw std::system_error(errno, std::generic_category(), "cannot write " + path);
+}
+
+}  // namespace
+
+MappedFile::MappedFile(const std::string& path) :
+  begin(nullptr),
+  bytes(0) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1)
+    throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+
+  struct stat status;
+  if (::fstat(fd, &status) == -1) {
+    const int error = errno;
+    ::close(fd);
+    throw std::system_error(error, std::generic_category(), "cannot stat " + path);
+  }
+
+  if (status.st_size) {
+    void* mapped = ::mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    const int error = errno;
+    // The mapping remains valid after the file descriptor has been closed.
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+      throw std::system_error(error, std::generic_category(), "cannot map " + path);
+    begin = mapped;
+    bytes = status.st_size;
+  } else {
+    ::close(fd);
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (bytes)
+    ::munmap(begin, bytes);
+}
+
+const uint64_t* MappedFile::data() const {
+  return static_cast<const uint64_t*>(begin);
+}
+
+size_t MappedFile::size() const {
+  return bytes / sizeof(uint64_t);
+}
+
+template <typename T>
+FlatTriangulationLibrary<T>::FlatTriangulationLibrary(const std::string& path) :
+  self(spimpl::make_impl<ImplementationOf<FlatTriangulationLibrary>>(path)) {}
+
+template <typename T>
+void FlatTriangulationLibrary<T>::write(const std::string& path, const std::vector<FlatTriangulation<T>>& surfaces) {
+  using Implementation = ImplementationOf<FlatTriangulationLibrary>;
+
+  std::vector<uint64_t> header(Implementation::HEADER_SIZE);
+  header[Implementation::MAGIC] = Implementation::magic;
+  header[Implementation::VERSION] = Implementation::version;
+  header[Implementation::BYTE_ORDER] = Implementation::byteOrder;
+  header[Implementation::WORD_SIZE] = sizeof(uint64_t);
+  header[Implementation::COORDINATE] = Implementation::coordinate();
+  header[Implementation::SURFACES] = surfaces.size();
+
+  // The offsets of the surface records, filled in as we write the records.
+  std::vector<uint64_t> offsets(surfaces.size() + 1);
+
+  std::vector<uint64_t> field;
+  if constexpr (std::is_same_v<T, eantic::renf_elem_class>) {
+    // Determine the number field all the coordinates live in. Coordinates
+    // that are rational might have been created without a number field, so
+    // we ignore their parent.
+    boost::intrusive_ptr<const eantic::renf_class> K;
+    for (const auto& surface : surfaces) {
+      for (auto edge : surface.edges()) {
+        const auto v = surface.fromHalfEdge(edge.positive());
+        for (const auto& x : {v.x(), v.y()}) {
+          if (x.is_rational())
+            continue;
+          if (!K)
+            K = &x.parent();
+          CHECK_ARGUMENT(x.parent() == *K, "all surfaces in a library must be defined over the same number field");
+        }
+      }
+    }
+
+    if (K) {
+      const auto [minpoly, name, embedding, precision] = K->construction();
+      field.push_back(1);
+      field.push_back(precision);
+      encodeString(field, minpoly);
+      encodeString(field, name);
+      encodeString(field, embedding);
+    } else {
+      field.push_back(0);
+    }
+  } else {
+    field.push_back(0);
+  }
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out)
+    throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+
+  writeWords(out, path, header);
+  // We write the offsets again once all the records have been written.
+  writeWords(out, path, offsets);
+  writeWords(out, path, field);
+
+  size_t position = header.size() + offsets.size() + field.size();
+
+  for (size_t i = 0; i < surfaces.size(); i++) {
+    const auto& surface = surfaces[i];
+    const size_t edges = surface.edges().size();
+
+    offsets[i] = position;
+
+    std::vector<uint64_t> record;
+    record.push_back(edges);
+
+    std::vector<int32_t> permutations(4 * edges);
+    for (auto halfEdge : surface.halfEdges()) {
+      permutations[halfEdge.index()] = surface.nextAtVertex(halfEdge).id();
+      permutations[2 * edges + halfEdge.index()] = surface.nextInFace(halfEdge).id();
+    }
+    record.resize(record.size() + words(permutations.size() * sizeof(int32_t)));
+    std::memcpy(record.data() + 1, permutations.data(), permutations.size() * sizeof(int32_t));
+
+    const size_t vectors = record.size();
+    record.resize(vectors + edges + 1);
+    for (auto edge : surface.edges()) {
+      record[vectors + edge.index()] = record.size();
+      const auto v = surface.fromHalfEdge(edge.positive());
+      Implementation::encode(record, v.x());
+      Implementation::encode(record, v.y());
+    }
+    record[vectors + edges] = record.size();
+
+    writeWords(out, path, record);
+    position += record.size();
+  }
+
+  offsets[surfaces.size()] = position;
+
+  out.seekp(header.size() * sizeof(uint64_t));
+  writeWords(out, path, offsets);
+}
+
+template <typename T>
+size_t FlatTriangulationLibrary<T>::size() const {
+  return self->surfaces;
+}
+
+template <typename T>
+FlatTriangulationView<T> FlatTriangulationLibrary<T>::operator[](size_t i) const {
+  CHECK_ARGUMENT(i < size(), "library has only " << size() << " surfaces");
+  return ImplementationOf<FlatTriangulationView<T>>::make(self->file, self->field, self->file->data() + self->offsets[i], self->file->data() + self->offsets[i + 1]);
+}
+
+template <typename T>
+ImplementationOf<FlatTriangulationLibrary<T>>::ImplementationOf(const std::string& path) :
+  file(std::make_shared<const MappedFile>(path)) {
+  const uint64_t* header = file->data();
+
+  CHECK_ARGUMENT(file->size() >= HEADER_SIZE && header[MAGIC] == magic, path << " is not a library of flat triangulations");
+  CHECK_ARGUMENT(header[VERSION] == version, path << " has unsupported version " << header[VERSION]);
+  CHECK_ARGUMENT(header[BYTE_ORDER] == byteOrder && header[WORD_SIZE] == sizeof(uint64_t), path << " was written on an incompatible platform");
+  CHECK_ARGUMENT(header[COORDINATE] == coordinate(), path << " does not contain surfaces with this coordinate type");
+
+  surfaces = header[SURFACES];
+  CHECK_ARGUMENT(surfaces < file->size() - HEADER_SIZE, path << " is truncated");
+
+  // Make sure that every record lies inside the mapped file after the
+  // offsets and that records do not overlap. The contents of a record are
+  // checked when a view of it is created.
+  offsets = header + HEADER_SIZE;
+  CHECK_ARGUMENT(offsets[0] > HEADER_SIZE + surfaces + 1, path << " is corrupt: record 0 starts inside the header");
+  for (size_t i = 0; i < surfaces; i++)
+    CHECK_ARGUMENT(offsets[i] < offsets[i + 1], path << " is corrupt: offset of record " << i + 1 << " is not after the offset of record " << i);
+  CHECK_ARGUMENT(offsets[surfaces] <= file->size(), path << " is truncated");
+
+  const uint64_t* encoded = offsets + surfaces + 1;
+  const uint64_t* end = header + offsets[0];
+  if (*encoded++) {
+    CHECK_ARGUMENT(encoded < end, path << " is corrupt: number field is truncated");
+    const slong precision = static_cast<slong>(*encoded++);
+    const auto minpoly = decodeString(encoded, end);
+    const auto name = decodeString(encoded, end);
+    const auto embedding = decodeString(encoded, end);
+    field = eantic::renf_class::make(minpoly, name, embedding, precision);
+  }
+}
+
+template <typename T>
+constexpr uint64_t ImplementationOf<FlatTriangulationLibrary<T>>::coordinate() {
+  if constexpr (std::is_same_v<T, long long>) {
+    return 1;
+  } else if constexpr (std::is_same_v<T, mpz_class>) {
+    return 2;
+  } else if constexpr (std::is_same_v<T, mpq_class>) {
+    return 3;
+  } else if constexpr (std::is_same_v<T, eantic::renf_elem_class>) {
+    return 4;
+  } else {
+    static_assert(false_type_v<T>, "libraries are not implemented for this coordinate type");
+  }
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulationLibrary<T>>::encode(std::vector<uint64_t>& encoded, const T& x) {
+  if constexpr (std::is_same_v<T, long long>) {
+    encoded.push_back(static_cast<uint64_t>(x));
+  } else if constexpr (std::is_same_v<T, mpz_class>) {
+    encodeInteger(encoded, x);
+  } else if constexpr (std::is_same_v<T, mpq_class>) {
+    encodeInteger(encoded, x.get_num());
+    encodeInteger(encoded, x.get_den());
+  } else if constexpr (std::is_same_v<T, eantic::renf_elem_class>) {
+    if (x.is_rational()) {
+      const mpq_class q = static_cast<mpq_class>(x);
+      encoded.push_back(1);
+      encodeInteger(encoded, q.get_num());
+      encodeInteger(encoded, q.get_den());
+    } else {
+      const auto coefficients = x.num_vector();
+      encoded.push_back(coefficients.size());
+      for (const auto& coefficient : coefficients)
+        encodeInteger(encoded, coefficient);
+      encodeInteger(encoded, x.den());
+    }
+  } else {
+    static_assert(false_type_v<T>, "libraries are not implemented for this coordinate type");
+  }
+}
+
+template <typename T>
+T ImplementationOf<FlatTriangulationLibrary<T>>::decode(const uint64_t*& encoded, const boost::intrusive_ptr<const eantic::renf_class>& field) {
+  if constexpr (std::is_same_v<T, long long>) {
+    return static_cast<long long>(*encoded++);
+  } else if constexpr (std::is_same_v<T, mpz_class>) {
+    return decodeInteger(encoded);
+  } else if constexpr (std::is_same_v<T, mpq_class>) {
+    const mpz_class num = decodeInteger(encoded);
+    const mpz_class den = decodeInteger(encoded);
+    return mpq_class(num, den);
+  } else if constexpr (std::is_same_v<T, eantic::renf_elem_class>) {
+    const size_t degree = *encoded++;
+    std::vector<mpz_class> coefficients;
+    coefficients.reserve(degree);
+    for (size_t i = 0; i < degree; i++)
+      coefficients.push_back(decodeInteger(encoded));
+    const mpz_class den = decodeInteger(encoded);
+
+    if (degree == 1) {
+      const mpq_class q(coefficients[0], den);
+      return field ? T(*field, q) : T(q);
+    }
+
+    return T(*field, coefficients) / den;
+  } else {
+    static_assert(false_type_v<T>, "libraries are not implemented for this coordinate type");
+  }
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulationLibrary<T>>::check(const uint64_t*& encoded, const uint64_t* end, const boost::intrusive_ptr<const eantic::renf_class>& field) {
+  if constexpr (std::is_same_v<T, long long>) {
+    CHECK_ARGUMENT(encoded < end, "library is corrupt: coordinate is truncated");
+    encoded++;
+  } else if constexpr (std::is_same_v<T, mpz_class>) {
+    checkInteger(encoded, end);
+  } else if constexpr (std::is_same_v<T, mpq_class>) {
+    checkInteger(encoded, end);
+    CHECK_ARGUMENT(checkInteger(encoded, end) > 0, "library is corrupt: denominator must be positive");
+  } else if constexpr (std::is_same_v<T, eantic::renf_elem_class>) {
+    CHECK_ARGUMENT(encoded < end, "library is corrupt: coordinate is truncated");
+    const uint64_t degree = *encoded++;
+    CHECK_ARGUMENT(degree == 1 || (field && degree >= 1 && degree <= static_cast<uint64_t>(field->degree())), "library is corrupt: number field element has " << degree << " coefficients");
+    for (uint64_t i = 0; i < degree; i++)
+      checkInteger(encoded, end);
+    CHECK_ARGUMENT(checkInteger(encoded, end) > 0, "library is corrupt: denominator must be positive");
+  } else {
+    static_assert(false_type_v<T>, "libraries are not implemented for this coordinate type");
+  }
+}
+
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const FlatTriangulationLibrary<T>& self) {
+  return os << "FlatTriangulationLibrary with " << self.size() << " surfaces";
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), FlatTriangulationLibrary, (long long)(mpz_class)(mpq_class)(eantic::renf_elem_class))
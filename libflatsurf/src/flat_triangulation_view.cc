@@ -0,0 +1,143 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/flat_triangulation_view.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flat_triangulation_combinatorial.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/permutation.hpp"
+#include "../flatsurf/vector.hpp"
+#include "impl/flat_triangulation_library.impl.hpp"
+#include "impl/flat_triangulation_view.impl.hpp"
+#include "util/assert.ipp"
+
+namespace flatsurf {
+
+template <typename T>
+std::vector<HalfEdge> FlatTriangulationView<T>::halfEdges() const {
+  std::vector<HalfEdge> halfEdges;
+  for (size_t i = 0; i < 2 * self->edges; i++)
+    halfEdges.push_back(HalfEdge::fromIndex(i));
+  return halfEdges;
+}
+
+template <typename T>
+HalfEdge FlatTriangulationView<T>::nextAtVertex(HalfEdge halfEdge) const {
+  return HalfEdge(self->vertices[self->index(halfEdge)]);
+}
+
+template <typename T>
+HalfEdge FlatTriangulationView<T>::nextInFace(HalfEdge halfEdge) const {
+  return HalfEdge(self->faces[self->index(halfEdge)]);
+}
+
+template <typename T>
+Vector<T> FlatTriangulationView<T>::fromHalfEdge(HalfEdge halfEdge) const {
+  self->index(halfEdge);
+
+  const uint64_t* encoded = self->record + self->vectors[halfEdge.edge().index()];
+  auto x = ImplementationOf<FlatTriangulationLibrary<T>>::decode(encoded, self->field);
+  auto y = ImplementationOf<FlatTriangulationLibrary<T>>::decode(encoded, self->field);
+
+  const Vector<T> v(std::move(x), std::move(y));
+  return halfEdge == halfEdge.edge().positive() ? v : -v;
+}
+
+template <typename T>
+FlatTriangulation<T> FlatTriangulationView<T>::surface() const {
+  std::vector<std::pair<HalfEdge, HalfEdge>> vertices;
+  for (auto halfEdge : halfEdges())
+    vertices.push_back(std::pair(halfEdge, nextAtVertex(halfEdge)));
+
+  std::vector<Vector<T>> vectors;
+  for (size_t i = 0; i < self->edges; i++)
+    vectors.push_back(fromHalfEdge(HalfEdge::fromIndex(2 * i)));
+
+  return FlatTriangulation<T>(FlatTriangulationCombinatorial(Permutation<HalfEdge>(vertices)), vectors);
+}
+
+template <typename T>
+ImplementationOf<FlatTriangulationView<T>>::ImplementationOf(std::shared_ptr<const MappedFile> file, boost::intrusive_ptr<const eantic::renf_class> field, const uint64_t* record, const uint64_t* end) :
+  file(std::move(file)),
+  field(std::move(field)),
+  record(record) {
+  const size_t size = static_cast<size_t>(end - record);
+
+  // The number of edges, 2 × 2n half edge ids, and n + 1 offsets.
+  CHECK_ARGUMENT(size >= 2, "surface record is corrupt: record is truncated");
+  edges = record[0];
+  CHECK_ARGUMENT(edges <= (size - 2) / 3 && edges <= static_cast<size_t>(std::numeric_limits<int32_t>::max()), "surface record is corrupt: too many edges");
+
+  vertices = reinterpret_cast<const int32_t*>(record + 1);
+  faces = vertices + 2 * edges;
+  vectors = record + 1 + 2 * edges;
+
+  for (const auto* permutation : {vertices, faces}) {
+    std::vector<bool> image(2 * edges);
+    for (size_t i = 0; i < 2 * edges; i++) {
+      const int32_t id = permutation[i];
+      CHECK_ARGUMENT(id != 0 && static_cast<size_t>(std::abs(static_cast<int64_t>(id))) <= edges, "surface record is corrupt: " << id << " is not a half edge of this surface");
+      const size_t index = HalfEdge(id).index();
+      CHECK_ARGUMENT(!image[index], "surface record is corrupt: half edges do not form a permutation");
+      image[index] = true;
+    }
+  }
+
+  CHECK_ARGUMENT(vectors[0] == 1 + 3 * edges + 1, "surface record is corrupt: vectors do not follow the offsets");
+  CHECK_ARGUMENT(vectors[edges] == size, "surface record is corrupt: vectors do not end with the record");
+  for (size_t i = 0; i < edges; i++) {
+    CHECK_ARGUMENT(vectors[i] < vectors[i + 1] && vectors[i + 1] <= size, "surface record is corrupt: offset of vector " << i + 1 << " is not after the offset of vector " << i);
+    const uint64_t* encoded = record + vectors[i];
+    ImplementationOf<FlatTriangulationLibrary<T>>::check(encoded, record + vectors[i + 1], this->field);
+    ImplementationOf<FlatTriangulationLibrary<T>>::check(encoded, record + vectors[i + 1], this->field);
+    CHECK_ARGUMENT(encoded == record + vectors[i + 1], "surface record is corrupt: vector " << i << " has trailing data");
+  }
+}
+
+template <typename T>
+FlatTriangulationView<T> ImplementationOf<FlatTriangulationView<T>>::make(std::shared_ptr<const MappedFile> file, boost::intrusive_ptr<const eantic::renf_class> field, const uint64_t* record, const uint64_t* end) {
+  return FlatTriangulationView<T>(PrivateConstructor{}, std::move(file), std::move(field), record, end);
+}
+
+template <typename T>
+size_t ImplementationOf<FlatTriangulationView<T>>::index(HalfEdge halfEdge) const {
+  const size_t index = halfEdge.index();
+  CHECK_ARGUMENT(index < 2 * edges, "half edge " << halfEdge << " is not in this surface");
+  return index;
+}
+
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const FlatTriangulationView<T>& self) {
+  return os << self.surface();
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), FlatTriangulationView, (long long)(mpz_class)(mpq_class)(eantic::renf_elem_class))
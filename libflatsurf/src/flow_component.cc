@@ -44,6 +44,8 @@
 #include "impl/flow_triangulation.impl.hpp"
 #include "impl/saddle_connection.impl.hpp"
 #include "util/assert.ipp"
+#include "util/statistics.ipp"
+#include "util/tracing.ipp"
 
 namespace flatsurf {
 
@@ -58,7 +60,12 @@ bool FlowComponent<Surface>::decompose(std::function<bool(const FlowComponent<Su
   };
 
   while (!target(*this)) {
-    auto step = self->component->dynamicalComponent.decompositionStep(limit);
+    LIBFLATSURF_COUNT(DECOMPOSITION_STEPS);
+
+    auto step = [&]() {
+      LIBFLATSURF_TRACE("decompositionStep", "surface", vertical().surface(), "direction", vertical().vertical(), "limit", limit);
+      return self->component->dynamicalComponent.decompositionStep(limit);
+    }();
 
     if (step.result == intervalxt::DecompositionStep::Result::LIMIT_REACHED) {
       ASSERTIONS(check);
@@ -66,6 +73,8 @@ bool FlowComponent<Surface>::decompose(std::function<bool(const FlowComponent<Su
     }
 
     if (step.equivalent) {
+      LIBFLATSURF_TRACE("reconstructConnection", "surface", vertical().surface(), "direction", vertical().vertical());
+
       // We found a SaddleConnection in intervalxt. step.equivalent contains a
       // sequence of known FlowConnections that sum up to that new
       // SaddleConnection. We now construct that new SaddleConnection by
@@ -76,8 +85,18 @@ bool FlowComponent<Surface>::decompose(std::function<bool(const FlowComponent<Su
 
       // Reconstruct the vector of our new SaddleConnection.
       Chain<FlatTriangulation<T>> vector(surface);
+
+      // The first SaddleConnection of step.equivalent. The new
+      // SaddleConnection must start clockwise from that one.
+      std::optional<HalfEdge> clockwiseFrom;
+      // The negative of the last SaddleConnection of step.equivalent.
+      // The negative of the new SaddleConnection must start counterclockwise
+      // from that one.
+      std::optional<HalfEdge> counterclockwiseTo;
+
       for (const auto& connection : *step.equivalent) {
         auto flowConnection = ImplementationOf<FlowConnection<Surface>>::make(self->state, *this, connection);
+        const auto& saddleConnection = flowConnection.saddleConnection();
         if (!flowConnection.vertical()) {
           // Since the default for ::make() is to assume that things were made
           // for walking the contour counterclockwise, a HalfEdge on the top is
@@ -86,153 +105,25 @@ bool FlowComponent<Surface>::decompose(std::function<bool(const FlowComponent<Su
           // step.equivalent clockwise. intervalxt should probably report
           // things more consistently, i.e., non-verticals with an explicit
           // orientation so we do not need this switch anymore.
-          vector -= flowConnection.saddleConnection();
+          vector -= saddleConnection;
+          if (!clockwiseFrom) clockwiseFrom = saddleConnection.target();
+          counterclockwiseTo = saddleConnection.source();
         } else {
-          vector += flowConnection.saddleConnection();
+          vector += saddleConnection;
+          if (!clockwiseFrom) clockwiseFrom = saddleConnection.source();
+          counterclockwiseTo = saddleConnection.target();
         }
       }
 
-      ASSERT(vector, "SaddleConnection must not be the zero vector");
-      ASSERT(vertical().ccw(vector) == CCW::COLLINEAR, "SaddleConnection must be vertical");
-      ASSERT(vertical().orientation(vector) == ORIENTATION::SAME, "SaddleConnection must be parallel but " << vector << " is antiparallel.");
+      ASSERT(clockwiseFrom && counterclockwiseTo, "step.equivalent cannot be empty");
 
-      // The first SaddleConnection of step.equivalent. The new
-      // SaddleConnection must start clockwise from that one.
-      auto clockwiseFrom = [&]() {
-        const auto precedingFlowConnection = ImplementationOf<FlowConnection<Surface>>::make(self->state, *this, *begin(*step.equivalent));
-        // Similarly, to the above, we need to turn a connection coming from a HalfEdge around.
-        return precedingFlowConnection.vertical() ? precedingFlowConnection.saddleConnection() : -precedingFlowConnection.saddleConnection();
-      }();
-
-      // The negative of the last SaddleConnection of step.equivalent.
-      // The negative of the new SaddleConnection must start counterclockwise
-      // from that one.
-      auto counterclockwiseTo = [&]() {
-        const auto finalFlowConnection = ImplementationOf<FlowConnection<Surface>>::make(self->state, *this, *rbegin(*step.equivalent));
-        // Similarly, to the above, we need to turn a connection coming from a HalfEdge around.
-        return finalFlowConnection.vertical() ? -finalFlowConnection.saddleConnection() : finalFlowConnection.saddleConnection();
-      }();
-
-      ASSERT(clockwiseFrom.vector().ccw(vector) != CCW::COUNTERCLOCKWISE, "Vertical must be clockwise from the half edge direction");
-
-      enum SECTOR {
-        NORTH,
-        NORTH_WEST,
-        WEST,
-        SOUTH_WEST,
-        SOUTH,
-        SOUTH_EAST,
-        EAST,
-        NORTH_EAST,
-      };
-
-      const auto classify = [](const auto& vertical, const auto& vector) {
-        switch (vertical.ccw(vector)) {
-          case CCW::COUNTERCLOCKWISE:
-            switch (vertical.orientation(vector)) {
-              case ORIENTATION::OPPOSITE:
-                return SOUTH_WEST;
-              case ORIENTATION::SAME:
-                return NORTH_WEST;
-              default:
-                return WEST;
-            }
-          case CCW::CLOCKWISE:
-            switch (vertical.orientation(vector)) {
-              case ORIENTATION::OPPOSITE:
-                return SOUTH_EAST;
-              case ORIENTATION::SAME:
-                return NORTH_EAST;
-              default:
-                return EAST;
-            }
-          default:
-            switch (vertical.orientation(vector)) {
-              case ORIENTATION::OPPOSITE:
-                return SOUTH;
-              case ORIENTATION::SAME:
-                return NORTH;
-              default:
-                UNREACHABLE("cannot classify zero vector");
-            }
-        }
-      };
-
-      // The following logic should probably be abstracted away into SaddleConnection somehow.
-
-      // The source of the new SaddleConnection, i.e.,
-      // counterclockwise to which HalfEdge of the original surface
-      // SaddleConnection starts (inclusive.)
-      const auto source = [&]() {
-        auto ret = clockwiseFrom.source();
-
-        while (true) {
-          switch (classify(vertical(), surface->fromHalfEdge(ret))) {
-            case NORTH:
-            case NORTH_EAST:
-            case EAST:
-            case SOUTH_EAST:
-              break;
-            default:
-              ret = surface->previousAtVertex(ret);
-              continue;
-          }
-          break;
-        }
-
-        ASSERT(surface->inSector(ret, vector), "We determined that the new SaddleConnection " << vector << " must start in the sector counterclockwise from " << ret << " but that vector is not in the sector.");
-
-        return ret;
-      }();
-
-      // The target of the new SaddleConnection, i.e.,
-      // counterclockwise to which HalfEdge of the original surface
-      // -SaddleConnection starts (inclusive.)
-      auto target = [&]() {
-        auto ret = counterclockwiseTo.source();
-
-        while (true) {
-          switch (classify(vertical(), surface->fromHalfEdge(ret))) {
-            case NORTH_WEST:
-            case WEST:
-            case SOUTH_WEST:
-              break;
-            default:
-              ret = surface->nextAtVertex(ret);
-              continue;
-          }
-          break;
-        }
-
-        while (true) {
-          switch (classify(vertical(), surface->fromHalfEdge(ret))) {
-            case SOUTH_EAST:
-            case EAST:
-            case NORTH_EAST:
-              break;
-            default:
-              ret = surface->nextAtVertex(ret);
-              continue;
-          }
-          break;
-        }
-
-        ret = surface->previousAtVertex(ret);
-
-        ASSERT(surface->inSector(ret, -vector), "We determined that the new SaddleConnection " << vector << " must end in the sector counterclockwise from " << ret << " but the negative of that vector is not in the sector.");
-
-        return ret;
-      }();
-
-      const auto connection = SaddleConnection<FlatTriangulation<T>>(surface, source, target, vector);
+      // Build the SaddleConnection directly from these endpoints; the
+      // sectors are determined by walking around the vertices.
+      const auto connection = ImplementationOf<SaddleConnection<FlatTriangulation<T>>>::make(vertical(), *clockwiseFrom, *counterclockwiseTo, std::move(vector));
 
       ASSERT(vertical().ccw(connection) == CCW::COLLINEAR, "Detected connection must be vertical but " << connection << " is not.");
       ASSERT(vertical().orientation(connection) == ORIENTATION::SAME, " Detected connection is parallel but " << connection << " is antiparallel.");
 
-      ASSERT(connection.source() == source && connection.target() == target, "SaddleConnection normalization was unhappy with our source()/target() but we had picked them so they would be correct.");
-
-      ASSERT(clockwiseFrom.vector().ccw(connection) == CCW::CLOCKWISE || (clockwiseFrom.vector().ccw(connection) == CCW::COLLINEAR && clockwiseFrom.vector().orientation(connection) == ORIENTATION::OPPOSITE), "Detected SaddleConnection must be reachable clockwise from the existing contour but " << connection << " is not clockwise from " << clockwiseFrom);
-
       self->state->detectedConnections.emplace(*step.connection, connection);
       self->state->detectedConnections.emplace(-*step.connection, -connection);
     }
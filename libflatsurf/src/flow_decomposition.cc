@@ -58,7 +58,9 @@
 #include "impl/flow_decomposition.impl.hpp"
 #include "impl/flow_decomposition_state.hpp"
 #include "impl/interval_exchange_transformation.impl.hpp"
+#include "impl/vertical.impl.hpp"
 #include "util/assert.ipp"
+#include "util/memory.ipp"
 
 using std::ostream;
 
@@ -71,7 +73,7 @@ FlowDecomposition<Surface>::FlowDecomposition(Surface&& surface, const Vector<T>
   self(spimpl::make_unique_impl<ImplementationOf<FlowDecomposition>>(std::move(surface), vertical)) {
   ASSERTIONS(([&]() {
     auto paths = components() | rx::transform([](const auto& component) { return Path(component.perimeter() | rx::transform([](const auto& connection) { return connection.saddleConnection(); }) | rx::to_vector()); }) | rx::to_vector();
-    ImplementationOf<ContourDecomposition<Surface>>::check(paths, Vertical(this->surface(), vertical));
+    ImplementationOf<ContourDecomposition<Surface>>::check(paths, ImplementationOf<Vertical<Surface>>::view(this->surface(), vertical));
   }));
 }
 
@@ -80,6 +82,23 @@ const Surface& FlowDecomposition<Surface>::surface() const {
   return self->state->contourDecomposition.collapsed().uncollapsed();
 }
 
+template <typename Surface>
+MemoryUsage FlowDecomposition<Surface>::memoryUsage() const {
+  const auto& state = *self->state;
+
+  auto usage = surface().memoryUsage();
+  usage += state.contourDecomposition.collapsed().memoryUsage();
+
+  // We do not look into the components of intervalxt, only into the saddle
+  // connections that we record for them.
+  usage.decomposition += sizeof(state) + allocatedNodes(state.components) + allocatedNodes(state.injectedConnections) + allocatedNodes(state.detectedConnections);
+  for (const auto* connections : {&state.injectedConnections, &state.detectedConnections})
+    for (const auto& [_, connection] : *connections)
+      usage += connection.memoryUsage();
+
+  return usage;
+}
+
 template <typename Surface>
 bool FlowDecomposition<Surface>::decompose(std::function<bool(const FlowComponent<Surface>&)> target, int limit) {
   bool targetReached = true;
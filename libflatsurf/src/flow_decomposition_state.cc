@@ -22,16 +22,20 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <exact-real/arb.hpp>
 #include <intervalxt/dynamical_decomposition.hpp>
 #include <intervalxt/interval_exchange_transformation.hpp>
 #include <intervalxt/label.hpp>
 #include <ostream>
 #include <unordered_map>
+#include <vector>
 
 #include "../flatsurf/ccw.hpp"
+#include "../flatsurf/chain.hpp"
 #include "../flatsurf/contour_component.hpp"
 #include "../flatsurf/contour_connection.hpp"
 #include "../flatsurf/contour_decomposition.hpp"
+#include "../flatsurf/flat_triangulation_collapsed.hpp"
 #include "../flatsurf/flow_component.hpp"
 #include "../flatsurf/flow_connection.hpp"
 #include "../flatsurf/interval_exchange_transformation.hpp"
@@ -44,6 +48,8 @@
 #include "impl/interval_exchange_transformation.impl.hpp"
 #include "util/assert.ipp"
 #include "util/instantiate.ipp"
+#include "util/parallel.ipp"
+#include "util/tracing.ipp"
 
 namespace flatsurf {
 
@@ -53,19 +59,58 @@ FlowDecompositionState<Surface>::FlowDecompositionState(Surface&& surface, const
 
 template <typename Surface>
 std::shared_ptr<FlowDecompositionState<Surface>> FlowDecompositionState<Surface>::make(Surface&& surface, const Vector<T>& direction) {
+  LIBFLATSURF_TRACE("FlowDecomposition", "surface", surface, "direction", direction);
+
   auto self = std::shared_ptr<FlowDecompositionState>(new FlowDecompositionState(std::move(surface), direction));
 
-  for (auto& contour : self->contourDecomposition.components()) {
-    auto iet = std::make_shared<IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>>(ImplementationOf<IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>>::make(contour.intervalExchangeTransformation(), self));
+  const auto contours = self->contourDecomposition.components();
+
+  // The interval exchange transformations of the contour components and
+  // their dynamical decompositions are independent of each other so we build
+  // them in parallel. Every task computes its own contours and registers its
+  // Verticals in the registry of its thread; the only shared state it
+  // modifies are the connections to the change signals of the surfaces which
+  // are guarded by a lock. The results are collected per contour so that the
+  // order of the components does not depend on the scheduling.
+  std::vector<std::vector<FlowComponentState<Surface>>> built(contours.size());
+
+  const auto build = [&](size_t i) {
+    LIBFLATSURF_TRACE("IntervalExchangeTransformation", "surface", self->contourDecomposition.collapsed().uncollapsed(), "direction", direction, "component", i);
+
+    auto iet = std::make_shared<IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>>(ImplementationOf<IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>>::make(contours[i].intervalExchangeTransformation(), self));
 
     auto decomposition = intervalxt::DynamicalDecomposition(iet->intervalExchangeTransformation());
     ASSERT(decomposition.components().size() == 1, "contour component must yield exactly one flow component initially");
     for (auto& component : decomposition.components()) {
-      self->components.push_back(FlowComponentState<Surface>{contour, iet, component});
+      built[i].push_back(FlowComponentState<Surface>{contours[i], iet, component});
     }
+  };
+
+  if constexpr (concurrent<T>) {
+    // Saddle connections compute their vectors lazily. Force them now so
+    // that the threads below only read from the collapsed surface.
+    const auto& collapsed = self->contourDecomposition.collapsed();
+    for (const auto halfEdge : collapsed.halfEdges()) {
+      const auto& chain = collapsed.fromHalfEdge(halfEdge).chain();
+      static_cast<void>(static_cast<const Vector<T>&>(chain));
+      static_cast<void>(static_cast<const Vector<exactreal::Arb>&>(chain));
+    }
+
+    parallel(contours.size(), build);
+  } else {
+    // Number field elements and exact reals refine shared state (the
+    // embedding of their field, the approximations of their basis) when
+    // they are compared, so we do not build their components in parallel.
+    for (size_t i = 0; i < contours.size(); i++)
+      build(i);
   }
 
+  for (auto& components : built)
+    for (auto& component : components)
+      self->components.push_back(std::move(component));
+
   // Inject collapsed verticals into intervalxt components.
+  LIBFLATSURF_TRACE("injectVerticals", "surface", self->contourDecomposition.collapsed().uncollapsed(), "direction", direction);
 
   std::unordered_map<SaddleConnection<Surface>, std::pair<intervalxt::Label, intervalxt::Label>> injectedConnections;
 
@@ -56,6 +56,10 @@ class ImplementationOf<Chain<Surface>> {
 
   std::optional<const mpz_class*> operator[](size_t) const;
 
+  // Return the squared length of this chain's vector computed from the
+  // coefficients with ball arithmetic at precision prec.
+  exactreal::Arb norm(slong prec) const;
+
   ReadOnly<Surface> surface;
 
   fmpz* coefficients;
@@ -20,6 +20,7 @@
 #ifndef LIBFLATSURF_CHAIN_VECTOR_IMPL_HPP
 #define LIBFLATSURF_CHAIN_VECTOR_IMPL_HPP
 
+#include <atomic>
 #include <deque>
 #include <optional>
 
@@ -31,6 +32,9 @@ namespace flatsurf {
 // that make up the chain; however, there are some optimizations to make this
 // more efficient than just always keeping an updated vector around in the
 // chain.
+// The conversion to Vector<T> is thread-safe, i.e., several threads can read
+// the vector of the same chain at the same time even though the vector is
+// computed lazily. Modifications of the chain need exclusive access.
 template <typename Surface, typename T>
 class ChainVector {
  public:
@@ -45,6 +49,12 @@ class ChainVector {
 
   void reset() const;
 
+  // Set the vector to value unless it is already up to date.
+  void fill(const Vector<T>& value) const;
+
+  // Return the bytes held by the cached vector and the pending moves.
+  size_t allocated() const;
+
   ChainVector& operator+=(const ChainVector<Surface, T>&);
   ChainVector& operator+=(ChainVector<Surface, T>&&);
 
@@ -76,6 +86,12 @@ class ChainVector {
   mutable double pendingMovesCost = 0;
   mutable std::deque<std::pair<MOVE, Vector<T>>> pendingMoves = {};
 
+  // Whether value is up to date, i.e., there are no pendingMoves. If this is
+  // set, value can be read without holding the lock on updating.
+  mutable std::atomic<bool> clean{false};
+  // Held while value and pendingMoves are brought up to date.
+  mutable std::atomic_flag updating = ATOMIC_FLAG_INIT;
+
   template <typename S, typename TT>
   friend class ChainVector;
 
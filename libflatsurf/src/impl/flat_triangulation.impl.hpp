@@ -21,7 +21,9 @@
 #define LIBFLATSURF_FLAT_TRIANGULATION_IMPL_HPP
 
 #include <memory>
+#include <optional>
 
+#include "../../flatsurf/edge_set.hpp"
 #include "../../flatsurf/flat_triangulation.hpp"
 #include "../../flatsurf/half_edge_map.hpp"
 #include "../../flatsurf/tracked.hpp"
@@ -37,17 +39,27 @@ class ImplementationOf<FlatTriangulation<T>> : protected ImplementationOf<Manage
   ImplementationOf(FlatTriangulationCombinatorial&&, const std::function<Vector<T>(HalfEdge)>&);
 
   static void updateAfterFlip(OddHalfEdgeMap<Vector<T>>&, const FlatTriangulationCombinatorial&, HalfEdge);
-  static void updateApproximationAfterFlip(OddHalfEdgeMap<Vector<exactreal::Arb>>&, const FlatTriangulationCombinatorial&, HalfEdge);
+  static void updateApproximationAfterFlip(OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>&, const FlatTriangulationCombinatorial&, HalfEdge);
 
   void check();
 
   static T area(const Vector<T>& a, const Vector<T>& b, const Vector<T>& c);
 
+  // Return the edges that are ignored by an isomorphism of this kind, i.e.,
+  // the edges which are AMBIGUOUS for isomorphisms of Delaunay cells.
+  static EdgeSet ignored(const FlatTriangulation<T>&, ISOMORPHISM);
+
   void flip(HalfEdge) override;
 
   const Tracked<OddHalfEdgeMap<Vector<T>>> vectors;
-  // A cache of approximations for improved performance
-  const Tracked<OddHalfEdgeMap<Vector<exactreal::Arb>>> approximations;
+  // A cache of approximations for improved performance. For number fields
+  // and exact reals, approximations are only computed when they are first
+  // requested, so that surfaces which are never queried for them, such as
+  // intermediate results of a deformation, do not pay for the expensive
+  // conversion of their coordinates. For the other coordinates, the
+  // conversion is cheap and approximations are computed eagerly so that
+  // they can be read from several threads without a lock.
+  mutable Tracked<OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>> approximations;
 
  protected:
   using ImplementationOf<ManagedMovable<FlatTriangulation<T>>>::from_this;
@@ -53,6 +53,9 @@ class ImplementationOf<FlatTriangulationCollapsed<T>> : protected Implementation
   virtual void flip(HalfEdge) override;
   virtual std::pair<HalfEdge, HalfEdge> collapse(HalfEdge) override;
 
+  // Collapse all the vertical edges of this surface.
+  void collapseVertical();
+
   ReadOnly<FlatTriangulation<T>> original;
 
   Vector<T> vertical;
@@ -72,6 +75,9 @@ class ImplementationOf<FlatTriangulationCollapsed<T>> : protected Implementation
   // Check that the face of this half edge is actually closed.
   bool faceClosed(HalfEdge);
 
+  // Check that every vertex of the original surface is still present.
+  void checkVertices();
+
   static void updateAfterFlip(HalfEdgeMap<SaddleConnection>&, const FlatTriangulationCombinatorial&, HalfEdge);
   static void updateBeforeCollapse(HalfEdgeMap<SaddleConnection>&, const FlatTriangulationCombinatorial&, Edge);
 
@@ -22,6 +22,7 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <variant>
 #include <vector>
 
@@ -72,12 +73,28 @@ class ImplementationOf<FlatTriangulationCombinatorial> : protected Implementatio
   // Sanity check this triangulation
   void check() const;
 
+  // Return the bytes held by the edges, vertices, and faces of this
+  // triangulation (not counting sizeof(*this).)
+  size_t allocated() const;
+
   virtual void flip(HalfEdge);
   virtual std::pair<HalfEdge, HalfEdge> collapse(HalfEdge);
 
+  // Collapse the given edge like collapse() but only update the faces; the
+  // vertices and the list of edges are not rebuilt. This is used to collapse
+  // many edges in a batch. Call resetAfterCollapse() after the last such
+  // collapse; until then, only face information can be used.
+  std::pair<HalfEdge, HalfEdge> collapseWithoutReset(HalfEdge);
+
+  // Rebuild vertices and edges after a sequence of collapseWithoutReset().
+  void resetAfterCollapse();
+
   // Connect to change event.
   static sigslot::connection connect(const ImplementationOf<FlatTriangulationCombinatorial>*, std::function<void(Message)>);
 
+  // Disconnect from change event, see connect().
+  static void disconnect(const ImplementationOf<FlatTriangulationCombinatorial>*, sigslot::connection&);
+
   std::vector<Edge> edges;
   Permutation<HalfEdge> vertices;
   Permutation<HalfEdge> faces;
@@ -86,7 +103,17 @@ class ImplementationOf<FlatTriangulationCombinatorial> : protected Implementatio
 
   mutable sigslot::signal_st<Message> change;
 
+  // Guards connecting to and disconnecting from change. Threads that query a
+  // shared surface create and destroy Tracked objects such as the caches of
+  // a Vertical, so the list of handlers changes concurrently. The signal is
+  // only emitted when the surface is modified which must not happen while
+  // other threads query it, so emitting does not need to lock.
+  mutable std::mutex connections;
+
  protected:
+  // Swap two half edges like swap() but do not rebuild the vertices.
+  void swapWithoutReset(HalfEdge a, HalfEdge b);
+
   template <typename... Args>
   static FlatTriangulationCombinatorial make(Args&&... args) { return FlatTriangulationCombinatorial(PrivateConstructor{}, std::forward<Args>(args)...); }
 
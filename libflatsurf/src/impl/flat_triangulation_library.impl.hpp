@@ -0,0 +1,118 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_FLAT_TRIANGULATION_LIBRARY_IMPL_HPP
+#define LIBFLATSURF_FLAT_TRIANGULATION_LIBRARY_IMPL_HPP
+
+#include <e-antic/renfxx.h>
+#include <gmpxx.h>
+
+#include <boost/intrusive_ptr.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../flatsurf/flat_triangulation_library.hpp"
+
+namespace flatsurf {
+
+// A file that is mapped read-only into memory for as long as this object
+// exists.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  // Return the contents of the file as 64-bit words.
+  const uint64_t* data() const;
+
+  // Return the number of 64-bit words in the file.
+  size_t size() const;
+
+ private:
+  void* begin;
+  size_t bytes;
+};
+
+// A library consists of 64-bit words in native byte order:
+// * A header of HEADER_SIZE words, see WORD below.
+// * The offsets of the surface records (size() + 1 words, the last offset
+//   marks the end of the last surface record.)
+// * The number field in which the coordinates live (if any) as its precision
+//   followed by the minimal polynomial, the name of the generator, and its
+//   embedding, each as a length and the (padded) characters.
+// * The surface records: the number of edges n, the images of the 2n half
+//   edges under nextAtVertex and nextInFace as 32-bit half edge ids, n + 1
+//   offsets of the encoded vectors relative to the start of the record, and
+//   the encoded vectors of the positive half edges.
+// An integer is encoded as its signed number of 64-bit words followed by the
+// words of its absolute value, least significant word first. A rational number is encoded as its numerator and its
+// denominator. A number field element is encoded as the number of its
+// coefficients, the coefficients of its numerator, and its denominator.
+template <typename T>
+class ImplementationOf<FlatTriangulationLibrary<T>> {
+ public:
+  ImplementationOf(const std::string& path);
+
+  // The positions of the entries in the header of a library.
+  enum WORD {
+    MAGIC = 0,
+    VERSION = 1,
+    BYTE_ORDER = 2,
+    WORD_SIZE = 3,
+    COORDINATE = 4,
+    SURFACES = 5,
+    HEADER_SIZE = 6,
+  };
+
+  static constexpr uint64_t magic = 0x666c617473757266ull;  // "flatsurf"
+  static constexpr uint64_t version = 2;
+  static constexpr uint64_t byteOrder = 0x0102030405060708ull;
+
+  // Return a number that identifies the type T in the header of a library.
+  static constexpr uint64_t coordinate();
+
+  // Append the encoding of x to the end of words.
+  static void encode(std::vector<uint64_t>& words, const T& x);
+
+  // Decode a coordinate from words and advance words to the end of its encoding.
+  static T decode(const uint64_t*& words, const boost::intrusive_ptr<const eantic::renf_class>& field);
+
+  // Advance words over an encoded coordinate like decode() but without
+  // decoding it; throw if the encoding is invalid or does not end before end.
+  static void check(const uint64_t*& words, const uint64_t* end, const boost::intrusive_ptr<const eantic::renf_class>& field);
+
+  // The memory mapped library.
+  std::shared_ptr<const MappedFile> file;
+
+  // The number field the coordinates live in, if any.
+  boost::intrusive_ptr<const eantic::renf_class> field;
+
+  // The number of surfaces in this library.
+  size_t surfaces;
+
+  // The offsets of the surface records in file.
+  const uint64_t* offsets;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,73 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_FLAT_TRIANGULATION_VIEW_IMPL_HPP
+#define LIBFLATSURF_FLAT_TRIANGULATION_VIEW_IMPL_HPP
+
+#include <e-antic/renfxx.h>
+
+#include <boost/intrusive_ptr.hpp>
+#include <memory>
+
+#include "../../flatsurf/flat_triangulation_view.hpp"
+#include "flat_triangulation_library.impl.hpp"
+
+namespace flatsurf {
+
+template <typename T>
+class ImplementationOf<FlatTriangulationView<T>> {
+ public:
+  // Create a view of the record that starts at record and ends before end.
+  // Since a library might be corrupt, this validates the entire record.
+  ImplementationOf(std::shared_ptr<const MappedFile> file, boost::intrusive_ptr<const eantic::renf_class> field, const uint64_t* record, const uint64_t* end);
+
+  static FlatTriangulationView<T> make(std::shared_ptr<const MappedFile> file, boost::intrusive_ptr<const eantic::renf_class> field, const uint64_t* record, const uint64_t* end);
+
+  // Return the position of this half edge in the arrays of this record.
+  size_t index(HalfEdge) const;
+
+  // The library this surface lives in, to keep the mapping alive.
+  std::shared_ptr<const MappedFile> file;
+
+  // The number field the coordinates live in, if any.
+  boost::intrusive_ptr<const eantic::renf_class> field;
+
+  // The start of the surface record in the mapped file.
+  const uint64_t* record;
+
+  // The number of edges of this surface.
+  size_t edges;
+
+  // The images of the half edges under nextAtVertex and nextInFace as half
+  // edge ids.
+  const int32_t* vertices;
+  const int32_t* faces;
+
+  // The offsets of the encoded vectors of the edges relative to record.
+  const uint64_t* vectors;
+};
+
+template <typename T>
+template <typename... Args>
+FlatTriangulationView<T>::FlatTriangulationView(PrivateConstructor, Args&&... args) :
+  self(spimpl::make_impl<ImplementationOf<FlatTriangulationView>>(std::forward<Args>(args)...)) {}
+
+}  // namespace flatsurf
+
+#endif
@@ -23,10 +23,12 @@
 #include <gmpxx.h>
 
 #include <deque>
+#include <intervalxt/connection.hpp>
 #include <intervalxt/label.hpp>
 #include <intervalxt/lengths.hpp>
 #include <iosfwd>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "../../flatsurf/edge.hpp"
@@ -59,13 +61,43 @@ class Lengths {
   ::intervalxt::Lengths only(const std::unordered_set<::intervalxt::Label>&) const;
   bool similar(::intervalxt::Label, ::intervalxt::Label, const ::intervalxt::Lengths&, ::intervalxt::Label, ::intervalxt::Label) const;
 
+  // Return the saddle connection currently described by this edge.
+  // The connection is reconstructed from its coefficients if it has been
+  // changed by a subtract since it was last requested.
+  const SaddleConnection<FlatTriangulation<T>>& connection(Edge) const;
+
   template <typename S>
   friend std::ostream& operator<<(std::ostream&, const Lengths<S>&);
 
  private:
+  // The state of a label during the induction.
+  // Only the length, i.e., the horizontal projection, of the connection is
+  // updated during each subtract. The connection itself is recorded as an
+  // integer combination of the connections that the labels had initially and
+  // of vertical connections. It is only turned into an actual
+  // SaddleConnection when it is requested.
+  struct Entry {
+    T length;
+
+    std::unordered_map<Edge, mpz_class> labels;
+    std::unordered_map<::intervalxt::Connection, mpz_class> verticals;
+
+    // Half edges at the vertices where the connection starts and ends. These
+    // are in the correct half plane but not necessarily in the correct
+    // sector; they are normalized when the connection is reconstructed.
+    HalfEdge source;
+    HalfEdge target;
+
+    mutable std::optional<SaddleConnection<FlatTriangulation<T>>> connection;
+  };
+
   intervalxt::Label toLabel(Edge) const;
   Edge fromLabel(intervalxt::Label) const;
 
+  // Return the vertical connection that has been registered for this
+  // connection in the flow decomposition.
+  const SaddleConnection<FlatTriangulation<T>>& connection(const ::intervalxt::Connection&) const;
+
   T length(intervalxt::Label) const;
   T length() const;
   // Return whether this label is the leftmost label on a top contour.
@@ -75,7 +107,9 @@ class Lengths {
 
   std::weak_ptr<FlowDecompositionState<FlatTriangulation<T>>> state;
   ReadOnly<Vertical<FlatTriangulation<T>>> vertical;
-  EdgeMap<std::optional<SaddleConnection<FlatTriangulation<T>>>> lengths;
+  // The connections of the labels when these lengths were created.
+  EdgeMap<std::optional<SaddleConnection<FlatTriangulation<T>>>> initial;
+  EdgeMap<std::optional<Entry>> lengths;
 
   std::deque<intervalxt::Label> stack;
   T sum;
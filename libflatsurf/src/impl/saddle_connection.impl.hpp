@@ -38,6 +38,14 @@ class ImplementationOf<SaddleConnection<Surface>> {
   ImplementationOf(const Surface&, HalfEdge source, HalfEdge target, const Chain<Surface>&);
   ImplementationOf(const Surface&, HalfEdge source, HalfEdge target, Chain<Surface>&&);
 
+  // Return the saddle connection given by the chain which must be parallel
+  // to the vertical. The connection starts at the source of clockwiseFrom
+  // (somewhere clockwise from it) and ends at the source of
+  // counterclockwiseTo (somewhere counterclockwise from it.)
+  // The actual sectors are determined by walking around these vertices, in
+  // particular, no search for saddle connections is performed.
+  static SaddleConnection make(const Vertical<Surface>&, HalfEdge clockwiseFrom, HalfEdge counterclockwiseTo, Chain<Surface>&&);
+
   ReadOnly<Surface> surface;
   HalfEdge source;
   HalfEdge target;
@@ -0,0 +1,51 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_EXPORT_IMPL_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_EXPORT_IMPL_HPP
+
+#include <vector>
+
+#include "../../flatsurf/saddle_connections_export.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+class ImplementationOf<SaddleConnectionsExport<Surface>> {
+ public:
+  ImplementationOf(const Surface&, bool chains);
+
+  // Export all the saddle connections of this range.
+  template <typename Connections>
+  void append(const Connections&);
+
+  void append(const SaddleConnection<Surface>&);
+
+  size_t edges;
+  bool exportChains;
+
+  std::vector<double> holonomies;
+  std::vector<int32_t> sources;
+  std::vector<int32_t> targets;
+  std::vector<int64_t> chains;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,62 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_READER_IMPL_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_READER_IMPL_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "../../flatsurf/saddle_connections_reader.hpp"
+#include "read_only.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+class ImplementationOf<SaddleConnectionsReader<Surface>> {
+ public:
+  ImplementationOf(const Surface&, std::istream&);
+
+  // Read exactly this many bytes from the stream into data.
+  // Return false if the stream ended before the first byte.
+  bool read(void* data, size_t bytes);
+
+  // Return whether id is the id of a half edge of the surface.
+  bool halfEdge(int32_t id) const;
+
+  ReadOnly<Surface> surface;
+  std::istream& is;
+  // The number of edges of the surface.
+  int64_t edges;
+  bool chains;
+
+  // Whether there is a current record.
+  bool valid = false;
+
+  // The current record.
+  HalfEdge source;
+  HalfEdge target;
+  double x;
+  double y;
+  std::vector<std::pair<Edge, int64_t>> chain;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,99 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_WRITER_IMPL_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_WRITER_IMPL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "../../flatsurf/saddle_connections_writer.hpp"
+
+namespace flatsurf {
+
+// A stream of saddle connections starts with a header consisting of MAGIC (8
+// bytes), the VERSION (4 bytes), and flags (4 bytes) where CHAINS is set when
+// the records contain chains. Each record consists of the ids of the source
+// and target half edge (4 bytes each), the approximate x and y coordinate of
+// the holonomy (8 bytes each), and, if CHAINS is set, the number of non-zero
+// coefficients of the chain (4 bytes) followed by that many pairs of an edge
+// id (4 bytes) and the coefficient (8 bytes.) All values are written in
+// native byte order without padding.
+struct SaddleConnectionsFormat {
+  static constexpr uint64_t MAGIC = 0x6e6e6f6373667374ull;
+  static constexpr uint32_t VERSION = 1;
+  static constexpr uint32_t CHAINS = 1;
+};
+
+template <typename Surface>
+class ImplementationOf<SaddleConnectionsWriter<Surface>> {
+ public:
+  ImplementationOf(std::ostream&, bool chains, bool background);
+  ~ImplementationOf();
+
+  // Append the record of this connection to the current chunk.
+  void append(const SaddleConnection<Surface>&);
+
+  // Hand the current chunk over to be written to the stream.
+  void submit();
+
+  // Wait until all submitted chunks have been written to the stream and
+  // flush the stream.
+  void flush();
+
+  // Write a chunk to the stream.
+  void write(const std::vector<char>&);
+
+  // The main loop of the background writer thread.
+  void run();
+
+  // Raise an error that happened in the background writer thread.
+  void rethrow();
+
+  // The size of a chunk at which it is handed over to the stream.
+  static constexpr size_t CHUNK = 1 << 20;
+
+  // The number of chunks that may be waiting for the background writer
+  // thread before we block.
+  static constexpr size_t PENDING = 4;
+
+  std::ostream& os;
+  bool chains;
+  size_t records = 0;
+
+  std::vector<char> chunk;
+
+  // The state shared with the background writer thread.
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<std::vector<char>> pending;
+  bool writing = false;
+  bool stopping = false;
+  std::exception_ptr error;
+  std::optional<std::thread> thread;
+};
+
+}  // namespace flatsurf
+
+#endif
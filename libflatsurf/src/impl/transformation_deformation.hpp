@@ -28,9 +28,12 @@ namespace flatsurf {
 template <typename Surface>
 class TransformationDeformation : ImplementationOf<Deformation<Surface>> {
  public:
-  TransformationDeformation(Surface&&, HalfEdgeMap<HalfEdge>&&);
+  // If relabeledCells is set, the AMBIGUOUS edges of the preimage do not
+  // correspond to the AMBIGUOUS edges of surface, e.g., because the Delaunay
+  // cells of the preimage have been retriangulated.
+  TransformationDeformation(Surface&&, HalfEdgeMap<HalfEdge>&&, bool relabeledCells = false);
 
-  static Deformation<Surface> make(Surface&&, HalfEdgeMap<HalfEdge>&&);
+  static Deformation<Surface> make(Surface&&, HalfEdgeMap<HalfEdge>&&, bool relabeledCells = false);
 
   std::optional<HalfEdge> operator()(HalfEdge) const override;
 
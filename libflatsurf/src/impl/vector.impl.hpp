@@ -33,6 +33,10 @@ class ImplementationOf<Vector<T>> {
 
   ImplementationOf(T&& x, T&& y);
 
+  // Return the bytes that this vector holds on the heap, including the
+  // storage of its coordinates.
+  static size_t allocated(const Vector<T>&);
+
   T x, y;
 };
 
@@ -21,12 +21,15 @@
 #define LIBFLATSURF_VERTICAL_IMPL_HPP
 
 #include <functional>
+#include <mutex>
+#include <variant>
 
 #include "../../flatsurf/vertical.hpp"
 #include "flat_triangulation.impl.hpp"
 #include "flat_triangulation_collapsed.impl.hpp"
 #include "managed_movable.impl.hpp"
 #include "read_only.hpp"
+#include "vertical_cache.hpp"
 
 namespace flatsurf {
 
@@ -36,8 +39,32 @@ class ImplementationOf<Vertical<Surface>> : ImplementationOf<ManagedMovable<Vert
   using T = typename Surface::Coordinate;
 
  public:
+  // Create the state of a Vertical whose caches track changes to the
+  // surface such as flips of edges.
   ImplementationOf(const Surface&, const Vector<T>&);
 
+  // Create the state of a Vertical whose caches are not tracked, i.e., a
+  // Vertical which must not be used anymore once the surface changes.
+  ImplementationOf(const Surface&, const Vector<T>&, std::false_type);
+
+  // Return the state of a (tracked) Vertical for this direction on this
+  // surface. As long as a Vertical for this direction is alive, its state is
+  // reused so that its caches need not be built again.
+  static std::shared_ptr<ImplementationOf> shared(const Surface&, const Vector<T>&);
+
+  // Return a cheap Vertical for short-lived use. The surface must not be
+  // modified while the returned Vertical is in use. If a tracked Vertical
+  // for this direction is alive, its caches are reused.
+  static Vertical view(const Surface&, const Vector<T>&);
+
+  // Return the bytes held by the (tracked) Verticals on this surface that
+  // are alive on the calling thread.
+  static size_t allocated(const Surface&);
+
+  // Return the cached projections, orientations, and largeness of the edges
+  // of the surface.
+  VerticalCache<T>& cache() const;
+
   // Starting at the half edge `start`, walk the surface and collect all its
   // half edges in `component`. We walk the surface by crossing any half
   // edges that are not vertical. For each half edge, `visitor` is called
@@ -50,12 +77,11 @@ class ImplementationOf<Vertical<Surface>> : ImplementationOf<ManagedMovable<Vert
   Vector<T> vertical;
   Vector<T> horizontal;
 
-  mutable Tracked<OddHalfEdgeMap<std::optional<T>>> parallelProjectionCache;
-  mutable Tracked<OddHalfEdgeMap<std::optional<T>>> perpendicularProjectionCache;
-  mutable Tracked<OddHalfEdgeMap<std::optional<CCW>>> ccwCache;
-  mutable Tracked<OddHalfEdgeMap<std::optional<ORIENTATION>>> orientationCache;
-  mutable Tracked<EdgeMap<std::optional<T>>> lengthCache;
-  mutable Tracked<EdgeMap<std::optional<bool>>> largenessCache;
+  mutable std::variant<VerticalCache<T>, Tracked<VerticalCache<T>>> storage;
+
+  // Guards the cache above when this vertical is queried from several
+  // threads at once.
+  mutable std::mutex caches;
 
  private:
   using ImplementationOf<ManagedMovable<Vertical>>::from_this;
@@ -0,0 +1,191 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_VERTICAL_CACHE_HPP
+#define LIBFLATSURF_VERTICAL_CACHE_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "../../flatsurf/ccw.hpp"
+#include "../../flatsurf/edge.hpp"
+#include "../../flatsurf/flat_triangulation_combinatorial.hpp"
+#include "../../flatsurf/half_edge.hpp"
+#include "../../flatsurf/orientation.hpp"
+#include "../util/assert.ipp"
+#include "../util/memory.ipp"
+
+namespace flatsurf {
+
+// The lazily computed data of a Vertical, i.e., projections, orientations,
+// and largeness of its edges.
+// The data is kept in a struct-of-arrays table indexed by Edge::index(); the
+// values for a negative half edge are derived from the ones of the
+// corresponding positive half edge.
+template <typename T>
+struct VerticalCache {
+  enum FLAG : uint8_t {
+    HAS_PROJECT = 1,
+    HAS_PERPENDICULAR = 2,
+    HAS_CCW = 4,
+    HAS_ORIENTATION = 8,
+    HAS_LARGE = 16,
+    // Whether the edge is large; only meaningful if HAS_LARGE is set.
+    IS_LARGE = 32,
+  };
+
+  // The cached data of a single half edge.
+  struct Entry {
+    uint8_t known = 0;
+    T project = T();
+    T perpendicular = T();
+    int8_t ccw = 0;
+    int8_t orientation = 0;
+  };
+
+  explicit VerticalCache(const FlatTriangulationCombinatorial& surface) :
+    known(surface.size()),
+    project(surface.size()),
+    perpendicular(surface.size()),
+    ccw(surface.size()),
+    orientation(surface.size()) {}
+
+  bool has(HalfEdge he, FLAG what) const {
+    return known[Edge(he).index()] & what;
+  }
+
+  T getProject(HalfEdge he) const {
+    return oriented(he, project[Edge(he).index()]);
+  }
+
+  T getPerpendicular(HalfEdge he) const {
+    return oriented(he, perpendicular[Edge(he).index()]);
+  }
+
+  CCW getCCW(HalfEdge he) const {
+    return static_cast<CCW>(oriented(he, ccw[Edge(he).index()]));
+  }
+
+  ORIENTATION getOrientation(HalfEdge he) const {
+    return static_cast<ORIENTATION>(oriented(he, orientation[Edge(he).index()]));
+  }
+
+  bool getLarge(HalfEdge he) const {
+    return known[Edge(he).index()] & IS_LARGE;
+  }
+
+  void setProject(HalfEdge he, const T& value) {
+    project[Edge(he).index()] = oriented(he, value);
+    known[Edge(he).index()] |= HAS_PROJECT;
+  }
+
+  void setPerpendicular(HalfEdge he, const T& value) {
+    perpendicular[Edge(he).index()] = oriented(he, value);
+    known[Edge(he).index()] |= HAS_PERPENDICULAR;
+  }
+
+  void setCCW(HalfEdge he, CCW value) {
+    ccw[Edge(he).index()] = oriented(he, static_cast<int8_t>(value));
+    known[Edge(he).index()] |= HAS_CCW;
+  }
+
+  void setOrientation(HalfEdge he, ORIENTATION value) {
+    orientation[Edge(he).index()] = oriented(he, static_cast<int8_t>(value));
+    known[Edge(he).index()] |= HAS_ORIENTATION;
+  }
+
+  void setLarge(HalfEdge he, bool value) {
+    auto& flags = known[Edge(he).index()];
+    flags = static_cast<uint8_t>((flags & ~IS_LARGE) | HAS_LARGE | (value ? IS_LARGE : 0));
+  }
+
+  // Return everything that is known about this half edge.
+  Entry get(HalfEdge he) const {
+    const size_t e = Edge(he).index();
+    return Entry{known[e], oriented(he, project[e]), oriented(he, perpendicular[e]), oriented(he, ccw[e]), oriented(he, orientation[e])};
+  }
+
+  // Replace everything that is known about this half edge.
+  void set(HalfEdge he, const Entry& entry) {
+    const size_t e = Edge(he).index();
+    known[e] = entry.known;
+    project[e] = oriented(he, entry.project);
+    perpendicular[e] = oriented(he, entry.perpendicular);
+    ccw[e] = oriented(he, entry.ccw);
+    orientation[e] = oriented(he, entry.orientation);
+  }
+
+  // Drop all cached data about this edge.
+  void forget(Edge e) {
+    known[e.index()] = 0;
+  }
+
+  // Drop the cached largeness of this edge.
+  void forgetLarge(Edge e) {
+    known[e.index()] &= static_cast<uint8_t>(~(HAS_LARGE | IS_LARGE));
+  }
+
+  // Remove the edge of largest index.
+  void pop() {
+    known.pop_back();
+    project.pop_back();
+    perpendicular.pop_back();
+    ccw.pop_back();
+    orientation.pop_back();
+  }
+
+  size_t size() const { return known.size(); }
+
+  // Return the bytes held by this cache.
+  size_t allocated() const {
+    size_t bytes = known.capacity() + ccw.capacity() + orientation.capacity();
+    bytes += (project.capacity() + perpendicular.capacity()) * sizeof(T);
+    for (size_t e = 0; e < size(); e++)
+      bytes += flatsurf::allocated(project[e]) + flatsurf::allocated(perpendicular[e]);
+    return bytes;
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const VerticalCache& self) {
+    os << "{";
+    for (size_t i = 0; i < self.size(); i++) {
+      if (i) os << ", ";
+      os << HalfEdge::fromIndex(2 * i) << ": " << static_cast<int>(self.known[i]);
+    }
+    return os << "}";
+  }
+
+  std::vector<uint8_t> known;
+  std::vector<T> project;
+  std::vector<T> perpendicular;
+  std::vector<int8_t> ccw;
+  std::vector<int8_t> orientation;
+
+ private:
+  template <typename S>
+  static S oriented(HalfEdge he, const S& value) {
+    if (he == Edge(he).positive())
+      return value;
+    return static_cast<S>(-value);
+  }
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -23,6 +23,8 @@
 #include <intervalxt/forward.hpp>
 #include <intervalxt/interval_exchange_transformation.hpp>
 #include <intervalxt/label.hpp>
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <ostream>
 #include <unordered_set>
@@ -57,13 +59,13 @@ IntervalExchangeTransformation<Surface>::IntervalExchangeTransformation(const Su
 template <typename Surface>
 IntervalExchangeTransformation<Surface>::IntervalExchangeTransformation(const Surface& surface, const Vector<T>& vertical, HalfEdge large) :
   self([&]() {
-    CHECK_ARGUMENT(Vertical<Surface>(surface, vertical).large(large), "can only construct IntervalExchangeTransformation from a large half edge");
+    CHECK_ARGUMENT(ImplementationOf<Vertical<Surface>>::view(surface, vertical).large(large), "can only construct IntervalExchangeTransformation from a large half edge");
 
     vector<HalfEdge> top, bottom;
 
-    ImplementationOf<ContourComponent<Surface>>::makeContour(back_inserter(top), large, surface, Vertical(surface, vertical));
+    ImplementationOf<ContourComponent<Surface>>::makeContour(back_inserter(top), large, surface, ImplementationOf<Vertical<Surface>>::view(surface, vertical));
 
-    ImplementationOf<ContourComponent<Surface>>::makeContour(back_inserter(bottom), -large, surface, Vertical(surface, -vertical));
+    ImplementationOf<ContourComponent<Surface>>::makeContour(back_inserter(bottom), -large, surface, ImplementationOf<Vertical<Surface>>::view(surface, -vertical));
     reverse(bottom.begin(), bottom.end());
     std::transform(bottom.begin(), bottom.end(), bottom.begin(), [](HalfEdge e) { return -e; });
     assert(std::unordered_set<HalfEdge>(bottom.begin(), bottom.end()) == std::unordered_set<HalfEdge>(top.begin(), top.end()) && "top & bottom contour must contain the same half edges");
@@ -74,51 +76,141 @@ IntervalExchangeTransformation<Surface>::IntervalExchangeTransformation(const Su
 
 template <typename Surface>
 void IntervalExchangeTransformation<Surface>::makeUniqueLargeEdges(Surface& surface, const Vector<T>& vertical_) {
-  Tracked<EdgeSet> sources(
-      surface, EdgeSet(), [](auto& sources, const auto&, HalfEdge e) { ASSERT(!sources.contains(e), "Selected source edges cannot be flipped."); }, [](auto& sources, const auto&, Edge e) { ASSERT(!sources.contains(e), "Selected source edges cannot be collapsed."); }, [](auto& sources, const auto& surface, HalfEdge a, HalfEdge b) { Tracked<EdgeSet>::defaultSwap(sources, surface, a, b); }, [](auto& sources, const auto& surface, const auto& edges) {
-    ASSERT(edges | rx::all_of([&](Edge e) { return !sources.contains(e); }), "Selected source edges cannot be erased.");
-    Tracked<EdgeSet>::defaultErase(sources, surface, edges); });
+  Tracked<EdgeSet> sources(surface, EdgeSet(),
+      [](auto& sources, const auto&, HalfEdge e) {
+        ASSERT(!sources.contains(e), "Selected source edges cannot be flipped.");
+      },
+      [](auto& sources, const auto&, Edge e) {
+        ASSERT(!sources.contains(e), "Selected source edges cannot be collapsed.");
+      },
+      [](auto& sources, const auto& surface, HalfEdge a, HalfEdge b) {
+        Tracked<EdgeSet>::defaultSwap(sources, surface, a, b);
+      },
+      [](auto& sources, const auto& surface, const auto& edges) {
+        ASSERT(edges | rx::all_of([&](Edge e) { return !sources.contains(e); }), "Selected source edges cannot be erased.");
+        Tracked<EdgeSet>::defaultErase(sources, surface, edges);
+      });
 
   const bool splitContours = true;
 
   Vertical<Surface> vertical(surface, vertical_);
+  Vertical<Surface> antivertical(surface, -vertical_);
+
+  // We process the large half edges by decreasing length of their horizontal
+  // projection. We keep them in a max-heap that is keyed by an approximation
+  // of that length and falls back to exact comparison when the
+  // approximations are too close to decide.
+  struct Candidate {
+    double approximation;
+    T length;
+    HalfEdge halfEdge;
+  };
 
-  while (true) {
-    auto larges = surface.halfEdges() | rx::filter([&](const HalfEdge source) {
-      if (sources->contains(source)) return false;
-      if (!vertical.large(source)) return false;
-      if (vertical.ccw(source) == CCW::COUNTERCLOCKWISE) return false;
-      return true;
-    }) | rx::to_vector();
+  const auto length = [&](HalfEdge halfEdge) {
+    auto ret = vertical.projectPerpendicular(halfEdge);
+    if (ret < 0) ret = -ret;
+    return ret;
+  };
 
-    std::sort(begin(larges), end(larges), [&](const HalfEdge a, const HalfEdge b) {
-      auto alength = vertical.projectPerpendicular(a);
-      auto blength = vertical.projectPerpendicular(b);
+  const auto approximate = [](const T& x) {
+    if constexpr (std::is_same_v<T, mpq_class> || std::is_same_v<T, mpz_class>) {
+      return x.get_d();
+    } else {
+      return static_cast<double>(x);
+    }
+  };
 
-      if (alength < 0) alength = -alength;
-      if (blength < 0) blength = -blength;
+  const auto less = [](const Candidate& lhs, const Candidate& rhs) {
+    const double scale = std::max(std::abs(lhs.approximation), std::abs(rhs.approximation));
+    if (std::abs(lhs.approximation - rhs.approximation) > 1e-9 * scale)
+      return lhs.approximation < rhs.approximation;
+    if (lhs.length != rhs.length)
+      return lhs.length < rhs.length;
+    return lhs.halfEdge.index() > rhs.halfEdge.index();
+  };
 
-      return alength < blength;
-    });
+  const auto candidate = [&](const HalfEdge source) {
+    if (sources->contains(source)) return false;
+    if (!vertical.large(source)) return false;
+    if (vertical.ccw(source) == CCW::COUNTERCLOCKWISE) return false;
+    return true;
+  };
 
-    if (larges.size() == 0) break;
+  std::vector<Candidate> heap;
 
-    HalfEdge source = larges.back();
+  const auto push = [&](const HalfEdge halfEdge) {
+    if (!candidate(halfEdge)) return;
+    auto exact = length(halfEdge);
+    const double approximation = approximate(exact);
+    heap.push_back(Candidate{approximation, std::move(exact), halfEdge});
+    std::push_heap(begin(heap), end(heap), less);
+  };
+
+  // Flips change the lengths of the flipped edge and the largeness of the
+  // edges in the adjacent faces. We record these edges and push them again
+  // into the heap. Outdated entries are dropped when they reach the top.
+  // Collapses renumber edges which invalidates the entire heap.
+  bool renumbered = true;
+  Tracked<EdgeSet> changed(surface, EdgeSet(),
+      [](auto& changed, const auto& surface, HalfEdge flip) {
+        for (auto e : {flip, -flip}) {
+          changed.insert(e);
+          changed.insert(surface.nextInFace(e));
+          changed.insert(surface.previousInFace(e));
+        }
+      },
+      [](auto&, const auto&, Edge) {},
+      [&](auto& changed, const auto& surface, HalfEdge a, HalfEdge b) {
+        renumbered = true;
+        Tracked<EdgeSet>::defaultSwap(changed, surface, a, b);
+      },
+      [&](auto& changed, const auto& surface, const auto& edges) {
+        renumbered = true;
+        Tracked<EdgeSet>::defaultErase(changed, surface, edges);
+      });
+
+  while (true) {
+    if (renumbered) {
+      heap.clear();
+      for (const auto halfEdge : surface.halfEdges())
+        push(halfEdge);
+      renumbered = false;
+    } else {
+      for (const auto edge : *changed) {
+        push(edge.positive());
+        push(edge.negative());
+      }
+    }
+    changed = EdgeSet();
+
+    // Drop outdated entries from the top of the heap.
+    while (heap.size() && (!candidate(heap.front().halfEdge) || heap.front().length != length(heap.front().halfEdge))) {
+      std::pop_heap(begin(heap), end(heap), less);
+      heap.pop_back();
+    }
+
+    if (heap.size() == 0) break;
+
+    ASSERTIONS(([&]() {
+      for (const auto halfEdge : surface.halfEdges())
+        ASSERT(!candidate(halfEdge) || length(halfEdge) <= heap.front().length, "Heap of large edges is inconsistent, " << halfEdge << " is longer than the top of the heap " << heap.front().halfEdge);
+    }));
+
+    HalfEdge source = heap.front().halfEdge;
 
     auto component = ImplementationOf<IntervalExchangeTransformation>::makeUniqueLargeEdge(surface, vertical_, source);
 
     if (splitContours) {
-      bool trivial, trivialStart, trivialEnd;
-      {
-        // Some attached data might not be able to handle the following
-        // collapspe.  Therefore, we need to scope iet, so attached data is
-        // definitely gone when the collapse below happens.
-        auto fromContour = IntervalExchangeTransformation(surface, vertical_, source);
-        auto& iet = fromContour.intervalExchangeTransformation();
-        trivial = iet.top().size() == 1;
-        trivialStart = *iet.top().begin() == *iet.bottom().begin();
-        trivialEnd = *iet.top().rbegin() == *iet.bottom().rbegin();
-      }
+      // Determine the contours that an IntervalExchangeTransformation
+      // starting at source would have.
+      vector<HalfEdge> top, bottom;
+      ImplementationOf<ContourComponent<Surface>>::makeContour(back_inserter(top), source, surface, vertical);
+      ImplementationOf<ContourComponent<Surface>>::makeContour(back_inserter(bottom), -source, surface, antivertical);
+      reverse(bottom.begin(), bottom.end());
+
+      const bool trivial = top.size() == 1;
+      const bool trivialStart = Edge(*begin(top)) == Edge(*begin(bottom));
+      const bool trivialEnd = Edge(*rbegin(top)) == Edge(*rbegin(bottom));
 
       if (!trivial && (trivialStart || trivialEnd)) {
         // Since the first half edge of the top and bottom contour have the
@@ -145,7 +237,7 @@ Edge IntervalExchangeTransformation<Surface>::edge(const Label& label) const {
 
 template <typename Surface>
 const SaddleConnection<FlatTriangulation<typename Surface::Coordinate>>& IntervalExchangeTransformation<Surface>::operator[](const intervalxt::Label& label) const {
-  return *self->lengths->lengths[self->lengths->fromLabel(label)];
+  return self->lengths->connection(self->lengths->fromLabel(label));
 }
 
 template <typename Surface>
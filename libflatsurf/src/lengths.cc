@@ -42,6 +42,7 @@
 #include <intervalxt/sample/renf_elem_coefficients.hpp>
 #include <intervalxt/sample/renf_elem_floor_division.hpp>
 #include <ostream>
+#include <variant>
 
 #include "../flatsurf/ccw.hpp"
 #include "../flatsurf/chain.hpp"
@@ -55,6 +56,7 @@
 #include "impl/saddle_connection.impl.hpp"
 #include "util/assert.ipp"
 #include "util/false.ipp"
+#include "util/statistics.ipp"
 
 namespace flatsurf {
 
@@ -66,11 +68,15 @@ using rx::none_of;
 template <typename Surface>
 Lengths<Surface>::Lengths(const Vertical<FlatTriangulation<T>>& vertical, EdgeMap<std::optional<SaddleConnection<FlatTriangulation<T>>>>&& lengths) :
   vertical(vertical),
-  lengths(std::move(lengths)),
+  initial(std::move(lengths)),
+  lengths(vertical.surface()),
   stack(),
   sum() {
-  this->lengths.apply([&](const auto& edge, const auto& connection) {
+  initial.apply([&](const auto& edge, const auto& connection) {
     CHECK_ARGUMENT(!connection || vertical.ccw(*connection) == CCW::CLOCKWISE, "nontrivial length must be positive but " << edge << " is " << *connection);
+
+    if (connection)
+      this->lengths[edge] = Entry{vertical.projectPerpendicular(*connection), {{edge, 1}}, {}, connection->source(), connection->target(), connection};
   });
 }
 
@@ -139,6 +145,8 @@ Label Lengths<Surface>::subtractRepeated(Label minuend) {
 
 template <typename Surface>
 void Lengths<Surface>::subtractRepeated(Label minuend, const mpz_class& iterations) {
+  LIBFLATSURF_COUNT(INDUCTION_STEPS);
+
   ASSERT(iterations > 0, "must subtract at least once");
   ASSERT(length(minuend) > 0, "lengths must be positive");
 
@@ -158,89 +166,101 @@ void Lengths<Surface>::subtractRepeated(Label minuend, const mpz_class& iteratio
   const auto minuendContour = minuendOnTop ? component.dynamicalComponent.topContour() : component.dynamicalComponent.bottomContour();
   const auto subtrahendContour = minuendOnTop ? component.dynamicalComponent.bottomContour() : component.dynamicalComponent.topContour();
 
-  const auto flow = [&](const auto& connections, bool reverse) {
-    auto flowed = connections | rx::transform([&](const auto& connection) {
-      return ImplementationOf<FlowConnection<FlatTriangulation<T>>>::make(state.lock(), ImplementationOf<FlowComponent<FlatTriangulation<T>>>::make(state.lock(), &component), connection).saddleConnection();
-    }) | rx::transform([&](const auto& connection) {
-      return reverse ? -connection : connection;
-    }) | rx::to_vector();
-    if (reverse)
-      std::reverse(begin(flowed), end(flowed));
-    return flowed;
+  // The connection we walk along when following the flow from the minuend
+  // across the subtrahends, as an integer combination of initial and vertical
+  // connections.
+  std::unordered_map<Edge, mpz_class> labels;
+  std::unordered_map<::intervalxt::Connection, mpz_class> verticals;
+  // A half edge at the vertex where this walk ends.
+  std::optional<HalfEdge> target;
+
+  // Add the connection that corresponds to a side of a contour to the walk
+  // and return a half edge at the vertex where it ends.
+  const auto add = [&](const auto& side, bool reverse, const auto& add) -> HalfEdge {
+    using Side = std::decay_t<decltype(side)>;
+    if constexpr (std::is_same_v<Side, std::variant<::intervalxt::Connection, ::intervalxt::HalfEdge>>) {
+      return std::visit([&](const auto& s) { return add(s, reverse, add); }, side);
+    } else if constexpr (std::is_same_v<Side, ::intervalxt::Connection>) {
+      const auto& connection = this->connection(side);
+      verticals[side] += reverse ? -1 : 1;
+      return reverse ? connection.source() : connection.target();
+    } else if constexpr (std::is_same_v<Side, ::intervalxt::HalfEdge>) {
+      const auto& entry = *lengths[fromLabel(static_cast<Label>(side))];
+      // Top sides are oriented from right to left.
+      const bool negative = side.top() != reverse;
+      for (const auto& [label, coefficient] : entry.labels)
+        if (negative)
+          labels[label] -= coefficient;
+        else
+          labels[label] += coefficient;
+      for (const auto& [connection, coefficient] : entry.verticals)
+        if (negative)
+          verticals[connection] -= coefficient;
+        else
+          verticals[connection] += coefficient;
+      return negative ? entry.source : entry.target;
+    } else {
+      static_assert(false_type_v<Side>, "unsupported side of a contour");
+    }
   };
 
-  auto& minuendConnection = lengths[fromLabel(minuend)];
-
-  {
-    minuendConnection = -*minuendConnection;
-
-    HalfEdge target = minuendConnection->target();
-    Chain walk(minuendConnection->surface());
-
-    // Walk down on the minuend's (top) left boundary
-    {
-      // left() is oriented from bottom to top so we need to reverse. This should probably be changed.
-      for (const auto& connection : flow(begin(minuendContour)->left() | rx::reverse() | rx::to_vector(), !minuendOnTop)) {
-        walk += connection;
-        target = connection.target();
-      }
+  const auto walk = [&](const auto& sides, bool reverse) {
+    // When reversed, the walk goes through the sides in reverse order, so it
+    // ends at the first side.
+    bool first = true;
+    for (const auto& side : sides) {
+      const HalfEdge end = add(side, reverse, add);
+      if (!reverse || first)
+        target = end;
+      first = false;
     }
+  };
 
-    // Walk across every subtrahend
-    {
-      for (const auto& subtrahend : subtrahendContour) {
-        ASSERT(subtrahend != *rbegin(subtrahendContour), "Stack cannot contain every label in the IntervalExchangeTransformation when subtracting.");
-
-        for (const auto& connection : flow(subtrahend.cross(), !minuendOnTop)) {
-          walk += connection;
-          target = connection.target();
-        }
-
-        if (static_cast<::intervalxt::Label>(subtrahend) == stack.back())
-          break;
-      }
-    }
+  // Walk down on the minuend's (top) left boundary
+  // left() is oriented from bottom to top so we need to reverse. This should probably be changed.
+  walk(begin(minuendContour)->left() | rx::reverse() | rx::to_vector(), !minuendOnTop);
 
-    // If we want to subtract this gadget more than once, we just need to scale
-    // the chain; source/target are not affected by this. (They might change,
-    // but they are still in the same half plane of the same vertex.)
-    // Note that this is more complicated when the bottom minuend has
-    // connections on its left. Therefore we need the caller to do a simple
-    // subtract before doing a subtractRepeated.
-    walk *= iterations;
+  // Walk across every subtrahend
+  for (const auto& subtrahend : subtrahendContour) {
+    ASSERT(subtrahend != *rbegin(subtrahendContour), "Stack cannot contain every label in the IntervalExchangeTransformation when subtracting.");
 
-    auto vector = walk + *minuendConnection;
+    walk(subtrahend.cross(), !minuendOnTop);
 
-    // The tricky part is now to figure out the actual source/target sector of
-    // the updated SaddleConnection.
-    // This should probably be moved into SaddleConnection at some point.
+    if (static_cast<::intervalxt::Label>(subtrahend) == stack.back())
+      break;
+  }
 
-    ASSERT(vertical->ccw(vector) == CCW::COUNTERCLOCKWISE, "Length must be positive.");
+  ASSERT(target, "walk across subtrahends cannot be empty");
 
-    // We know that minuendConnection (which we reversed in the beginning) is
-    // pointing left and that the new -minuendConnection must point left into
-    // the same half plane.
-    auto source = minuendConnection->source();
-    while (vertical->ccw(source) == CCW::COUNTERCLOCKWISE)
-      source = minuendConnection->surface().previousAtVertex(source);
-    while (!minuendConnection->surface().inSector(source, vector))
-      source = minuendConnection->surface().nextAtVertex(source);
+  // If we want to subtract this gadget more than once, we just need to scale
+  // the walk; source/target are not affected by this. (They might change,
+  // but they are still in the same half plane of the same vertex.)
+  // Note that this is more complicated when the bottom minuend has
+  // connections on its left. Therefore we need the caller to do a simple
+  // subtract before doing a subtractRepeated.
+  auto& entry = *lengths[fromLabel(minuend)];
 
-    while (vertical->ccw(target) != CCW::CLOCKWISE)
-      target = minuendConnection->surface().previousAtVertex(target);
-    while (!minuendConnection->surface().inSector(target, -vector))
-      target = minuendConnection->surface().nextAtVertex(target);
+  for (const auto& [label, coefficient] : labels)
+    if ((entry.labels[label] -= iterations * coefficient) == 0)
+      entry.labels.erase(label);
+  for (const auto& [connection, coefficient] : verticals)
+    if ((entry.verticals[connection] -= iterations * coefficient) == 0)
+      entry.verticals.erase(connection);
 
-    minuendConnection = SaddleConnection<FlatTriangulation<T>>(minuendConnection->surface(), target, source, -vector);
+  // The connection now starts where the walk ended; its target does not
+  // change.
+  entry.source = *target;
+  entry.length = expected;
+  entry.connection.reset();
 
-    ASSERT(minuendConnection->source() == target && minuendConnection->target() == source, "We tried to get SaddleConnection source/target right but SaddleConnection constructor disagrees.");
+  ASSERTIONS(([&]() {
+    static thread_local AssertConnection<T> assertion;
 
-    ASSERTIONS(([&]() {
-      static thread_local AssertConnection<T> assertion;
+    const auto& connection = this->connection(fromLabel(minuend));
 
-      ASSERT(assertion(*minuendConnection), "Connection after subtract does not actually exist in surface. There is no saddle connection " << *minuendConnection << " in " << minuendConnection->surface());
-    }));
-  }
+    ASSERT(assertion(connection), "Connection after subtract does not actually exist in surface. There is no saddle connection " << connection << " in " << connection.surface());
+    ASSERT(vertical->projectPerpendicular(connection) == expected, "Connection after subtract " << connection << " is inconsistent with its length " << expected);
+  }));
 
   ASSERT(get(minuend), "lengths must be non-zero");
   ASSERT(length(minuend) == expected, "subtract inconsistent: subtracted " << length() << " from " << fromLabel(minuend) << " which should have yielded " << expected << " but got " << length(minuend) << " instead");
@@ -253,6 +273,7 @@ template <typename Surface>
 Lengths<Surface>::Lengths(const Lengths<Surface>& lengths, std::shared_ptr<FlowDecompositionState<FlatTriangulation<T>>> state) :
   state(state),
   vertical(lengths.vertical),
+  initial(lengths.initial),
   lengths(lengths.lengths),
   stack(lengths.stack),
   sum(lengths.sum) {}
@@ -317,15 +338,85 @@ typename Surface::Coordinate Lengths<Surface>::length() const {
 
 template <typename Surface>
 typename Surface::Coordinate Lengths<Surface>::length(intervalxt::Label label) const {
-  auto length = vertical->projectPerpendicular(*lengths[fromLabel(label)]);
+  const auto& length = lengths[fromLabel(label)]->length;
   ASSERT(length > 0, "length must be positive");
   return length;
 }
 
+template <typename Surface>
+const SaddleConnection<FlatTriangulation<typename Surface::Coordinate>>& Lengths<Surface>::connection(Edge edge) const {
+  ASSERT(lengths[edge], "Cannot reconstruct connection of edge " << edge << " which is not part of the contour in " << *this);
+
+  const auto& entry = *lengths[edge];
+
+  if (!entry.connection) {
+    const auto& surface = vertical->surface();
+
+    Chain chain(surface);
+    for (const auto& [label, coefficient] : entry.labels) {
+      auto summand = initial[label]->chain();
+      summand *= coefficient;
+      chain += std::move(summand);
+    }
+    for (const auto& [connection, coefficient] : entry.verticals) {
+      auto summand = this->connection(connection).chain();
+      summand *= coefficient;
+      chain += std::move(summand);
+    }
+
+    const Vector<T>& vector = chain;
+
+    ASSERT(vertical->ccw(vector) == CCW::CLOCKWISE, "Length must be positive.");
+
+    // The tricky part is to figure out the actual source/target sector of the
+    // SaddleConnection. We know that the connection starts and ends in the
+    // half plane at the vertices of the recorded half edges.
+    // This should probably be moved into SaddleConnection at some point.
+
+    // The connection is pointing right. We go to the start of the half plane
+    // containing the recorded half edge and then search for the sector
+    // counterclockwise from there.
+    auto source = entry.source;
+    while (vertical->ccw(source) != CCW::CLOCKWISE)
+      source = surface.previousAtVertex(source);
+    while (vertical->ccw(source) == CCW::CLOCKWISE)
+      source = surface.previousAtVertex(source);
+    while (!surface.inSector(source, vector))
+      source = surface.nextAtVertex(source);
+
+    // The connection arrives pointing left.
+    auto target = entry.target;
+    while (vertical->ccw(target) == CCW::COUNTERCLOCKWISE)
+      target = surface.previousAtVertex(target);
+    while (!surface.inSector(target, -vector))
+      target = surface.nextAtVertex(target);
+
+    entry.connection = SaddleConnection<FlatTriangulation<T>>(surface, source, target, std::move(chain));
+
+    ASSERT(entry.connection->source() == source && entry.connection->target() == target, "We tried to get SaddleConnection source/target right but SaddleConnection constructor disagrees.");
+  }
+
+  return *entry.connection;
+}
+
+template <typename Surface>
+const SaddleConnection<FlatTriangulation<typename Surface::Coordinate>>& Lengths<Surface>::connection(const ::intervalxt::Connection& connection) const {
+  const auto state = this->state.lock();
+
+  ASSERT(state, "Vertical connections are only known in a flow decomposition.");
+
+  const auto injected = state->injectedConnections.find(connection);
+  if (injected != end(state->injectedConnections))
+    return injected->second;
+
+  ASSERT(state->detectedConnections.find(connection) != end(state->detectedConnections), "Connection " << connection << " not known to " << *state);
+  return state->detectedConnections.at(connection);
+}
+
 template <typename Surface>
 ::intervalxt::Lengths Lengths<Surface>::forget() const {
   std::vector<T> lengths;
-  this->lengths.apply([&](const auto& e, const auto& v) {
+  initial.apply([&](const auto& e, const auto& v) {
     if (v) {
       lengths.push_back(length(toLabel(e)));
     } else {
@@ -350,9 +441,9 @@ template <typename Surface>
 std::ostream& operator<<(std::ostream& os, const Lengths<Surface>& self) {
   using std::string;
   std::vector<string> items;
-  self.lengths.apply([&](const auto& key, const auto& value) {
+  self.initial.apply([&](const auto& key, const auto& value) {
     if (!value) return;
-    items.push_back(fmt::format("{}: {} = {}", key, *value, self.length(self.toLabel(key))));
+    items.push_back(fmt::format("{}: {} = {}", key, self.connection(key), self.length(self.toLabel(key))));
   });
   return os << fmt::format("{}", fmt::join(items, ", "));
 }
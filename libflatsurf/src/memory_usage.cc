@@ -0,0 +1,76 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/memory_usage.hpp"
+
+#include <array>
+#include <numeric>
+#include <ostream>
+
+namespace flatsurf {
+
+namespace {
+
+// The fields of MemoryUsage.
+constexpr std::array<size_t MemoryUsage::*, 7> fields = {
+    &MemoryUsage::surface,
+    &MemoryUsage::approximations,
+    &MemoryUsage::vertical,
+    &MemoryUsage::collapsed,
+    &MemoryUsage::decomposition,
+    &MemoryUsage::connections,
+    &MemoryUsage::chains,
+};
+
+}  // namespace
+
+size_t MemoryUsage::total() const {
+  return std::accumulate(begin(fields), end(fields), size_t{}, [&](size_t sum, const auto field) { return sum + this->*field; });
+}
+
+bool MemoryUsage::operator==(const MemoryUsage& rhs) const {
+  for (const auto field : fields)
+    if (this->*field != rhs.*field)
+      return false;
+  return true;
+}
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& rhs) {
+  for (const auto field : fields)
+    this->*field += rhs.*field;
+  return *this;
+}
+
+MemoryUsage& MemoryUsage::operator-=(const MemoryUsage& rhs) {
+  for (const auto field : fields)
+    this->*field -= rhs.*field;
+  return *this;
+}
+
+std::ostream& operator<<(std::ostream& os, const MemoryUsage& self) {
+  return os << "MemoryUsage(surface=" << self.surface
+            << ", approximations=" << self.approximations
+            << ", vertical=" << self.vertical
+            << ", collapsed=" << self.collapsed
+            << ", decomposition=" << self.decomposition
+            << ", connections=" << self.connections
+            << ", chains=" << self.chains << ")";
+}
+
+}  // namespace flatsurf
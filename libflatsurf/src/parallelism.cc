@@ -0,0 +1,46 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/parallelism.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace flatsurf {
+
+namespace {
+
+// The limit set with Parallelism::threads() or 0 for the default.
+std::atomic<unsigned> limit{0};
+
+}  // namespace
+
+unsigned Parallelism::threads() {
+  const unsigned threads = limit.load(std::memory_order_relaxed);
+  if (threads)
+    return threads;
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void Parallelism::threads(unsigned threads) {
+  limit.store(threads, std::memory_order_relaxed);
+}
+
+}  // namespace flatsurf
@@ -83,6 +83,13 @@ const Surface& SaddleConnection<Surface>::surface() const {
   return self->surface;
 }
 
+template <typename Surface>
+MemoryUsage SaddleConnection<Surface>::memoryUsage() const {
+  auto usage = self->chain.memoryUsage();
+  usage.connections += sizeof(ImplementationOf<SaddleConnection>);
+  return usage;
+}
+
 template <typename Surface>
 SaddleConnection<Surface> SaddleConnection<Surface>::operator-() const {
   return SaddleConnection(self->surface, self->target, self->source, -self->chain);
@@ -274,6 +281,125 @@ ImplementationOf<SaddleConnection<Surface>>::ImplementationOf(const Surface& sur
   target(target),
   chain(std::move(chain)) {}
 
+template <typename Surface>
+SaddleConnection<Surface> ImplementationOf<SaddleConnection<Surface>>::make(const Vertical<Surface>& vertical, HalfEdge clockwiseFrom, HalfEdge counterclockwiseTo, Chain<Surface>&& chain) {
+  const auto& surface = vertical.surface();
+
+  ASSERT(chain, "SaddleConnection must not be the zero vector");
+  ASSERT(vertical.ccw(chain) == CCW::COLLINEAR, "SaddleConnection must be vertical");
+  ASSERT(vertical.orientation(chain) == ORIENTATION::SAME, "SaddleConnection must be parallel but " << chain << " is antiparallel.");
+
+  enum SECTOR {
+    NORTH,
+    NORTH_WEST,
+    WEST,
+    SOUTH_WEST,
+    SOUTH,
+    SOUTH_EAST,
+    EAST,
+    NORTH_EAST,
+  };
+
+  // Classify a half edge with respect to the vertical. Note that this only
+  // uses the (cached) predicates of the vertical on half edges so it does not
+  // need to look at the vectors of the surface.
+  const auto classify = [&](HalfEdge halfEdge) {
+    switch (vertical.ccw(halfEdge)) {
+      case CCW::COUNTERCLOCKWISE:
+        switch (vertical.orientation(halfEdge)) {
+          case ORIENTATION::OPPOSITE:
+            return SOUTH_WEST;
+          case ORIENTATION::SAME:
+            return NORTH_WEST;
+          default:
+            return WEST;
+        }
+      case CCW::CLOCKWISE:
+        switch (vertical.orientation(halfEdge)) {
+          case ORIENTATION::OPPOSITE:
+            return SOUTH_EAST;
+          case ORIENTATION::SAME:
+            return NORTH_EAST;
+          default:
+            return EAST;
+        }
+      default:
+        switch (vertical.orientation(halfEdge)) {
+          case ORIENTATION::OPPOSITE:
+            return SOUTH;
+          case ORIENTATION::SAME:
+            return NORTH;
+          default:
+            UNREACHABLE("cannot classify zero vector");
+        }
+    }
+  };
+
+  // The source of the new SaddleConnection, i.e., counterclockwise to which
+  // HalfEdge the SaddleConnection starts (inclusive.)
+  const auto source = [&]() {
+    auto ret = clockwiseFrom;
+
+    while (true) {
+      switch (classify(ret)) {
+        case NORTH:
+        case NORTH_EAST:
+        case EAST:
+        case SOUTH_EAST:
+          break;
+        default:
+          ret = surface.previousAtVertex(ret);
+          continue;
+      }
+      break;
+    }
+
+    ASSERT(surface.inSector(ret, vertical.vertical()), "We determined that the new SaddleConnection " << chain << " must start in the sector counterclockwise from " << ret << " but that vector is not in the sector.");
+
+    return ret;
+  }();
+
+  // The target of the new SaddleConnection, i.e., counterclockwise to which
+  // HalfEdge -SaddleConnection starts (inclusive.)
+  const auto target = [&]() {
+    auto ret = counterclockwiseTo;
+
+    while (true) {
+      switch (classify(ret)) {
+        case NORTH_WEST:
+        case WEST:
+        case SOUTH_WEST:
+          break;
+        default:
+          ret = surface.nextAtVertex(ret);
+          continue;
+      }
+      break;
+    }
+
+    while (true) {
+      switch (classify(ret)) {
+        case SOUTH_EAST:
+        case EAST:
+        case NORTH_EAST:
+          break;
+        default:
+          ret = surface.nextAtVertex(ret);
+          continue;
+      }
+      break;
+    }
+
+    ret = surface.previousAtVertex(ret);
+
+    ASSERT(surface.inSector(ret, -vertical.vertical()), "We determined that the new SaddleConnection " << chain << " must end in the sector counterclockwise from " << ret << " but the negative of that vector is not in the sector.");
+
+    return ret;
+  }();
+
+  return SaddleConnection(surface, source, target, std::move(chain));
+}
+
 }  // namespace flatsurf
 
 namespace std {
@@ -0,0 +1,123 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/saddle_connections_export.hpp"
+
+#include <ostream>
+#include <stdexcept>
+
+#include "../flatsurf/chain.hpp"
+#include "../flatsurf/chain_iterator.hpp"
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connections.hpp"
+#include "../flatsurf/saddle_connections_by_length.hpp"
+#include "../flatsurf/saddle_connections_by_length_iterator.hpp"
+#include "../flatsurf/saddle_connections_iterator.hpp"
+#include "../flatsurf/vector.hpp"
+#include "impl/saddle_connections_export.impl.hpp"
+#include "util/double.ipp"
+
+namespace flatsurf {
+
+template <typename Surface>
+SaddleConnectionsExport<Surface>::SaddleConnectionsExport(const SaddleConnections<Surface>& connections, bool chains) :
+  self(spimpl::make_impl<ImplementationOf<SaddleConnectionsExport>>(connections.surface(), chains)) {
+  self->append(connections);
+}
+
+template <typename Surface>
+SaddleConnectionsExport<Surface>::SaddleConnectionsExport(const SaddleConnectionsByLength<Surface>& connections, bool chains) :
+  self(spimpl::make_impl<ImplementationOf<SaddleConnectionsExport>>(connections.surface(), chains)) {
+  self->append(connections);
+}
+
+template <typename Surface>
+size_t SaddleConnectionsExport<Surface>::size() const {
+  return self->sources.size();
+}
+
+template <typename Surface>
+size_t SaddleConnectionsExport<Surface>::edges() const {
+  return self->edges;
+}
+
+template <typename Surface>
+const std::vector<double>& SaddleConnectionsExport<Surface>::holonomies() const {
+  return self->holonomies;
+}
+
+template <typename Surface>
+const std::vector<int32_t>& SaddleConnectionsExport<Surface>::sources() const {
+  return self->sources;
+}
+
+template <typename Surface>
+const std::vector<int32_t>& SaddleConnectionsExport<Surface>::targets() const {
+  return self->targets;
+}
+
+template <typename Surface>
+const std::vector<int64_t>& SaddleConnectionsExport<Surface>::chains() const {
+  return self->chains;
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnectionsExport<Surface>>::ImplementationOf(const Surface& surface, bool chains) :
+  edges(surface.edges().size()),
+  exportChains(chains) {}
+
+template <typename Surface>
+template <typename Connections>
+void ImplementationOf<SaddleConnectionsExport<Surface>>::append(const Connections& connections) {
+  for (const auto& connection : connections)
+    append(connection);
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnectionsExport<Surface>>::append(const SaddleConnection<Surface>& connection) {
+  const auto& vector = connection.vector();
+  holonomies.push_back(toDouble(vector.x()));
+  holonomies.push_back(toDouble(vector.y()));
+
+  sources.push_back(connection.source().id());
+  targets.push_back(connection.target().id());
+
+  if (exportChains) {
+    const size_t row = chains.size();
+    chains.resize(row + edges);
+    for (const auto& [edge, coefficient] : connection.chain()) {
+      if (!coefficient->fits_slong_p())
+        throw std::logic_error("not implemented: cannot export chains with coefficients beyond 64 bits");
+      chains[row + edge.index()] = coefficient->get_si();
+    }
+  }
+}
+
+template <typename Surface>
+std::ostream& operator<<(std::ostream& os, const SaddleConnectionsExport<Surface>& self) {
+  return os << "SaddleConnectionsExport of " << self.size() << " saddle connections";
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), SaddleConnectionsExport, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
@@ -32,6 +32,7 @@
 #include "impl/saddle_connections.impl.hpp"
 #include "impl/saddle_connections_iterator.impl.hpp"
 #include "util/assert.ipp"
+#include "util/statistics.ipp"
 
 namespace flatsurf {
 
@@ -136,6 +137,8 @@ bool ImplementationOf<SaddleConnectionsIterator<Surface>>::increment() {
     case State::START_FROM_INSIDE_TO_INSIDE:
     case State::START_FROM_INSIDE_TO_OUTSIDE:
     case State::START_FROM_OUTSIDE_TO_INSIDE:
+      LIBFLATSURF_COUNT(SEARCH_NODES_VISITED);
+
       moves.push_back(Move::GOTO_OTHER_FACE);
 
       if (onBoundary()) {
@@ -429,7 +432,7 @@ template <typename Surface>
 void ImplementationOf<SaddleConnectionsIterator<Surface>>::pushStart(bool fromOutside, bool toOutside) {
   if (fromOutside) {
     if (toOutside) {
-      ;
+      LIBFLATSURF_COUNT(SEARCH_NODES_PRUNED);
     } else {
       state.push_back(State::START_FROM_OUTSIDE_TO_INSIDE);
     }
@@ -0,0 +1,165 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/saddle_connections_reader.hpp"
+
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+
+#include "../flatsurf/chain.hpp"
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "impl/saddle_connections_reader.impl.hpp"
+#include "impl/saddle_connections_writer.impl.hpp"
+#include "util/assert.ipp"
+
+namespace flatsurf {
+
+template <typename Surface>
+SaddleConnectionsReader<Surface>::SaddleConnectionsReader(const Surface& surface, std::istream& is) :
+  self(spimpl::make_unique_impl<ImplementationOf<SaddleConnectionsReader>>(surface, is)) {}
+
+template <typename Surface>
+bool SaddleConnectionsReader<Surface>::next() {
+  self->valid = false;
+
+  int32_t source;
+  if (!self->read(&source, sizeof(source)))
+    return false;
+
+  int32_t target;
+  self->read(&target, sizeof(target));
+  self->read(&self->x, sizeof(self->x));
+  self->read(&self->y, sizeof(self->y));
+
+  CHECK_ARGUMENT(self->halfEdge(source) && self->halfEdge(target), "record does not describe a saddle connection on this surface since its half edges " << source << " and " << target << " are not on a surface with " << self->edges << " edges");
+
+  self->source = HalfEdge(source);
+  self->target = HalfEdge(target);
+
+  self->chain.clear();
+  if (self->chains) {
+    uint32_t nonzero;
+    self->read(&nonzero, sizeof(nonzero));
+    for (uint32_t i = 0; i < nonzero; i++) {
+      int32_t edge;
+      int64_t coefficient;
+      self->read(&edge, sizeof(edge));
+      self->read(&coefficient, sizeof(coefficient));
+      CHECK_ARGUMENT(edge > 0 && edge <= self->edges, "record does not describe a saddle connection on this surface since its chain contains edge " << edge << " which is not on a surface with " << self->edges << " edges");
+      self->chain.push_back({Edge(edge), coefficient});
+    }
+  }
+
+  self->valid = true;
+  return true;
+}
+
+template <typename Surface>
+HalfEdge SaddleConnectionsReader<Surface>::source() const {
+  CHECK_ARGUMENT(self->valid, "there is no current record, call next() first");
+  return self->source;
+}
+
+template <typename Surface>
+HalfEdge SaddleConnectionsReader<Surface>::target() const {
+  CHECK_ARGUMENT(self->valid, "there is no current record, call next() first");
+  return self->target;
+}
+
+template <typename Surface>
+double SaddleConnectionsReader<Surface>::x() const {
+  CHECK_ARGUMENT(self->valid, "there is no current record, call next() first");
+  return self->x;
+}
+
+template <typename Surface>
+double SaddleConnectionsReader<Surface>::y() const {
+  CHECK_ARGUMENT(self->valid, "there is no current record, call next() first");
+  return self->y;
+}
+
+template <typename Surface>
+bool SaddleConnectionsReader<Surface>::chains() const {
+  return self->chains;
+}
+
+template <typename Surface>
+SaddleConnection<Surface> SaddleConnectionsReader<Surface>::connection() const {
+  CHECK_ARGUMENT(self->valid, "there is no current record, call next() first");
+  CHECK_ARGUMENT(self->chains, "cannot create saddle connections from records without chains");
+
+  Chain<Surface> chain(surface());
+  for (const auto& [edge, coefficient] : self->chain)
+    chain += (Chain<Surface>(surface(), edge.positive()) *= mpz_class(static_cast<long>(coefficient)));
+
+  return SaddleConnection<Surface>(surface(), self->source, self->target, std::move(chain));
+}
+
+template <typename Surface>
+const Surface& SaddleConnectionsReader<Surface>::surface() const {
+  return self->surface;
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnectionsReader<Surface>>::ImplementationOf(const Surface& surface, std::istream& is) :
+  surface(surface),
+  is(is),
+  edges(static_cast<int64_t>(surface.edges().size())) {
+  uint64_t magic = 0;
+  uint32_t version = 0;
+  uint32_t flags = 0;
+
+  CHECK_ARGUMENT(read(&magic, sizeof(magic)) && magic == SaddleConnectionsFormat::MAGIC, "stream does not contain saddle connections");
+  read(&version, sizeof(version));
+  CHECK_ARGUMENT(version == SaddleConnectionsFormat::VERSION, "unsupported version " << version << " of saddle connections stream");
+  read(&flags, sizeof(flags));
+
+  chains = flags & SaddleConnectionsFormat::CHAINS;
+}
+
+template <typename Surface>
+bool ImplementationOf<SaddleConnectionsReader<Surface>>::halfEdge(int32_t id) const {
+  return id != 0 && std::abs(static_cast<int64_t>(id)) <= edges;
+}
+
+template <typename Surface>
+bool ImplementationOf<SaddleConnectionsReader<Surface>>::read(void* data, size_t bytes) {
+  is.read(static_cast<char*>(data), bytes);
+  if (is.gcount() == 0 && is.eof())
+    return false;
+  CHECK_ARGUMENT(static_cast<size_t>(is.gcount()) == bytes, "stream of saddle connections is truncated");
+  return true;
+}
+
+template <typename Surface>
+std::ostream& operator<<(std::ostream& os, const SaddleConnectionsReader<Surface>& self) {
+  os << "SaddleConnectionsReader on " << self.surface();
+  if (self.self->valid)
+    os << " at " << self.source() << " -> " << self.target();
+  return os;
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), SaddleConnectionsReader, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
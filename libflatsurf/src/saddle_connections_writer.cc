@@ -0,0 +1,251 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/saddle_connections_writer.hpp"
+
+#include <cstring>
+#include <ios>
+#include <ostream>
+#include <stdexcept>
+
+#include "../flatsurf/chain.hpp"
+#include "../flatsurf/chain_iterator.hpp"
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connections.hpp"
+#include "../flatsurf/saddle_connections_by_length.hpp"
+#include "../flatsurf/saddle_connections_by_length_iterator.hpp"
+#include "../flatsurf/saddle_connections_iterator.hpp"
+#include "../flatsurf/vector.hpp"
+#include "impl/saddle_connections_writer.impl.hpp"
+#include "util/assert.ipp"
+#include "util/double.ipp"
+
+namespace flatsurf {
+
+namespace {
+
+// Append the raw bytes of value to chunk.
+template <typename V>
+void appendBytes(std::vector<char>& chunk, const V& value) {
+  const size_t size = chunk.size();
+  chunk.resize(size + sizeof(V));
+  std::memcpy(chunk.data() + size, &value, sizeof(V));
+}
+
+}  // namespace
+
+template <typename Surface>
+SaddleConnectionsWriter<Surface>::SaddleConnectionsWriter(std::ostream& os, bool chains, bool background) :
+  self(spimpl::make_unique_impl<ImplementationOf<SaddleConnectionsWriter>>(os, chains, background)) {}
+
+template <typename Surface>
+SaddleConnectionsWriter<Surface>& SaddleConnectionsWriter<Surface>::operator<<(const SaddleConnection<Surface>& connection) {
+  self->append(connection);
+  return *this;
+}
+
+template <typename Surface>
+SaddleConnectionsWriter<Surface>& SaddleConnectionsWriter<Surface>::operator<<(const SaddleConnections<Surface>& connections) {
+  for (const auto& connection : connections)
+    self->append(connection);
+  return *this;
+}
+
+template <typename Surface>
+SaddleConnectionsWriter<Surface>& SaddleConnectionsWriter<Surface>::operator<<(const SaddleConnectionsByLength<Surface>& connections) {
+  for (const auto& connection : connections)
+    self->append(connection);
+  return *this;
+}
+
+template <typename Surface>
+void SaddleConnectionsWriter<Surface>::flush() {
+  self->flush();
+}
+
+template <typename Surface>
+size_t SaddleConnectionsWriter<Surface>::size() const {
+  return self->records;
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnectionsWriter<Surface>>::ImplementationOf(std::ostream& os, bool chains, bool background) :
+  os(os),
+  chains(chains) {
+  chunk.reserve(CHUNK);
+
+  appendBytes(chunk, SaddleConnectionsFormat::MAGIC);
+  appendBytes(chunk, SaddleConnectionsFormat::VERSION);
+  appendBytes(chunk, chains ? SaddleConnectionsFormat::CHAINS : uint32_t(0));
+
+  if (background)
+    thread.emplace([&]() { run(); });
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnectionsWriter<Surface>>::~ImplementationOf() {
+  try {
+    flush();
+  } catch (...) {
+    // There is no way to report errors from a destructor. Callers that care
+    // about errors must call flush() explicitly.
+  }
+
+  if (thread) {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    changed.notify_all();
+    thread->join();
+  }
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnectionsWriter<Surface>>::append(const SaddleConnection<Surface>& connection) {
+  const auto& vector = static_cast<const Vector<typename Surface::Coordinate>&>(connection);
+
+  // Check the chain before writing anything so that we never leave a
+  // partial record in the chunk.
+  if (chains)
+    for (const auto& [edge, coefficient] : connection.chain())
+      if (!coefficient->fits_slong_p())
+        throw std::logic_error("not implemented: cannot write chains with coefficients beyond 64 bits");
+
+  appendBytes(chunk, static_cast<int32_t>(connection.source().id()));
+  appendBytes(chunk, static_cast<int32_t>(connection.target().id()));
+  appendBytes(chunk, toDouble(vector.x()));
+  appendBytes(chunk, toDouble(vector.y()));
+
+  if (chains) {
+    const auto& chain = connection.chain();
+
+    const size_t count = chunk.size();
+    appendBytes(chunk, uint32_t(0));
+
+    uint32_t nonzero = 0;
+    for (const auto& [edge, coefficient] : chain) {
+      appendBytes(chunk, static_cast<int32_t>(edge.positive().id()));
+      appendBytes(chunk, static_cast<int64_t>(coefficient->get_si()));
+      nonzero++;
+    }
+    std::memcpy(chunk.data() + count, &nonzero, sizeof(nonzero));
+  }
+
+  records++;
+
+  if (chunk.size() >= CHUNK)
+    submit();
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnectionsWriter<Surface>>::submit() {
+  if (chunk.empty())
+    return;
+
+  if (!thread) {
+    write(chunk);
+    chunk.clear();
+    return;
+  }
+
+  {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [&]() { return pending.size() < PENDING || error; });
+    rethrow();
+    pending.push_back(std::move(chunk));
+  }
+  changed.notify_all();
+
+  chunk = std::vector<char>();
+  chunk.reserve(CHUNK);
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnectionsWriter<Surface>>::flush() {
+  submit();
+
+  if (thread) {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [&]() { return (pending.empty() && !writing) || error; });
+    rethrow();
+  }
+
+  os.flush();
+  if (!os)
+    throw std::ios_base::failure("failed to write saddle connections to stream");
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnectionsWriter<Surface>>::write(const std::vector<char>& data) {
+  os.write(data.data(), data.size());
+  if (!os)
+    throw std::ios_base::failure("failed to write saddle connections to stream");
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnectionsWriter<Surface>>::run() {
+  while (true) {
+    std::vector<char> data;
+
+    {
+      std::unique_lock lock(mutex);
+      changed.wait(lock, [&]() { return stopping || !pending.empty(); });
+      if (pending.empty())
+        return;
+      data = std::move(pending.front());
+      pending.pop_front();
+      writing = true;
+    }
+
+    std::exception_ptr failure;
+    try {
+      write(data);
+    } catch (...) {
+      failure = std::current_exception();
+    }
+
+    {
+      std::lock_guard lock(mutex);
+      writing = false;
+      if (failure && !error)
+        error = failure;
+    }
+    changed.notify_all();
+  }
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnectionsWriter<Surface>>::rethrow() {
+  if (error)
+    std::rethrow_exception(error);
+}
+
+template <typename Surface>
+std::ostream& operator<<(std::ostream& os, const SaddleConnectionsWriter<Surface>& self) {
+  return os << "SaddleConnectionsWriter with " << self.size() << " records";
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), SaddleConnectionsWriter, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
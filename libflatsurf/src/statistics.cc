@@ -0,0 +1,177 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/statistics.hpp"
+
+#include <fmt/format.h>
+
+#include <mutex>
+#include <ostream>
+#include <unordered_set>
+
+#include "util/statistics.ipp"
+
+namespace flatsurf {
+
+namespace {
+
+// The fields of Statistics in the order of COUNTER.
+constexpr std::array<unsigned long long Statistics::*, ThreadStatistics::size> fields = {
+    &Statistics::flips,
+    &Statistics::collapses,
+    &Statistics::trackedNotifications,
+    &Statistics::approximatePredicates,
+    &Statistics::exactPredicates,
+    &Statistics::chainRecomputations,
+    &Statistics::searchNodesVisited,
+    &Statistics::searchNodesPruned,
+    &Statistics::decompositionSteps,
+    &Statistics::inductionSteps,
+};
+
+// The counters of all running threads and the sum of the counters of the
+// threads that have terminated already.
+struct Registry {
+  std::mutex lock;
+  std::unordered_set<ThreadStatistics*> threads;
+  Statistics terminated;
+
+  static Registry& instance() {
+    // We never free the registry so that threads that terminate during
+    // static destruction can still deregister.
+    static Registry* registry = new Registry();
+    return *registry;
+  }
+};
+
+Statistics snapshot(const ThreadStatistics& thread) {
+  Statistics statistics;
+  for (size_t i = 0; i < ThreadStatistics::size; i++)
+    statistics.*fields[i] = thread.counters[i].load(std::memory_order_relaxed);
+  for (size_t predicate = 0; predicate < Statistics::PREDICATES; predicate++)
+    for (size_t precision = 0; precision <= Statistics::PRECISIONS; precision++)
+      statistics.precisions[predicate][precision] = thread.precisions[predicate][precision].load(std::memory_order_relaxed);
+  return statistics;
+}
+
+}  // namespace
+
+ThreadStatistics::ThreadStatistics() {
+  auto& registry = Registry::instance();
+  const std::lock_guard<std::mutex> lock(registry.lock);
+  registry.threads.insert(this);
+}
+
+ThreadStatistics::~ThreadStatistics() {
+  auto& registry = Registry::instance();
+  const std::lock_guard<std::mutex> lock(registry.lock);
+  registry.terminated += snapshot(*this);
+  registry.threads.erase(this);
+}
+
+ThreadStatistics& ThreadStatistics::current() {
+  thread_local ThreadStatistics statistics;
+  return statistics;
+}
+
+bool Statistics::enabled() {
+#ifdef LIBFLATSURF_STATISTICS
+  return true;
+#else
+  return false;
+#endif
+}
+
+Statistics Statistics::thread() {
+  return snapshot(ThreadStatistics::current());
+}
+
+Statistics Statistics::total() {
+  auto& registry = Registry::instance();
+  const std::lock_guard<std::mutex> lock(registry.lock);
+
+  Statistics total = registry.terminated;
+  for (const auto* thread : registry.threads)
+    total += snapshot(*thread);
+  return total;
+}
+
+void Statistics::reset() {
+  auto& registry = Registry::instance();
+  const std::lock_guard<std::mutex> lock(registry.lock);
+
+  registry.terminated = Statistics();
+  for (auto* thread : registry.threads) {
+    for (auto& counter : thread->counters)
+      counter.store(0, std::memory_order_relaxed);
+    for (auto& counters : thread->precisions)
+      for (auto& counter : counters)
+        counter.store(0, std::memory_order_relaxed);
+  }
+}
+
+bool Statistics::operator==(const Statistics& rhs) const {
+  for (const auto field : fields)
+    if (this->*field != rhs.*field)
+      return false;
+  return precisions == rhs.precisions;
+}
+
+Statistics& Statistics::operator+=(const Statistics& rhs) {
+  for (const auto field : fields)
+    this->*field += rhs.*field;
+  for (size_t predicate = 0; predicate < PREDICATES; predicate++)
+    for (size_t precision = 0; precision <= PRECISIONS; precision++)
+      precisions[predicate][precision] += rhs.precisions[predicate][precision];
+  return *this;
+}
+
+Statistics& Statistics::operator-=(const Statistics& rhs) {
+  for (const auto field : fields)
+    this->*field -= rhs.*field;
+  for (size_t predicate = 0; predicate < PREDICATES; predicate++)
+    for (size_t precision = 0; precision <= PRECISIONS; precision++)
+      precisions[predicate][precision] -= rhs.precisions[predicate][precision];
+  return *this;
+}
+
+std::ostream& operator<<(std::ostream& os, const Statistics& self) {
+  const auto precisions = [&](Statistics::PREDICATE predicate) {
+    const auto& counts = self.precisions[static_cast<size_t>(predicate)];
+    return fmt::format("[{}]", fmt::join(counts, ", "));
+  };
+
+  return os << "Statistics(flips=" << self.flips
+            << ", collapses=" << self.collapses
+            << ", trackedNotifications=" << self.trackedNotifications
+            << ", approximatePredicates=" << self.approximatePredicates
+            << ", exactPredicates=" << self.exactPredicates
+            << ", precisions=(ccw=" << precisions(Statistics::PREDICATE::CCW)
+            << ", orientation=" << precisions(Statistics::PREDICATE::ORIENTATION)
+            << ", bound=" << precisions(Statistics::PREDICATE::BOUND)
+            << ", length=" << precisions(Statistics::PREDICATE::LENGTH)
+            << ", chainBound=" << precisions(Statistics::PREDICATE::CHAIN_BOUND) << ")"
+            << ", chainRecomputations=" << self.chainRecomputations
+            << ", searchNodesVisited=" << self.searchNodesVisited
+            << ", searchNodesPruned=" << self.searchNodesPruned
+            << ", decompositionSteps=" << self.decompositionSteps
+            << ", inductionSteps=" << self.inductionSteps << ")";
+}
+
+}  // namespace flatsurf
@@ -0,0 +1,177 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/tracing.hpp"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+#include "../flatsurf/flat_triangulation_combinatorial.hpp"
+#include "impl/flat_triangulation_combinatorial.impl.hpp"
+#include "util/assert.ipp"
+#include "util/tracing.ipp"
+
+namespace flatsurf {
+
+namespace {
+
+// The file the trace is being written to.
+struct Trace {
+  std::mutex lock;
+  std::ofstream file;
+  // The time when the trace was started, as the ticks of the steady clock
+  // since its epoch. This is read without holding the lock when spans are
+  // created, so it must be atomic.
+  std::atomic<std::chrono::steady_clock::rep> start{0};
+  // Whether no event has been written to the file yet.
+  bool empty = true;
+
+  static Trace& instance() {
+    static Trace trace;
+    return trace;
+  }
+
+  ~Trace() {
+    // Finish the trace when the program terminates.
+    const std::lock_guard<std::mutex> lock(this->lock);
+    close();
+  }
+
+ private:
+  Trace() {
+    if (const char* path = std::getenv("LIBFLATSURF_TRACE")) {
+      if (*path && !open(path))
+        std::cerr << "libflatsurf: cannot write trace to " << path << std::endl;
+    }
+  }
+
+ public:
+  // Start writing the trace to path; return whether the file could be
+  // opened.
+  bool open(const std::string& path) {
+    file.open(path, std::ios::out | std::ios::trunc);
+    if (!file)
+      return false;
+    // We write the JSON Array Format, see
+    // https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+    file << "[\n";
+    empty = true;
+    start.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    TraceWriter::enabled = true;
+    return true;
+  }
+
+  void close() {
+    if (!file.is_open())
+      return;
+    TraceWriter::enabled = false;
+    file << "\n]\n";
+    file.close();
+  }
+};
+
+// Return a small integer that identifies the calling thread in the trace.
+size_t threadIdentifier() {
+  static std::atomic<size_t> threads{0};
+  thread_local const size_t id = ++threads;
+  return id;
+}
+
+// Start tracing when the library is loaded if LIBFLATSURF_TRACE is set.
+const bool initialized = (Trace::instance(), true);
+
+}  // namespace
+
+std::atomic<bool> TraceWriter::enabled{false};
+
+void Tracing::start(const std::string& path) {
+  auto& trace = Trace::instance();
+  const std::lock_guard<std::mutex> lock(trace.lock);
+  trace.close();
+  CHECK_ARGUMENT(trace.open(path), "cannot write trace to " << path);
+}
+
+void Tracing::stop() {
+  auto& trace = Trace::instance();
+  const std::lock_guard<std::mutex> lock(trace.lock);
+  trace.close();
+}
+
+bool Tracing::enabled() {
+  return TraceWriter::enabled;
+}
+
+double TraceWriter::now() {
+  const auto start = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(Trace::instance().start.load(std::memory_order_relaxed)));
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+void TraceWriter::emit(const char* name, double start, double end, const std::string& args) {
+  auto& trace = Trace::instance();
+  const std::lock_guard<std::mutex> lock(trace.lock);
+
+  // Tracing might have been stopped while this span was open.
+  if (!trace.file.is_open())
+    return;
+
+  if (!trace.empty)
+    trace.file << ",\n";
+  trace.empty = false;
+
+  trace.file << fmt::format(R"({{"name": {}, "cat": "flatsurf", "ph": "X", "ts": {:.3f}, "dur": {:.3f}, "pid": {}, "tid": {}, "args": {}}})", quote(name), start, end - start, getpid(), threadIdentifier(), args);
+}
+
+std::string TraceWriter::id(const FlatTriangulationCombinatorial& surface) {
+  return fmt::format("{}", static_cast<const void*>(ImplementationOf<FlatTriangulationCombinatorial>::self(surface).state.get()));
+}
+
+std::string TraceWriter::quote(const std::string& value) {
+  std::string quoted = "\"";
+  for (const char c : value) {
+    switch (c) {
+      case '"':
+        quoted += "\\\"";
+        break;
+      case '\\':
+        quoted += "\\\\";
+        break;
+      case '\n':
+        quoted += "\\n";
+        break;
+      case '\t':
+        quoted += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+          quoted += fmt::format("\\u{:04x}", static_cast<int>(c));
+        else
+          quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+}  // namespace flatsurf
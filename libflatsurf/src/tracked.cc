@@ -25,6 +25,7 @@
 #include "impl/tracked.impl.hpp"
 #include "impl/weak_read_only.hpp"
 #include "util/assert.ipp"
+#include "util/statistics.ipp"
 
 namespace flatsurf {
 
@@ -235,7 +236,7 @@ ImplementationOf<Tracked<T>>::ImplementationOf(ImplementationOf<FlatTriangulatio
 template <typename T>
 ImplementationOf<Tracked<T>>::~ImplementationOf() {
   if (!parent.expired())
-    onChange.disconnect();
+    ImplementationOf<FlatTriangulationCombinatorial>::disconnect(parent.get(), onChange);
 }
 
 template <typename T>
@@ -245,6 +246,8 @@ void ImplementationOf<Tracked<T>>::connect() {
   // This callback uses a reference to "this->parent". This reference will not
   // be dangling since we explicitly disconnect in ~Implementation.
   onChange = ImplementationOf<FlatTriangulationCombinatorial>::connect(parent.get(), [this](const Message& message) {
+    LIBFLATSURF_COUNT(TRACKED_NOTIFICATIONS);
+
     if (auto flipMessage = std::get_if<ImplementationOf<FlatTriangulationCombinatorial>::MessageAfterFlip>(&message)) {
       const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
       updateAfterFlip(value, surface, flipMessage->e);
@@ -263,7 +266,7 @@ void ImplementationOf<Tracked<T>>::connect() {
         updateBeforeDestruction(value, surface);
       }
       if (!parent.expired())
-        onChange.disconnect();
+        ImplementationOf<FlatTriangulationCombinatorial>::disconnect(parent.get(), onChange);
       this->parent = moveMessage->target;
       if (!parent.expired())
         connect();
@@ -286,6 +289,7 @@ void ImplementationOf<Tracked<T>>::connect() {
 #include "../flatsurf/vector.hpp"
 #include "impl/collapsed_half_edge.hpp"
 #include "impl/flat_triangulation_collapsed.impl.hpp"
+#include "impl/vertical_cache.hpp"
 #include "util/instantiate.ipp"
 
 LIBFLATSURF_INSTANTIATE((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), (Tracked<HalfEdge>))
@@ -302,10 +306,13 @@ LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_I
 LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_REAL_TYPES, LIBFLATSURF_WRAP_HALF_EDGE_MAP_OPTIONAL)
 
 #define LIBFLATSURF_WRAP_ODD_HALF_EDGE_MAP_OPTIONAL(R, TYPE, T) (TYPE<OddHalfEdgeMap<std::optional<T>>>)
-LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_REAL_TYPES(flatsurf::CCW)(flatsurf::ORIENTATION), LIBFLATSURF_WRAP_ODD_HALF_EDGE_MAP_OPTIONAL)
+LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_REAL_TYPES(flatsurf::CCW)(flatsurf::ORIENTATION)(flatsurf::Vector<exactreal::Arb>), LIBFLATSURF_WRAP_ODD_HALF_EDGE_MAP_OPTIONAL)
 
 #define LIBFLATSURF_WRAP_HALF_EDGE_MAP_SADDLE_CONNECTION(R, TYPE, T) (TYPE<HalfEdgeMap<SaddleConnection<T>>>)
 LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_FLAT_TRIANGULATION_TYPES, LIBFLATSURF_WRAP_HALF_EDGE_MAP_SADDLE_CONNECTION)
 
 #define LIBFLATSURF_WRAP_HALF_EDGE_MAP_COLLAPSED(R, TYPE, T) (TYPE<HalfEdgeMap<CollapsedHalfEdge<T>>>)
 LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_REAL_TYPES, LIBFLATSURF_WRAP_HALF_EDGE_MAP_COLLAPSED)
+
+#define LIBFLATSURF_WRAP_VERTICAL_CACHE(R, TYPE, T) (TYPE<VerticalCache<T>>)
+LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_REAL_TYPES, LIBFLATSURF_WRAP_VERTICAL_CACHE)
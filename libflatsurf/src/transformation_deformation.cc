@@ -19,6 +19,8 @@
 
 #include "impl/transformation_deformation.hpp"
 
+#include <algorithm>
+
 #include "../flatsurf/delaunay.hpp"
 #include "../flatsurf/edge.hpp"
 #include "../flatsurf/half_edge_set.hpp"
@@ -28,12 +30,22 @@
 namespace flatsurf {
 
 template <typename Surface>
-TransformationDeformation<Surface>::TransformationDeformation(Surface&& surface, HalfEdgeMap<HalfEdge>&& halfEdgeMap) :
+TransformationDeformation<Surface>::TransformationDeformation(Surface&& surface, HalfEdgeMap<HalfEdge>&& halfEdgeMap, bool relabeledCells) :
   ImplementationOf<Deformation<Surface>>(std::move(surface)),
   isomorphism(std::move(halfEdgeMap)) {
-  ASSERT_ARGUMENT(this->surface.halfEdges() | rx::all_of([&](const auto he) {
+  ASSERT_ARGUMENT(relabeledCells || (this->surface.halfEdges() | rx::all_of([&](const auto he) {
     return this->isomorphism[he] != HalfEdge() || this->surface.delaunay(he.edge()) == DELAUNAY::AMBIGUOUS;
-  }),
+  })),
+      "half edge map is not a total map");
+  // Isomorphisms of Delaunay cells do not map the AMBIGUOUS edges. Since the
+  // preimage labels its AMBIGUOUS edges differently, we can only check that
+  // the number of unmapped half edges is consistent.
+  ASSERT_ARGUMENT(!relabeledCells || [&]() {
+    const auto& halfEdges = this->surface.halfEdges();
+    const auto unmapped = std::count_if(begin(halfEdges), end(halfEdges), [&](const auto he) { return this->isomorphism[he] == HalfEdge(); });
+    const auto ambiguous = std::count_if(begin(halfEdges), end(halfEdges), [&](const auto he) { return this->surface.delaunay(he.edge()) == DELAUNAY::AMBIGUOUS; });
+    return unmapped == 0 || unmapped == ambiguous;
+  }(),
       "half edge map is not a total map");
   ASSERT_ARGUMENT([&]() {
     HalfEdgeSet im;
@@ -56,8 +68,8 @@ std::optional<HalfEdge> TransformationDeformation<Surface>::operator()(HalfEdge
 }
 
 template <typename Surface>
-Deformation<Surface> TransformationDeformation<Surface>::make(Surface&& surface, HalfEdgeMap<HalfEdge>&& halfEdgeMap) {
-  return ImplementationOf<Deformation<Surface>>::make(std::move(spimpl::unique_impl_ptr<ImplementationOf<Deformation<Surface>>>(new TransformationDeformation<Surface>(std::move(surface), std::move(halfEdgeMap)), spimpl::details::default_delete<ImplementationOf<Deformation<Surface>>>)));
+Deformation<Surface> TransformationDeformation<Surface>::make(Surface&& surface, HalfEdgeMap<HalfEdge>&& halfEdgeMap, bool relabeledCells) {
+  return ImplementationOf<Deformation<Surface>>::make(std::move(spimpl::unique_impl_ptr<ImplementationOf<Deformation<Surface>>>(new TransformationDeformation<Surface>(std::move(surface), std::move(halfEdgeMap), relabeledCells), spimpl::details::default_delete<ImplementationOf<Deformation<Surface>>>)));
 }
 
 }  // namespace flatsurf
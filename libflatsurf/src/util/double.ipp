@@ -0,0 +1,42 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_DOUBLE_IPP
+#define LIBFLATSURF_UTIL_DOUBLE_IPP
+
+#include <gmpxx.h>
+
+#include <type_traits>
+
+namespace flatsurf {
+
+// Return an approximation of x as a double. (GMP types do not support a
+// static_cast to double so we need to special case them.)
+template <typename T>
+double toDouble(const T& x) {
+  if constexpr (std::is_same_v<T, mpq_class> || std::is_same_v<T, mpz_class>) {
+    return x.get_d();
+  } else {
+    return static_cast<double>(x);
+  }
+}
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,114 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_MEMORY_IPP
+#define LIBFLATSURF_UTIL_MEMORY_IPP
+
+#include <e-antic/renfxx.h>
+#include <flint/fmpz.h>
+#include <gmpxx.h>
+
+#include <exact-real/arb.hpp>
+#include <exact-real/element.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace flatsurf {
+
+// Estimates of the memory that coordinates and containers hold on the heap,
+// see MemoryUsage. Each of these functions does not count sizeof() of its
+// argument itself, only what the argument owns.
+
+inline size_t allocated(long long) {
+  return 0;
+}
+
+inline size_t allocated(const mpz_class& x) {
+  return static_cast<size_t>(x.get_mpz_t()->_mp_alloc) * sizeof(mp_limb_t);
+}
+
+inline size_t allocated(const mpq_class& x) {
+  return allocated(x.get_num()) + allocated(x.get_den());
+}
+
+// Return the bytes held by a FLINT integer.
+inline size_t allocatedFmpz(const fmpz& x) {
+  // Integers that fit into a word are stored inline.
+  if (!COEFF_IS_MPZ(x))
+    return 0;
+  return sizeof(__mpz_struct) + static_cast<size_t>(COEFF_TO_PTR(x)->_mp_alloc) * sizeof(mp_limb_t);
+}
+
+// Return the bytes a FLINT integer with the value x holds.
+inline size_t allocatedAsFmpz(const mpz_class& x) {
+  if (mpz_sizeinbase(x.get_mpz_t(), 2) <= FLINT_BITS - 2)
+    return 0;
+  return sizeof(__mpz_struct) + mpz_size(x.get_mpz_t()) * sizeof(mp_limb_t);
+}
+
+inline size_t allocated(const eantic::renf_elem_class& x) {
+  // e-antic does not expose the storage of its elements, so we estimate it
+  // from the coefficients. Elements of fields of degree at most two and
+  // rational elements store their coefficients inline, otherwise the
+  // coefficients live in a separate array. (We ignore the enclosure of the
+  // embedding which is stored inline at the usual precisions.)
+  if (x.is_rational()) {
+    const auto q = static_cast<mpq_class>(x);
+    return allocatedAsFmpz(q.get_num()) + allocatedAsFmpz(q.get_den());
+  }
+
+  const auto coefficients = x.num_vector();
+
+  size_t bytes = coefficients.size() > 2 ? coefficients.size() * sizeof(fmpz) : 0;
+  for (const auto& coefficient : coefficients)
+    bytes += allocatedAsFmpz(coefficient);
+  return bytes + allocatedAsFmpz(x.den());
+}
+
+template <typename Ring>
+inline size_t allocated(const exactreal::Element<Ring>&) {
+  // exact-real does not expose the storage of its elements, so we only
+  // count the element itself.
+  return 0;
+}
+
+inline size_t allocated(const exactreal::Arb& x) {
+  return static_cast<size_t>(arb_allocated_bytes(x.arb_t()));
+}
+
+template <typename Container, typename = void>
+struct HasBuckets : std::false_type {};
+
+template <typename Container>
+struct HasBuckets<Container, std::void_t<decltype(std::declval<const Container&>().bucket_count())>> : std::true_type {};
+
+// Return the bytes held by the nodes of a std::list or an unordered
+// container (and its buckets), not counting what the entries own.
+template <typename Container>
+inline size_t allocatedNodes(const Container& container) {
+  // Every node holds an entry and (at most) two pointers.
+  size_t bytes = container.size() * (sizeof(typename Container::value_type) + 2 * sizeof(void*));
+  if constexpr (HasBuckets<Container>::value)
+    bytes += container.bucket_count() * sizeof(void*);
+  return bytes;
+}
+
+}  // namespace flatsurf
+
+#endif
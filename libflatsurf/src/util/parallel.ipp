@@ -0,0 +1,98 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_PARALLEL_IPP
+#define LIBFLATSURF_UTIL_PARALLEL_IPP
+
+#include <gmpxx.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../../flatsurf/parallelism.hpp"
+
+namespace flatsurf {
+namespace {
+
+// Whether arithmetic with coordinates of type T can happen in several threads
+// at the same time. Elements of number fields refine the shared embedding of
+// their field and exact reals cache approximations of their shared basis so
+// we only run things in parallel for the GMP and machine types.
+template <typename T>
+constexpr bool concurrent = std::is_same_v<T, long long> || std::is_same_v<T, mpz_class> || std::is_same_v<T, mpq_class>;
+
+// Return a lock on caches that are filled lazily from const methods, such as
+// the caches of a Vertical. These need to be guarded when their owner is
+// shared between threads. Since coordinates that are not thread-safe cannot
+// be used from several threads anyway, we do not lock for these.
+template <typename T>
+std::unique_lock<std::mutex> lockCaches(std::mutex& caches) {
+  if constexpr (concurrent<T>)
+    return std::unique_lock<std::mutex>(caches);
+  else
+    return std::unique_lock<std::mutex>(caches, std::defer_lock);
+}
+
+// Run task(i) for all 0 ≤ i < n on up to Parallelism::threads() threads.
+// If any task throws, one of the exceptions is rethrown here once all
+// threads have finished.
+template <typename Task>
+void parallel(size_t n, Task&& task) {
+  const size_t threads = std::min<size_t>(n, Parallelism::threads());
+
+  if (threads <= 1) {
+    for (size_t i = 0; i < n; i++)
+      task(i);
+    return;
+  }
+
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::atomic_flag failed = ATOMIC_FLAG_INIT;
+
+  const auto work = [&]() {
+    try {
+      for (size_t i = next++; i < n; i = next++)
+        task(i);
+    } catch (...) {
+      if (!failed.test_and_set())
+        error = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < threads; t++)
+    pool.emplace_back(work);
+  work();
+  for (auto& thread : pool)
+    thread.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+}  // namespace
+}  // namespace flatsurf
+
+#endif
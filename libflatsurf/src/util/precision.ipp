@@ -0,0 +1,119 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_PRECISION_IPP
+#define LIBFLATSURF_UTIL_PRECISION_IPP
+
+#include <exact-real/arb.hpp>
+#include <exact-real/yap/arb.hpp>
+#include <optional>
+
+#include "../../flatsurf/ccw.hpp"
+#include "../../flatsurf/orientation.hpp"
+#include "../../flatsurf/statistics.hpp"
+#include "assert.ipp"
+#include "statistics.ipp"
+
+namespace flatsurf {
+
+// Attempt to decide a predicate with ball arithmetic at increasing precision.
+// decide(prec) returns the value of the predicate computed at precision prec
+// or nullopt if the balls were too wide to decide it. We start at
+// exactreal::ARB_PRECISION_FAST and double the precision until the predicate
+// has been decided or Statistics::PRECISIONS precisions have been tried, in
+// which case we return nullopt and the caller has to fall back to exact
+// arithmetic.
+// Note that predicates which are degenerate, such as the ccw() of collinear
+// vectors with irrational coordinates, cannot be decided with balls at any
+// precision. These pay for all the attempts before falling back, so the
+// number of precisions should be tuned with the counts in
+// Statistics::precisions.
+template <typename Decide>
+auto decideAdaptively(Statistics::PREDICATE predicate, Decide&& decide) {
+  slong prec = exactreal::ARB_PRECISION_FAST;
+  for (size_t precision = 0; precision < Statistics::PRECISIONS; precision++, prec *= 2) {
+    auto decision = decide(prec);
+    if (decision) {
+      LIBFLATSURF_COUNT(APPROXIMATE_PREDICATES);
+      LIBFLATSURF_COUNT_PRECISION(predicate, precision);
+      return decision;
+    }
+  }
+
+  LIBFLATSURF_COUNT(EXACT_PREDICATES);
+  LIBFLATSURF_COUNT_PRECISION(predicate, Statistics::PRECISIONS);
+  return decltype(decide(prec)){};
+}
+
+// Return the orientation of (x_, y_) with respect to (x, y) or nullopt if
+// it cannot be decided at precision prec.
+inline std::optional<CCW> approximateCcw(const exactreal::Arb& x, const exactreal::Arb& y, const exactreal::Arb& x_, const exactreal::Arb& y_, slong prec) {
+  const exactreal::Arb a = (x * y_)(prec);
+  const exactreal::Arb b = (x_ * y)(prec);
+
+  const bool overlaps = arb_overlaps(a.arb_t(), b.arb_t());
+  if (overlaps) {
+    if (arb_is_exact(a.arb_t()) && arb_is_exact(b.arb_t())) {
+      if (a.equal(b)) {
+        // a and b are identical single point sets
+        return CCW::COLLINEAR;
+      }
+    }
+    return std::nullopt;
+  } else {
+    int cmp = arf_cmp(arb_midref(a.arb_t()), arb_midref(b.arb_t()));
+    ASSERT(cmp != 0, "balls that do not overlap cannot have the same midpoint");
+    if (cmp < 0)
+      return CCW::CLOCKWISE;
+    else
+      return CCW::COUNTERCLOCKWISE;
+  }
+}
+
+// Return the sign of the scalar product of (x, y) and (x_, y_) or nullopt if
+// it cannot be decided at precision prec.
+inline std::optional<ORIENTATION> approximateOrientation(const exactreal::Arb& x, const exactreal::Arb& y, const exactreal::Arb& x_, const exactreal::Arb& y_, slong prec) {
+  // Arb also has a built-in dot product. It's probably not doing anything else in 2d.
+  const exactreal::Arb dot = (x * x_ + y * y_)(prec);
+
+  auto cmp = dot > 0;
+  if (cmp.has_value()) {
+    if (*cmp) {
+      return ORIENTATION::SAME;
+    } else {
+      auto is_zero = dot == exactreal::Arb();
+      if (is_zero.has_value() && *is_zero) {
+        // dot is the single point 0 without any ball imprecision
+        return ORIENTATION::ORTHOGONAL;
+      } else {
+        return ORIENTATION::OPPOSITE;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+// Return the squared length of (x, y) computed at precision prec.
+inline exactreal::Arb approximateNorm(const exactreal::Arb& x, const exactreal::Arb& y, slong prec) {
+  return (x * x + y * y)(prec);
+}
+
+}  // namespace flatsurf
+
+#endif
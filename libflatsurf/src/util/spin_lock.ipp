@@ -0,0 +1,52 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_SPIN_LOCK_IPP
+#define LIBFLATSURF_UTIL_SPIN_LOCK_IPP
+
+#include <atomic>
+#include <thread>
+
+namespace flatsurf {
+namespace {
+
+// Holds a lock on an atomic_flag for the lifetime of this object.
+// This is meant for lazily filled caches that live in many small objects
+// where a std::mutex would be too large and the lock is hardly ever
+// contended.
+class SpinLock {
+  std::atomic_flag& flag;
+
+ public:
+  explicit SpinLock(std::atomic_flag& flag) :
+    flag(flag) {
+    while (flag.test_and_set(std::memory_order_acquire))
+      std::this_thread::yield();
+  }
+
+  SpinLock(const SpinLock&) = delete;
+  SpinLock& operator=(const SpinLock&) = delete;
+
+  ~SpinLock() { flag.clear(std::memory_order_release); }
+};
+
+}  // namespace
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,94 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_STATISTICS_IPP
+#define LIBFLATSURF_UTIL_STATISTICS_IPP
+
+#include <array>
+#include <atomic>
+
+#include "../../flatsurf/statistics.hpp"
+
+namespace flatsurf {
+
+// The counters of Statistics, see statistics.hpp for their meaning.
+enum class COUNTER {
+  FLIPS,
+  COLLAPSES,
+  TRACKED_NOTIFICATIONS,
+  APPROXIMATE_PREDICATES,
+  EXACT_PREDICATES,
+  CHAIN_RECOMPUTATIONS,
+  SEARCH_NODES_VISITED,
+  SEARCH_NODES_PRUNED,
+  DECOMPOSITION_STEPS,
+  INDUCTION_STEPS,
+};
+
+// The counters of a single thread.
+// Only the owning thread writes to these counters but other threads read
+// them to aggregate totals. Therefore, the counters are atomic but we never
+// use read-modify-write operations on them which would be costly.
+struct ThreadStatistics {
+  static constexpr size_t size = static_cast<size_t>(COUNTER::INDUCTION_STEPS) + 1;
+
+  ThreadStatistics();
+  ~ThreadStatistics();
+
+  void count(COUNTER counter) {
+    increment(counters[static_cast<size_t>(counter)]);
+  }
+
+  void count(Statistics::PREDICATE predicate, size_t precision) {
+    increment(precisions[static_cast<size_t>(predicate)][precision]);
+  }
+
+  // Return the counters of the calling thread.
+  static ThreadStatistics& current();
+
+  std::array<std::atomic<unsigned long long>, size> counters = {};
+  std::array<std::array<std::atomic<unsigned long long>, Statistics::PRECISIONS + 1>, Statistics::PREDICATES> precisions = {};
+
+ private:
+  static void increment(std::atomic<unsigned long long>& value) {
+    value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+};
+
+}  // namespace flatsurf
+
+// Increment the counter COUNTER::NAME of the calling thread.
+// This compiles to nothing when libflatsurf is built without statistics.
+#ifdef LIBFLATSURF_STATISTICS
+#define LIBFLATSURF_COUNT(NAME) ::flatsurf::ThreadStatistics::current().count(::flatsurf::COUNTER::NAME)
+#else
+#define LIBFLATSURF_COUNT(NAME) \
+  while (false) ::flatsurf::ThreadStatistics::current().count(::flatsurf::COUNTER::NAME)
+#endif
+
+// Record that the Statistics::PREDICATE PREDICATE was decided at the
+// PRECISION-th precision, see Statistics::precisions.
+#ifdef LIBFLATSURF_STATISTICS
+#define LIBFLATSURF_COUNT_PRECISION(PREDICATE, PRECISION) ::flatsurf::ThreadStatistics::current().count(PREDICATE, PRECISION)
+#else
+#define LIBFLATSURF_COUNT_PRECISION(PREDICATE, PRECISION) \
+  while (false) ::flatsurf::ThreadStatistics::current().count(PREDICATE, PRECISION)
+#endif
+
+#endif
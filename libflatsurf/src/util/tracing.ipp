@@ -0,0 +1,122 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_TRACING_IPP
+#define LIBFLATSURF_UTIL_TRACING_IPP
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include <atomic>
+#include <boost/preprocessor/cat.hpp>
+#include <string>
+
+#include "../../flatsurf/tracing.hpp"
+
+namespace flatsurf {
+
+// The writer behind Tracing, see tracing.cc.
+struct TraceWriter {
+  // Whether a trace is being written; checked before anything else is done
+  // for a span.
+  static std::atomic<bool> enabled;
+
+  // Return the microseconds since the trace was started.
+  static double now();
+
+  // Write a complete event (a span) to the trace. `args` is a JSON object.
+  static void emit(const char* name, double start, double end, const std::string& args);
+
+  // Return an identifier of this surface that is the same for all copies
+  // that share the same underlying state.
+  static std::string id(const FlatTriangulationCombinatorial&);
+
+  // Return value as a quoted and escaped JSON string.
+  static std::string quote(const std::string& value);
+};
+
+// A span of a trace, i.e., a phase of a computation that starts when this
+// object is created and ends when it is destroyed.
+// The arguments that are attached to the span are produced lazily by
+// `args`, i.e., only if tracing is enabled.
+class TraceSpan {
+ public:
+  template <typename Args>
+  TraceSpan(const char* name, Args&& args) :
+    name(name) {
+    if (TraceWriter::enabled.load(std::memory_order_relaxed)) {
+      this->args = args();
+      start = TraceWriter::now();
+    }
+  }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+  ~TraceSpan() {
+    if (start >= 0)
+      TraceWriter::emit(name, start, TraceWriter::now(), args);
+  }
+
+ private:
+  const char* name;
+  double start = -1;
+  std::string args;
+};
+
+// Return the arguments of a span as a JSON object, e.g.,
+// traceArguments("surface", surface, "direction", direction).
+// Surfaces are described by their identity; anything else by its
+// representation as a string.
+template <typename... Args>
+std::string traceArguments(const Args&... args) {
+  std::string json;
+
+  const auto append = [&](const char* key, const auto& value) {
+    json += json.empty() ? "{" : ", ";
+    json += TraceWriter::quote(key);
+    json += ": ";
+    if constexpr (std::is_convertible_v<const decltype(value)&, const FlatTriangulationCombinatorial&>)
+      json += TraceWriter::quote(TraceWriter::id(value));
+    else
+      json += TraceWriter::quote(fmt::format("{}", value));
+  };
+
+  const auto pairs = [&](const auto& self, const char* key, const auto& value, const auto&... rest) -> void {
+    append(key, value);
+    if constexpr (sizeof...(rest) > 0)
+      self(self, rest...);
+  };
+
+  if constexpr (sizeof...(args) > 0)
+    pairs(pairs, args...);
+
+  return json.empty() ? "{}" : json + "}";
+}
+
+}  // namespace flatsurf
+
+// Trace the remainder of the current scope as a span called NAME, attaching
+// key value pairs as arguments, e.g.,
+// LIBFLATSURF_TRACE("makeUniqueLargeEdges", "surface", surface).
+// When tracing is off, this costs a single relaxed atomic load.
+#define LIBFLATSURF_TRACE(NAME, ...) \
+  const ::flatsurf::TraceSpan BOOST_PP_CAT(libflatsurf_trace_span_, __LINE__)(NAME, [&]() { return ::flatsurf::traceArguments(__VA_ARGS__); })
+
+#endif
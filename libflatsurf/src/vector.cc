@@ -41,6 +41,8 @@
 #include "impl/vector.impl.hpp"
 #include "util/assert.ipp"
 #include "util/hash.ipp"
+#include "util/memory.ipp"
+#include "util/precision.ipp"
 
 namespace flatsurf {
 
@@ -51,6 +53,8 @@ namespace flatsurf {
 // expressions and have Arb decide automatically, i.e., without any custom code
 // here. However, it is a bit unclear whether there is a reasonable choice of
 // precision for that.
+// Predicates on exact vectors that cannot be decided at this precision are
+// retried at higher precisions, see decideAdaptively().
 using exactreal::ARB_PRECISION_FAST;
 
 template <typename S, typename T>
@@ -258,50 +262,14 @@ template <typename Vector>
 std::optional<CCW> detail::VectorWithError<Vector>::ccw(const Vector& rhs) const {
   const Vector& self = static_cast<const Vector&>(*this);
 
-  const exactreal::Arb a = (self.self->x * rhs.self->y)(ARB_PRECISION_FAST);
-  const exactreal::Arb b = (rhs.self->x * self.self->y)(ARB_PRECISION_FAST);
-
-  const bool overlaps = arb_overlaps(a.arb_t(), b.arb_t());
-  if (overlaps) {
-    if (arb_is_exact(a.arb_t()) && arb_is_exact(b.arb_t())) {
-      if (a.equal(b)) {
-        // a and b are identical single point sets
-        return CCW::COLLINEAR;
-      }
-    }
-    return std::nullopt;
-  } else {
-    int cmp = arf_cmp(arb_midref(a.arb_t()), arb_midref(b.arb_t()));
-    assert(cmp != 0);
-    if (cmp < 0)
-      return CCW::CLOCKWISE;
-    else
-      return CCW::COUNTERCLOCKWISE;
-  }
+  return approximateCcw(self.self->x, self.self->y, rhs.self->x, rhs.self->y, ARB_PRECISION_FAST);
 }
 
 template <typename Vector>
 std::optional<ORIENTATION> detail::VectorWithError<Vector>::orientation(const Vector& rhs) const {
   const Vector& self = static_cast<const Vector&>(*this);
 
-  // Arb also has a built-in dot product. It's probably not doing anything else in 2d.
-  const exactreal::Arb dot = (self.self->x * rhs.self->x + self.self->y * rhs.self->y)(ARB_PRECISION_FAST);
-
-  auto cmp = dot > 0;
-  if (cmp.has_value()) {
-    if (*cmp) {
-      return ORIENTATION::SAME;
-    } else {
-      auto is_zero = dot == exactreal::Arb();
-      if (is_zero.has_value() && *is_zero) {
-        // dot is the single point 0 without any ball imprecision
-        return ORIENTATION::ORTHOGONAL;
-      } else {
-        return ORIENTATION::OPPOSITE;
-      }
-    }
-  }
-  return std::nullopt;
+  return approximateOrientation(self.self->x, self.self->y, rhs.self->x, rhs.self->y, ARB_PRECISION_FAST);
 }
 
 template <typename Vector>
@@ -313,8 +281,7 @@ std::optional<bool> detail::VectorWithError<Vector>::operator>(Bound bound) cons
     if (nonzero) return *nonzero;
   }
 
-  exactreal::Arb size = (self.self->x * self.self->x + self.self->y * self.self->y)(ARB_PRECISION_FAST);
-  return size > bound.squared();
+  return approximateNorm(self.self->x, self.self->y, ARB_PRECISION_FAST) > bound.squared();
 }
 
 template <typename Vector>
@@ -332,8 +299,7 @@ std::optional<bool> detail::VectorWithError<Vector>::operator<(Bound bound) cons
   const Vector& self = static_cast<const Vector&>(*this);
 
   if (!bound) return false;
-  exactreal::Arb size = (self.self->x * self.self->x + self.self->y * self.self->y)(ARB_PRECISION_FAST);
-  return size < bound.squared();
+  return approximateNorm(self.self->x, self.self->y, ARB_PRECISION_FAST) < bound.squared();
 }
 
 template <typename Vector>
@@ -413,7 +379,11 @@ CCW detail::VectorExact<Vector, T>::ccw(const Vector& other) const {
   };
 
   if constexpr (IsEAntic<T> || IsExactReal<T>) {
-    const auto maybeCcw = static_cast<flatsurf::Vector<exactreal::Arb>>(self).ccw(static_cast<flatsurf::Vector<exactreal::Arb>>(other));
+    const auto maybeCcw = decideAdaptively(Statistics::PREDICATE::CCW, [&](slong prec) {
+      return approximateCcw(
+          Approximation<T>::arb(self.self->x, prec), Approximation<T>::arb(self.self->y, prec),
+          Approximation<T>::arb(other.self->x, prec), Approximation<T>::arb(other.self->y, prec), prec);
+    });
     if (maybeCcw)
       return *maybeCcw;
   }
@@ -438,7 +408,11 @@ ORIENTATION detail::VectorExact<Vector, T>::orientation(const Vector& other) con
   };
 
   if constexpr (IsEAntic<T> || IsExactReal<T>) {
-    const auto maybeOrientation = static_cast<flatsurf::Vector<exactreal::Arb>>(self).orientation(static_cast<flatsurf::Vector<exactreal::Arb>>(other));
+    const auto maybeOrientation = decideAdaptively(Statistics::PREDICATE::ORIENTATION, [&](slong prec) {
+      return approximateOrientation(
+          Approximation<T>::arb(self.self->x, prec), Approximation<T>::arb(self.self->y, prec),
+          Approximation<T>::arb(other.self->x, prec), Approximation<T>::arb(other.self->y, prec), prec);
+    });
     if (maybeOrientation)
       return *maybeOrientation;
   }
@@ -460,7 +434,9 @@ bool detail::VectorExact<Vector, T>::operator>(Bound bound) const {
   if (!bound) return static_cast<bool>(self);
 
   if constexpr (IsEAntic<T> || IsExactReal<T>) {
-    const auto maybe = static_cast<flatsurf::Vector<exactreal::Arb>>(self) > bound;
+    const auto maybe = decideAdaptively(Statistics::PREDICATE::BOUND, [&](slong prec) {
+      return approximateNorm(Approximation<T>::arb(self.self->x, prec), Approximation<T>::arb(self.self->y, prec), prec) > bound.squared();
+    });
     if (maybe)
       return *maybe;
   }
@@ -475,7 +451,9 @@ bool detail::VectorExact<Vector, T>::operator<(Bound bound) const {
   if (!bound) return false;
 
   if constexpr (IsEAntic<T> || IsExactReal<T>) {
-    const auto maybe = static_cast<flatsurf::Vector<exactreal::Arb>>(self) < bound;
+    const auto maybe = decideAdaptively(Statistics::PREDICATE::BOUND, [&](slong prec) {
+      return approximateNorm(Approximation<T>::arb(self.self->x, prec), Approximation<T>::arb(self.self->y, prec), prec) < bound.squared();
+    });
     if (maybe)
       return *maybe;
   }
@@ -589,11 +567,10 @@ bool detail::VectorExact<Vector, T>::CompareSlope::operator()(const Vector& lhs,
 
 template <typename Vector, typename T>
 bool detail::VectorExact<Vector, T>::CompareLength::operator()(const Vector& lhs, const Vector& rhs) const {
-  if (IsEAntic<T> || IsExactReal<T>) {
-    const auto lhsArb = static_cast<flatsurf::Vector<exactreal::Arb>>(lhs);
-    const auto rhsArb = static_cast<flatsurf::Vector<exactreal::Arb>>(rhs);
-
-    const auto maybe = lhsArb * lhsArb < rhsArb * rhsArb;
+  if constexpr (IsEAntic<T> || IsExactReal<T>) {
+    const auto maybe = decideAdaptively(Statistics::PREDICATE::LENGTH, [&](slong prec) {
+      return approximateNorm(Approximation<T>::arb(lhs.self->x, prec), Approximation<T>::arb(lhs.self->y, prec), prec) < approximateNorm(Approximation<T>::arb(rhs.self->x, prec), Approximation<T>::arb(rhs.self->y, prec), prec);
+    });
     if (maybe)
       return *maybe;
   }
@@ -616,6 +593,12 @@ ImplementationOf<Vector<T>>::ImplementationOf(T&& x, T&& y) :
   x(std::move(x)),
   y(std::move(y)) {}
 
+template <typename T>
+size_t ImplementationOf<Vector<T>>::allocated(const Vector<T>& self) {
+  using flatsurf::allocated;
+  return sizeof(ImplementationOf) + allocated(self.self->x) + allocated(self.self->y);
+}
+
 template <typename T>
 std::ostream& operator<<(std::ostream& os, const Vector<T>& self) {
   return os << "(" << self.self->x << ", " << self.self->y << ")";
@@ -656,6 +639,7 @@ size_t hash<Vector<T>>::operator()(const Vector<T>& self) const {
 LIBFLATSURF_INSTANTIATE_MANY((LIBFLATSURF_INSTANTIATE_THIS), LIBFLATSURF_REAL_TYPES)
 
 template class ::flatsurf::Vector<exactreal::Arb>;
+template class ::flatsurf::ImplementationOf<::flatsurf::Vector<exactreal::Arb>>;
 template class ::flatsurf::detail::VectorWithError<::flatsurf::Vector<exactreal::Arb>>;
 template class ::flatsurf::detail::VectorBase<::flatsurf::Vector<exactreal::Arb>>;
 template std::ostream& ::flatsurf::operator<<(std::ostream&, const ::flatsurf::Vector<exactreal::Arb>&);
@@ -19,31 +19,107 @@
 
 #include "../flatsurf/vertical.hpp"
 
+#include <algorithm>
 #include <intervalxt/interval_exchange_transformation.hpp>
 #include <intervalxt/label.hpp>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "../flatsurf/ccw.hpp"
-#include "../flatsurf/edge_map.hpp"
 #include "../flatsurf/flat_triangulation.hpp"
 #include "../flatsurf/flat_triangulation_collapsed.hpp"
 #include "../flatsurf/half_edge.hpp"
 #include "../flatsurf/interval_exchange_transformation.hpp"
-#include "../flatsurf/odd_half_edge_map.hpp"
 #include "../flatsurf/orientation.hpp"
 #include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/vector.hpp"
+#include "impl/flat_triangulation_combinatorial.impl.hpp"
+#include "impl/vector.impl.hpp"
 #include "impl/vertical.impl.hpp"
+#include "impl/vertical_cache.hpp"
 #include "util/assert.ipp"
+#include "util/hash.ipp"
+#include "util/parallel.ipp"
 
 using std::ostream;
 using namespace flatsurf;
 
 namespace flatsurf {
 
+namespace {
+
+// The states of the tracked Verticals of this thread, indexed by the
+// underlying surface and the vertical direction.
+template <typename Surface>
+class Registry {
+  using T = typename Surface::Coordinate;
+  using Key = std::tuple<const void*, Vector<T>>;
+
+  struct Hash {
+    size_t operator()(const Key& key) const {
+      return hash_combine(std::get<0>(key), std::get<1>(key));
+    }
+  };
+
+ public:
+  static std::shared_ptr<ImplementationOf<Vertical<Surface>>> lookup(const Surface& surface, const Vector<T>& vertical) {
+    const auto entry = registry().find(Key(identity(surface), vertical));
+    if (entry == registry().end())
+      return nullptr;
+    return entry->second.lock();
+  }
+
+  // Return the states of the Verticals on this surface that are still alive.
+  static std::vector<std::shared_ptr<ImplementationOf<Vertical<Surface>>>> alive(const Surface& surface) {
+    std::vector<std::shared_ptr<ImplementationOf<Vertical<Surface>>>> states;
+    for (const auto& [key, state] : registry())
+      if (std::get<0>(key) == identity(surface))
+        if (auto locked = state.lock())
+          states.push_back(std::move(locked));
+    return states;
+  }
+
+  static void insert(const Surface& surface, const Vector<T>& vertical, const std::shared_ptr<ImplementationOf<Vertical<Surface>>>& state) {
+    auto& registry = Registry::registry();
+
+    registry[Key(identity(surface), vertical)] = state;
+
+    // Every now and then, drop the entries of Verticals that have been
+    // destroyed.
+    thread_local size_t sweep = 64;
+    if (registry.size() >= sweep) {
+      for (auto it = registry.begin(); it != registry.end();) {
+        if (it->second.expired())
+          it = registry.erase(it);
+        else
+          ++it;
+      }
+      sweep = std::max<size_t>(64, 2 * registry.size());
+    }
+  }
+
+ private:
+  static const void* identity(const Surface& surface) {
+    return ImplementationOf<FlatTriangulationCombinatorial>::self(static_cast<const FlatTriangulationCombinatorial&>(surface)).state.get();
+  }
+
+  static std::unordered_map<Key, std::weak_ptr<ImplementationOf<Vertical<Surface>>>, Hash>& registry() {
+    // Since coordinates are not thread-safe in general, we keep a separate
+    // registry for every thread.
+    thread_local std::unordered_map<Key, std::weak_ptr<ImplementationOf<Vertical<Surface>>>, Hash> registry;
+    return registry;
+  }
+};
+
+}  // namespace
+
 template <typename Surface>
 Vertical<Surface>::Vertical(const Surface& surface, const Vector<T>& vertical) :
-  self(std::make_shared<ImplementationOf<Vertical>>(surface, vertical)) {}
+  self(ImplementationOf<Vertical>::shared(surface, vertical)) {}
 
 template <typename Surface>
 std::vector<std::unordered_set<HalfEdge>> Vertical<Surface>::components() const {
@@ -65,26 +141,43 @@ std::vector<std::unordered_set<HalfEdge>> Vertical<Surface>::components() const
 
 template <typename Surface>
 bool Vertical<Surface>::large(HalfEdge e) const {
-  if (!(*self->largenessCache)[e]) {
-    auto length = [&](const HalfEdge edge) {
-      auto ret = projectPerpendicular(edge);
-      return ret > 0 ? ret : -ret;
-    };
-    auto len = length(e);
-    (*self->largenessCache)[e] =
-        len >= length(self->surface->nextInFace(e)) &&
-        len >= length(self->surface->previousInFace(e)) &&
-        len >= length(self->surface->nextInFace(-e)) &&
-        len >= length(self->surface->previousInFace(-e));
+  {
+    const auto cached = lockCaches<T>(self->caches);
+    const auto& cache = self->cache();
+    if (cache.has(e, VerticalCache<T>::HAS_LARGE))
+      return cache.getLarge(e);
   }
-  return *(*self->largenessCache)[e];
+
+  auto length = [&](const HalfEdge edge) {
+    auto ret = projectPerpendicular(edge);
+    return ret > 0 ? ret : -ret;
+  };
+  auto len = length(e);
+  const bool value =
+      len >= length(self->surface->nextInFace(e)) &&
+      len >= length(self->surface->previousInFace(e)) &&
+      len >= length(self->surface->nextInFace(-e)) &&
+      len >= length(self->surface->previousInFace(-e));
+
+  const auto cached = lockCaches<T>(self->caches);
+  self->cache().setLarge(e, value);
+  return value;
 }
 
 template <typename Surface>
 typename Surface::Coordinate Vertical<Surface>::projectPerpendicular(HalfEdge he) const {
-  if (!self->perpendicularProjectionCache->get(he))
-    self->perpendicularProjectionCache->set(he, projectPerpendicular(self->surface->fromHalfEdge(he)));
-  return *self->perpendicularProjectionCache->get(he);
+  {
+    const auto cached = lockCaches<T>(self->caches);
+    const auto& cache = self->cache();
+    if (cache.has(he, VerticalCache<T>::HAS_PERPENDICULAR))
+      return cache.getPerpendicular(he);
+  }
+
+  auto value = projectPerpendicular(self->surface->fromHalfEdge(he));
+
+  const auto cached = lockCaches<T>(self->caches);
+  self->cache().setPerpendicular(he, value);
+  return value;
 }
 
 template <typename Surface>
@@ -94,9 +187,18 @@ typename Surface::Coordinate Vertical<Surface>::projectPerpendicular(const Vecto
 
 template <typename Surface>
 typename Surface::Coordinate Vertical<Surface>::project(HalfEdge he) const {
-  if (!self->parallelProjectionCache->get(he))
-    self->parallelProjectionCache->set(he, project(self->surface->fromHalfEdge(he)));
-  return *self->parallelProjectionCache->get(he);
+  {
+    const auto cached = lockCaches<T>(self->caches);
+    const auto& cache = self->cache();
+    if (cache.has(he, VerticalCache<T>::HAS_PROJECT))
+      return cache.getProject(he);
+  }
+
+  auto value = project(self->surface->fromHalfEdge(he));
+
+  const auto cached = lockCaches<T>(self->caches);
+  self->cache().setProject(he, value);
+  return value;
 }
 
 template <typename Surface>
@@ -106,9 +208,18 @@ typename Surface::Coordinate Vertical<Surface>::project(const Vector<T>& v) cons
 
 template <typename Surface>
 ORIENTATION Vertical<Surface>::orientation(HalfEdge he) const {
-  if (!self->orientationCache->get(he))
-    self->orientationCache->set(he, orientation(self->surface->fromHalfEdge(he)));
-  return *self->orientationCache->get(he);
+  {
+    const auto cached = lockCaches<T>(self->caches);
+    const auto& cache = self->cache();
+    if (cache.has(he, VerticalCache<T>::HAS_ORIENTATION))
+      return cache.getOrientation(he);
+  }
+
+  auto value = orientation(self->surface->fromHalfEdge(he));
+
+  const auto cached = lockCaches<T>(self->caches);
+  self->cache().setOrientation(he, value);
+  return value;
 }
 
 template <typename Surface>
@@ -118,9 +229,18 @@ ORIENTATION Vertical<Surface>::orientation(const Vector<T>& v) const {
 
 template <typename Surface>
 CCW Vertical<Surface>::ccw(HalfEdge he) const {
-  if (!self->ccwCache->get(he))
-    self->ccwCache->set(he, ccw(self->surface->fromHalfEdge(he)));
-  return *self->ccwCache->get(he);
+  {
+    const auto cached = lockCaches<T>(self->caches);
+    const auto& cache = self->cache();
+    if (cache.has(he, VerticalCache<T>::HAS_CCW))
+      return cache.getCCW(he);
+  }
+
+  auto value = ccw(self->surface->fromHalfEdge(he));
+
+  const auto cached = lockCaches<T>(self->caches);
+  self->cache().setCCW(he, value);
+  return value;
 }
 
 template <typename Surface>
@@ -198,30 +318,86 @@ ImplementationOf<Vertical<Surface>>::ImplementationOf(const Surface& surface, co
   surface(surface),
   vertical(vertical),
   horizontal(-vertical.perpendicular()),
-  parallelProjectionCache(
-      surface, OddHalfEdgeMap<std::optional<T>>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.set(flip, std::nullopt); }, [](auto& cache, const auto&, Edge collapse) { cache.set(collapse.positive(), T()); }),
-  perpendicularProjectionCache(
-      surface, OddHalfEdgeMap<std::optional<T>>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.set(flip, std::nullopt); }, [](auto& cache, const auto&, Edge collapse) { ASSERT(!cache.get(collapse.positive()) || !*cache.get(collapse.positive()), "cannot collapse non-vertical edges"); }),
-  ccwCache(
-      surface, OddHalfEdgeMap<std::optional<CCW>>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.set(flip, std::nullopt); }, [](auto& cache, const auto&, Edge collapse) { ASSERT(!cache.get(collapse.positive()) || *cache.get(collapse.positive()) == CCW::COLLINEAR, "cannot collapse non-collinear edges"); }),
-  orientationCache(
-      surface, OddHalfEdgeMap<std::optional<ORIENTATION>>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.set(flip, std::nullopt); },
-      // intentionally empty: when collapsing an Edge we won't reason about its orientation anymore
-      [](auto&, const auto&, Edge) {}),
-  lengthCache(
-      surface, EdgeMap<std::optional<T>>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache[flip] = std::nullopt; }, [](auto& cache, const auto&, Edge collapse) { ASSERT(!cache[collapse] || !*cache[collapse], "cannot collapse non-vertical edges"); }),
-  largenessCache(
-      surface, EdgeMap<std::optional<bool>>(surface), [](auto& cache, const auto& surface, HalfEdge flip) {
-    cache[flip]= std::nullopt;
-    cache[surface.nextInFace(flip)] = std::nullopt;
-    cache[surface.previousInFace(flip)] = std::nullopt;
-    cache[surface.nextInFace(-flip)] = std::nullopt;
-    cache[surface.previousInFace(-flip)] = std::nullopt; },
-      // intentionally empty: when collapsing an Edge we won't reason about it's largeness anymore
-      [](auto&, const auto&, Edge) {}) {
+  storage(std::in_place_type<Tracked<VerticalCache<T>>>,
+      surface, VerticalCache<T>(surface),
+      [](auto& cache, const auto& surface, HalfEdge flip) {
+        cache.forget(flip);
+        cache.forgetLarge(surface.nextInFace(flip));
+        cache.forgetLarge(surface.previousInFace(flip));
+        cache.forgetLarge(surface.nextInFace(-flip));
+        cache.forgetLarge(surface.previousInFace(-flip));
+      },
+      [](auto& cache, const auto&, Edge collapse) {
+        const HalfEdge e = collapse.positive();
+        ASSERT(!cache.has(e, VerticalCache<T>::HAS_PERPENDICULAR) || !cache.getPerpendicular(e), "cannot collapse non-vertical edges");
+        ASSERT(!cache.has(e, VerticalCache<T>::HAS_CCW) || cache.getCCW(e) == CCW::COLLINEAR, "cannot collapse non-collinear edges");
+        // When collapsing an Edge we won't reason about its orientation or
+        // largeness anymore.
+        cache.setProject(e, T());
+      },
+      [](auto& cache, const auto&, HalfEdge a, HalfEdge b) {
+        if (a == b) return;
+        if (a == -b)
+          cache.set(a, cache.get(b));
+        else {
+          const auto tmp = cache.get(a);
+          cache.set(a, cache.get(b));
+          cache.set(b, tmp);
+        }
+      },
+      [](auto& cache, const auto&, const std::vector<Edge>& erase) {
+        for (auto e : erase) {
+          ASSERT(e.index() >= cache.size() - erase.size(), "Can only erase Edges of maximal index from a Vertical but " << e << " is not maximal.");
+          cache.pop();
+        }
+      }) {
   CHECK_ARGUMENT(vertical, "vertical must be non-zero");
 }
 
+template <typename Surface>
+ImplementationOf<Vertical<Surface>>::ImplementationOf(const Surface& surface, const Vector<T>& vertical, std::false_type) :
+  surface(surface),
+  vertical(vertical),
+  horizontal(-vertical.perpendicular()),
+  storage(std::in_place_type<VerticalCache<T>>, surface) {
+  CHECK_ARGUMENT(vertical, "vertical must be non-zero");
+}
+
+template <typename Surface>
+std::shared_ptr<ImplementationOf<Vertical<Surface>>> ImplementationOf<Vertical<Surface>>::shared(const Surface& surface, const Vector<T>& vertical) {
+  if (auto state = Registry<Surface>::lookup(surface, vertical))
+    return state;
+
+  auto state = std::make_shared<ImplementationOf>(surface, vertical);
+  Registry<Surface>::insert(surface, vertical, state);
+  return state;
+}
+
+template <typename Surface>
+Vertical<Surface> ImplementationOf<Vertical<Surface>>::view(const Surface& surface, const Vector<T>& vertical) {
+  if (auto state = Registry<Surface>::lookup(surface, vertical))
+    return from_this(state);
+
+  return from_this(std::make_shared<ImplementationOf>(surface, vertical, std::false_type{}));
+}
+
+template <typename Surface>
+size_t ImplementationOf<Vertical<Surface>>::allocated(const Surface& surface) {
+  size_t bytes = 0;
+  for (const auto& state : Registry<Surface>::alive(surface)) {
+    const auto cached = lockCaches<T>(state->caches);
+    bytes += sizeof(ImplementationOf) + ImplementationOf<Vector<T>>::allocated(state->vertical) + ImplementationOf<Vector<T>>::allocated(state->horizontal) + state->cache().allocated();
+  }
+  return bytes;
+}
+
+template <typename Surface>
+VerticalCache<typename Surface::Coordinate>& ImplementationOf<Vertical<Surface>>::cache() const {
+  if (auto* tracked = std::get_if<Tracked<VerticalCache<T>>>(&storage))
+    return **tracked;
+  return std::get<VerticalCache<T>>(storage);
+}
+
 template <typename Surface>
 bool ImplementationOf<Vertical<Surface>>::visit(const Vertical& self, HalfEdge start, std::unordered_set<HalfEdge>& component, std::function<bool(HalfEdge)> visitor) {
   if (component.find(start) != component.end())
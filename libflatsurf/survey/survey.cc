@@ -0,0 +1,348 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+// A survey driver that explores many surfaces in parallel without any
+// Python in the loop.
+//
+// The surfaces are read from one or more FlatTriangulationLibrary files, e.g.,
+// as written by pyflatsurf/survey/triangle.py --write. For each surface, we
+// determine the directions of the saddle connections up to a bound and then
+// decompose the surface into flow components in each of these directions.
+// The (surface, direction) jobs are distributed over a pool of threads. For
+// each job, a line with the outcome of the decomposition and its timing is
+// written as tab separated values.
+//
+// Each thread opens its own copy of the libraries. Therefore, threads never
+// share any coordinates; in particular they do not share number fields whose
+// elements are not safe to use from several threads at once. Directions are
+// passed between threads as the integer coefficients of a saddle connection's
+// chain which each thread turns back into a vector in its own copy of the
+// surface.
+
+#include <atomic>
+#include <boost/logic/tribool.hpp>
+#include <chrono>
+#include <e-antic/renfxx.h>
+#include <exception>
+#include <fstream>
+#include <gmpxx.h>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/ccw.hpp"
+#include "../flatsurf/chain.hpp"
+#include "../flatsurf/chain_iterator.hpp"
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flat_triangulation_library.hpp"
+#include "../flatsurf/flat_triangulation_view.hpp"
+#include "../flatsurf/flow_component.hpp"
+#include "../flatsurf/flow_decomposition.hpp"
+#include "../flatsurf/orientation.hpp"
+#include "../flatsurf/parallelism.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connections.hpp"
+#include "../flatsurf/saddle_connections_iterator.hpp"
+#include "../flatsurf/vector.hpp"
+
+namespace flatsurf::survey {
+
+struct Options {
+  std::vector<std::string> libraries;
+  std::string coordinates = "renf";
+  std::string output;
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  mpz_class bound = 16;
+  int limit = -1;
+};
+
+// A direction in which to decompose a surface, given by the coefficients of
+// the chain of a saddle connection in that direction, indexed by Edge::index().
+struct Job {
+  size_t library;
+  size_t surface;
+  std::vector<mpz_class> chain;
+};
+
+struct Result {
+  std::string direction;
+  size_t cylinders = 0;
+  size_t minimal = 0;
+  size_t undetermined = 0;
+  std::string completelyPeriodic;
+  std::string parabolic;
+  double milliseconds = 0;
+};
+
+std::string str(boost::logic::tribool value) {
+  if (value) return "true";
+  if (!value) return "false";
+  return "unknown";
+}
+
+// The state of a single thread: its own copy of the libraries and the surface
+// that it has worked on most recently.
+template <typename T>
+class Worker {
+ public:
+  explicit Worker(const Options& options) :
+    options(options) {}
+
+  const FlatTriangulation<T>& surface(size_t library, size_t surface) {
+    if (!cached || std::get<0>(*cached) != library || std::get<1>(*cached) != surface) {
+      auto opened = libraries.find(library);
+      if (opened == libraries.end())
+        opened = libraries.emplace(library, FlatTriangulationLibrary<T>(options.libraries[library])).first;
+      cached.emplace(library, surface, opened->second[surface].surface());
+    }
+    return std::get<2>(*cached);
+  }
+
+  const Options& options;
+
+ private:
+  std::map<size_t, FlatTriangulationLibrary<T>> libraries;
+  std::optional<std::tuple<size_t, size_t, FlatTriangulation<T>>> cached;
+};
+
+// Run task(worker, i) for all 0 ≤ i < n on a pool of threads that each have
+// their own worker. If any task throws, one of the exceptions is rethrown
+// here once all threads have finished.
+template <typename T, typename Task>
+void parallel(const Options& options, size_t n, Task&& task) {
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::atomic_flag failed = ATOMIC_FLAG_INIT;
+
+  const auto work = [&]() {
+    try {
+      Worker<T> worker(options);
+      for (size_t i = next++; i < n; i = next++)
+        task(worker, i);
+    } catch (...) {
+      if (!failed.test_and_set())
+        error = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < std::min(options.threads, n); t++)
+    pool.emplace_back(work);
+  work();
+  for (auto& thread : pool)
+    thread.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+// Return a job for each direction of a saddle connection of surface up to
+// the bound of the survey.
+template <typename T>
+std::vector<Job> directions(Worker<T>& worker, size_t library, size_t index) {
+  const auto& surface = worker.surface(library, index);
+
+  std::vector<Vector<T>> seen;
+  std::vector<Job> jobs;
+
+  for (const auto& connection : surface.connections().bound(Bound(worker.options.bound, 0))) {
+    const auto& vector = connection.vector();
+
+    bool known = false;
+    for (const auto& direction : seen)
+      if (direction.ccw(vector) == CCW::COLLINEAR && direction.orientation(vector) == ORIENTATION::SAME) {
+        known = true;
+        break;
+      }
+    if (known) continue;
+
+    seen.push_back(vector);
+
+    Job job{library, index, std::vector<mpz_class>(surface.edges().size())};
+    for (const auto& [edge, coefficient] : connection.chain())
+      job.chain[edge.index()] = *coefficient;
+    jobs.push_back(std::move(job));
+  }
+
+  return jobs;
+}
+
+template <typename T>
+Result decompose(Worker<T>& worker, const Job& job) {
+  const auto start = std::chrono::steady_clock::now();
+
+  const auto& surface = worker.surface(job.library, job.surface);
+
+  Vector<T> vertical;
+  for (const auto& edge : surface.edges())
+    vertical += surface.fromHalfEdge(edge.positive()) * job.chain[edge.index()];
+
+  using Surface = FlatTriangulation<T>;
+
+  auto decomposition = FlowDecomposition<Surface>(surface.clone(), vertical);
+  decomposition.decompose(FlowDecomposition<Surface>::defaultTarget, worker.options.limit);
+
+  Result result;
+
+  std::stringstream direction;
+  direction << vertical;
+  result.direction = direction.str();
+
+  for (const auto& component : decomposition.components()) {
+    if (component.cylinder())
+      result.cylinders++;
+    else if (component.withoutPeriodicTrajectory())
+      result.minimal++;
+    else
+      result.undetermined++;
+  }
+
+  result.completelyPeriodic = str(decomposition.completelyPeriodic());
+  result.parabolic = str(decomposition.parabolic());
+
+  result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  return result;
+}
+
+template <typename T>
+void survey(const Options& options, std::ostream& out) {
+  const auto start = std::chrono::steady_clock::now();
+
+  // Each job already runs on its own thread of the pool. Do not let
+  // libflatsurf start more threads per decomposition on top of that.
+  Parallelism::threads(1);
+
+  std::vector<std::pair<size_t, size_t>> surfaces;
+  for (size_t library = 0; library < options.libraries.size(); library++) {
+    const size_t size = FlatTriangulationLibrary<T>(options.libraries[library]).size();
+    for (size_t surface = 0; surface < size; surface++)
+      surfaces.emplace_back(library, surface);
+  }
+
+  std::vector<std::vector<Job>> directionsOfSurface(surfaces.size());
+  parallel<T>(options, surfaces.size(), [&](Worker<T>& worker, size_t i) {
+    directionsOfSurface[i] = directions(worker, surfaces[i].first, surfaces[i].second);
+  });
+
+  // Jobs for the same surface are consecutive so that the threads can
+  // mostly reuse the surface that they have decoded already.
+  std::vector<Job> jobs;
+  for (auto& directions : directionsOfSurface)
+    for (auto& job : directions)
+      jobs.push_back(std::move(job));
+
+  std::vector<Result> results(jobs.size());
+  parallel<T>(options, jobs.size(), [&](Worker<T>& worker, size_t i) {
+    results[i] = decompose(worker, jobs[i]);
+  });
+
+  out << "library\tsurface\tdirection\tcylinders\tminimal\tundetermined\tcompletely_periodic\tparabolic\tmilliseconds\n";
+  for (size_t i = 0; i < jobs.size(); i++) {
+    const auto& job = jobs[i];
+    const auto& result = results[i];
+    out << options.libraries[job.library] << "\t" << job.surface << "\t" << result.direction << "\t" << result.cylinders << "\t" << result.minimal << "\t" << result.undetermined << "\t" << result.completelyPeriodic << "\t" << result.parabolic << "\t" << result.milliseconds << "\n";
+  }
+
+  std::cerr << "Decomposed " << surfaces.size() << " surfaces in " << jobs.size() << " directions on " << options.threads << " threads in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << "s" << std::endl;
+}
+
+void usage(std::ostream& out) {
+  out << "Usage: survey [--threads N] [--bound B] [--limit L] [--coordinates renf|mpq|mpz|longlong] [--output FILE] LIBRARY..." << std::endl;
+}
+
+}  // namespace flatsurf::survey
+
+int main(int argc, char** argv) {
+  using namespace flatsurf::survey;
+
+  Options options;
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      const std::string arg = argv[i];
+      const auto value = [&]() -> std::string {
+        if (++i == argc) throw std::invalid_argument("missing value for " + arg);
+        return argv[i];
+      };
+
+      if (arg == "--help" || arg == "-h") {
+        usage(std::cout);
+        return 0;
+      } else if (arg == "--threads") {
+        options.threads = std::max(1ul, std::stoul(value()));
+      } else if (arg == "--bound") {
+        options.bound = mpz_class(value());
+      } else if (arg == "--limit") {
+        options.limit = std::stoi(value());
+      } else if (arg == "--coordinates") {
+        options.coordinates = value();
+      } else if (arg == "--output") {
+        options.output = value();
+      } else if (arg.rfind("--", 0) == 0) {
+        throw std::invalid_argument("unknown option " + arg);
+      } else {
+        options.libraries.push_back(arg);
+      }
+    }
+
+    if (options.libraries.empty())
+      throw std::invalid_argument("no library given");
+
+    std::ofstream file;
+    if (options.output.size()) {
+      file.open(options.output);
+      if (!file) throw std::invalid_argument("cannot write to " + options.output);
+    }
+    std::ostream& out = options.output.size() ? file : std::cout;
+
+    if (options.coordinates == "renf")
+      survey<eantic::renf_elem_class>(options, out);
+    else if (options.coordinates == "mpq")
+      survey<mpq_class>(options, out);
+    else if (options.coordinates == "mpz")
+      survey<mpz_class>(options, out);
+    else if (options.coordinates == "longlong")
+      survey<long long>(options, out);
+    else
+      throw std::invalid_argument("unsupported coordinates " + options.coordinates);
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "survey: " << e.what() << std::endl;
+    usage(std::cerr);
+    return 1;
+  } catch (const std::out_of_range& e) {
+    std::cerr << "survey: argument out of range: " << e.what() << std::endl;
+    usage(std::cerr);
+    return 1;
+  } catch (const std::exception& e) {
+    // E.g., a library that is missing or corrupt.
+    std::cerr << "survey: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -24,32 +24,35 @@
 #include "../flatsurf/vertical.hpp"
 #include "cereal.helpers.hpp"
 #include "external/catch2/single_include/catch2/catch.hpp"
+#include "external/cereal/include/cereal/archives/binary.hpp"
 #include "external/cereal/include/cereal/archives/json.hpp"
+#include "external/cereal/include/cereal/archives/portable_binary.hpp"
 #include "generators/saddle_connections_generator.hpp"
 #include "surfaces.hpp"
 
 namespace flatsurf::test {
 
-template <typename T>
+template <typename OutputArchive, typename InputArchive, typename T>
 static void testRoundtrip(const T& x) {
-  using cereal::JSONInputArchive;
-  using cereal::JSONOutputArchive;
-
   CAPTURE(printer<T>::toString(x));
 
   std::stringstream s;
 
   {
-    JSONOutputArchive archive(s);
+    OutputArchive archive(s);
     archive(cereal::make_nvp("test", x));
   }
 
-  INFO("Serialized to " << s.str());
+  if constexpr (cereal::traits::is_text_archive<OutputArchive>::value) {
+    INFO("Serialized to " << s.str());
+  } else {
+    INFO("Serialized to " << s.str().size() << " bytes");
+  }
 
   auto y = factory<T>::make();
 
   {
-    JSONInputArchive archive(s);
+    InputArchive archive(s);
     archive(cereal::make_nvp("test", *y));
   }
 
@@ -58,6 +61,48 @@ static void testRoundtrip(const T& x) {
   REQUIRE(comparer<T>::eq(x, *y));
 }
 
+template <typename T>
+static void testRoundtrip(const T& x) {
+  testRoundtrip<cereal::JSONOutputArchive, cereal::JSONInputArchive>(x);
+  testRoundtrip<cereal::BinaryOutputArchive, cereal::BinaryInputArchive>(x);
+  testRoundtrip<cereal::PortableBinaryOutputArchive, cereal::PortableBinaryInputArchive>(x);
+}
+
+TEST_CASE("Portable Binary Serialization of Integers", "[cereal]") {
+  // -(2^64 + 2) is written as its signed number of 64 bit words followed by
+  // the words of its absolute value, least significant word first.
+  const mpz_class x = -((mpz_class(1) << 64) + 2);
+
+  std::stringstream s;
+  {
+    cereal::PortableBinaryOutputArchive archive(s);
+    saveLimbs(archive, x);
+  }
+
+  // The portable archive writes a byte with the endianness of the archive first.
+  const std::string bytes = s.str().substr(1);
+  REQUIRE(bytes == std::string("\xfe\xff\xff\xff\xff\xff\xff\xff"
+                               "\x02\x00\x00\x00\x00\x00\x00\x00"
+                               "\x01\x00\x00\x00\x00\x00\x00\x00",
+                       24));
+
+  for (const auto& value : {mpz_class(), mpz_class(1), mpz_class(-1), x, mpz_class("123456789012345678901234567890123456789")}) {
+    std::stringstream t;
+    {
+      cereal::PortableBinaryOutputArchive archive(t);
+      saveLimbs(archive, value);
+    }
+
+    mpz_class y = 1337;
+    {
+      cereal::PortableBinaryInputArchive archive(t);
+      loadLimbs(archive, y);
+    }
+
+    REQUIRE(y == value);
+  }
+}
+
 TEST_CASE("Serialization of a HalfEdge", "[cereal]") {
   testRoundtrip(HalfEdge(1337));
 }
@@ -108,6 +153,30 @@ TEMPLATE_TEST_CASE("Serialization of a Chain", "[cereal]", (long long), (mpz_cla
   testRoundtrip(Chain(*square, HalfEdge(1)));
 }
 
+TEMPLATE_TEST_CASE("Serialization of a Chain with Large Coefficients", "[cereal]", (long long), (mpq_class), (renf_elem_class)) {
+  using R2 = Vector<TestType>;
+  auto square = makeSquare<R2>();
+
+  Chain chain(*square);
+  chain += (Chain(*square, HalfEdge(1)) *= mpz_class("123456789012345678901234567890"));
+  chain -= (Chain(*square, HalfEdge(3)) *= mpz_class("98765432109876543210"));
+
+  testRoundtrip(chain);
+}
+
+TEST_CASE("Serialization of Large Numbers", "[cereal]") {
+  testRoundtrip(Vector<mpz_class>(mpz_class("-123456789012345678901234567890"), mpz_class(0)));
+  testRoundtrip(Vector<mpq_class>(mpq_class("-1234567890123456789012/98765432109876543211"), mpq_class(1, 3)));
+  testRoundtrip(Vector<renf_elem_class>(renf_elem_class(*K, std::vector<mpz_class>{mpz_class("12345678901234567890123"), -7}) / 3, renf_elem_class(*K, 0)));
+}
+
+TEMPLATE_TEST_CASE("Serialization of a Larger FlatTriangulation", "[cereal]", (mpq_class), (renf_elem_class)) {
+  using R2 = Vector<TestType>;
+  auto L = makeL<R2>();
+
+  testRoundtrip(*L);
+}
+
 TEMPLATE_TEST_CASE("Serialization of a SaddleConnection", "[cereal]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
   using R2 = Vector<TestType>;
   auto square = makeSquare<R2>();
@@ -0,0 +1,178 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <complex>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/ccw.hpp"
+#include "../flatsurf/chain.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flow_decomposition.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/orientation.hpp"
+#include "../flatsurf/parallelism.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connections.hpp"
+#include "../flatsurf/saddle_connections_iterator.hpp"
+#include "../flatsurf/vector.hpp"
+#include "../flatsurf/vertical.hpp"
+#include "external/catch2/single_include/catch2/catch.hpp"
+#include "surfaces.hpp"
+
+namespace flatsurf::test {
+
+// Run task(thread) on several threads at once and wait for all of them.
+// Note that Catch's assertions are not thread-safe, so the tasks only
+// collect their results; they are checked once all threads have finished.
+template <typename Task>
+void concurrently(Task&& task) {
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < 8; thread++)
+    threads.emplace_back([&, thread]() { task(thread); });
+  for (auto& thread : threads)
+    thread.join();
+}
+
+TEMPLATE_TEST_CASE("Concurrent Queries of a Surface", "[concurrency]", (long long), (mpz_class), (mpq_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+  using Surface = FlatTriangulation<T>;
+
+  const auto surface = makeL<R2>();
+  const auto bound = Bound(16, 0);
+
+  GIVEN("The Surface " << *surface) {
+    THEN("Many Threads can Search for Saddle Connections at the Same Time") {
+      std::vector<R2> expected;
+      for (const auto& connection : surface->connections().bound(bound))
+        expected.push_back(connection.vector());
+
+      std::vector<std::vector<R2>> found(8);
+      concurrently([&](size_t thread) {
+        for (const auto& connection : surface->connections().bound(bound))
+          found[thread].push_back(connection.vector());
+      });
+
+      for (const auto& vectors : found)
+        REQUIRE(vectors == expected);
+    }
+
+    THEN("Many Threads can Query the Same Vertical at the Same Time") {
+      const auto direction = R2(13, 7);
+      const Vertical<Surface> vertical(*surface, direction);
+
+      const auto& halfEdges = surface->halfEdges();
+
+      std::vector<std::vector<std::tuple<CCW, ORIENTATION, T, T, bool>>> queried(8, std::vector<std::tuple<CCW, ORIENTATION, T, T, bool>>(halfEdges.size()));
+      concurrently([&](size_t thread) {
+        // Every thread starts at a different half edge so that the threads
+        // race to fill the same caches.
+        for (size_t i = 0; i < halfEdges.size(); i++) {
+          const size_t j = (i + thread) % halfEdges.size();
+          const auto halfEdge = halfEdges[j];
+          queried[thread][j] = std::tuple{vertical.ccw(halfEdge), vertical.orientation(halfEdge), vertical.project(halfEdge), vertical.projectPerpendicular(halfEdge), vertical.large(halfEdge)};
+        }
+      });
+
+      // Verticals in the same direction share their caches, so we compare
+      // to uncached computations and a vertical in a rescaled direction.
+      const Vertical<Surface> fresh(*surface, R2(26, 14));
+      for (const auto& results : queried) {
+        for (size_t i = 0; i < results.size(); i++) {
+          const auto halfEdge = halfEdges[i];
+          const auto v = surface->fromHalfEdge(halfEdge);
+          CAPTURE(halfEdge);
+          REQUIRE(results[i] == std::tuple{vertical.ccw(v), vertical.orientation(v), vertical.project(v), vertical.projectPerpendicular(v), fresh.large(halfEdge)});
+        }
+      }
+    }
+
+    THEN("Many Threads can Create and Destroy Verticals of the Same Surface") {
+      // Each Vertical tracks the surface, i.e., it connects to the surface
+      // when it is created and disconnects when it is destroyed. Threads
+      // share Verticals in the same direction, so some of these directions
+      // are the same in all threads and some are only used by one thread.
+      const auto query = [&](size_t thread, size_t i) {
+        const Vertical<Surface> vertical(*surface, R2(static_cast<int>(i % 2 ? i + 1 : (i + 1) * (thread + 2)), 1));
+        std::vector<CCW> ccws;
+        for (const auto halfEdge : surface->halfEdges())
+          ccws.push_back(vertical.ccw(halfEdge));
+        return ccws;
+      };
+
+      std::vector<std::vector<std::vector<CCW>>> queried(8);
+      concurrently([&](size_t thread) {
+        for (size_t i = 0; i < 64; i++)
+          queried[thread].push_back(query(thread, i));
+      });
+
+      for (size_t thread = 0; thread < 8; thread++)
+        for (size_t i = 0; i < 64; i++)
+          REQUIRE(queried[thread][i] == query(thread, i));
+    }
+
+    THEN("Many Threads can Read the Lazily Computed Vector of the Same Chain") {
+      // Build a chain whose vector is not up to date but has pending
+      // modifications that are only applied when it is read.
+      Chain<Surface> chain(*surface, HalfEdge(1));
+      R2 expected = surface->fromHalfEdge(HalfEdge(1));
+      for (const auto edge : surface->edges()) {
+        chain += edge.positive();
+        expected += surface->fromHalfEdge(edge.positive());
+      }
+
+      std::vector<R2> vectors(8);
+      std::vector<std::complex<double>> approximations(8);
+      concurrently([&](size_t thread) {
+        if (thread % 2)
+          approximations[thread] = static_cast<std::complex<double>>(static_cast<const Vector<exactreal::Arb>&>(chain));
+        vectors[thread] = static_cast<const R2&>(chain);
+      });
+
+      for (const auto& vector : vectors)
+        REQUIRE(vector == expected);
+      for (size_t thread = 1; thread < 8; thread += 2)
+        REQUIRE(approximations[thread] == static_cast<std::complex<double>>(expected));
+    }
+
+    THEN("Flow Decompositions do not Depend on the Number of Threads") {
+      const auto decompose = [&](unsigned threads) {
+        Parallelism::threads(threads);
+        FlowDecomposition<Surface> decomposition(surface->clone(), R2(13, 7));
+        decomposition.decompose();
+        std::stringstream printed;
+        printed << decomposition;
+        return printed.str();
+      };
+
+      const auto sequential = decompose(1);
+      const auto parallel = decompose(8);
+      Parallelism::threads(0);
+
+      REQUIRE(Parallelism::threads() >= 1);
+      REQUIRE(parallel == sequential);
+    }
+  }
+}
+
+}  // namespace flatsurf::test
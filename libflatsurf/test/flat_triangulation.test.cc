@@ -22,6 +22,7 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <complex>
 #include <exact-real/element.hpp>
 #include <exact-real/number_field.hpp>
 #include <numeric>
@@ -30,14 +31,17 @@
 #include "../flatsurf/deformation.hpp"
 #include "../flatsurf/delaunay.hpp"
 #include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flat_triangulation_combinatorial.hpp"
 #include "../flatsurf/half_edge.hpp"
 #include "../flatsurf/half_edge_set.hpp"
 #include "../flatsurf/interval_exchange_transformation.hpp"
 #include "../flatsurf/isomorphism.hpp"
+#include "../flatsurf/memory_usage.hpp"
 #include "../flatsurf/odd_half_edge_map.hpp"
 #include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/saddle_connections.hpp"
 #include "../flatsurf/vector.hpp"
+#include "../flatsurf/vertical.hpp"
 #include "../src/external/rx-ranges/include/rx/ranges.hpp"
 #include "external/catch2/single_include/catch2/catch.hpp"
 #include "generators/half_edge_generator.hpp"
@@ -70,6 +74,129 @@ TEMPLATE_TEST_CASE("Flip in a Flat Triangulation", "[flat_triangulation][flip]",
   }
 }
 
+TEMPLATE_TEST_CASE("Vertical Directions Follow Flips", "[flat_triangulation][flip][vertical]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
+  using R2 = Vector<TestType>;
+  auto square = makeSquare<R2>();
+
+  GIVEN("The Square " << *square) {
+    auto halfEdge = GENERATE(as<HalfEdge>{}, 1, 2, 3, -1, -2, -3);
+    const auto vertical = Vertical(*square, R2(1, 3));
+
+    const auto query = [&]() {
+      for (auto he : square->halfEdges()) {
+        const auto v = square->fromHalfEdge(he);
+        REQUIRE(vertical.ccw(he) == vertical.ccw(v));
+        REQUIRE(vertical.orientation(he) == vertical.orientation(v));
+        REQUIRE(vertical.project(he) == vertical.project(v));
+        REQUIRE(vertical.projectPerpendicular(he) == vertical.projectPerpendicular(v));
+        REQUIRE(vertical.large(he) == Vertical(*square, R2(3, 9)).large(he));
+      }
+    };
+
+    THEN("Cached Projections are Updated when Flipping " << halfEdge) {
+      query();
+      square->flip(halfEdge);
+      query();
+    }
+
+    THEN("Verticals in the Same Direction Agree") {
+      query();
+      const auto again = Vertical(*square, R2(1, 3));
+      REQUIRE(again == vertical);
+      for (auto he : square->halfEdges())
+        REQUIRE(again.projectPerpendicular(he) == vertical.projectPerpendicular(he));
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Memory Usage of a Flat Triangulation", "[flat_triangulation][memory_usage]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
+  using R2 = Vector<TestType>;
+  const auto square = makeSquare<R2>();
+
+  const auto usage = square->memoryUsage();
+  CAPTURE(usage);
+
+  REQUIRE(usage.surface > 0);
+  REQUIRE(usage.approximations > 0);
+  REQUIRE(usage.total() == usage.surface + usage.approximations + usage.vertical);
+
+  WHEN("A Vertical is Alive") {
+    const auto vertical = Vertical(*square, R2(1, 3));
+    for (auto halfEdge : square->halfEdges())
+      (void)vertical.projectPerpendicular(halfEdge);
+
+    THEN("Its Caches are Accounted for") {
+      REQUIRE(square->memoryUsage().vertical > usage.vertical);
+      REQUIRE(square->memoryUsage().surface == usage.surface);
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Approximate Vectors of a Flat Triangulation", "[flat_triangulation]", (long long), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>)) {
+  using R2 = Vector<TestType>;
+  const auto surface = makeL<R2>();
+
+  const auto approximates = [&](HalfEdge halfEdge) {
+    const auto approximation = static_cast<std::complex<double>>(surface->fromHalfEdgeApproximate(halfEdge));
+    const auto exact = static_cast<std::complex<double>>(surface->fromHalfEdge(halfEdge));
+    CAPTURE(halfEdge, approximation, exact);
+    return std::abs(approximation - exact) < 1e-9;
+  };
+
+  const auto halfEdge = GENERATE_COPY(halfEdges(surface));
+
+  const auto before = surface->memoryUsage().approximations;
+
+  REQUIRE(approximates(halfEdge));
+
+  // Approximations of machine integers and GMP types are computed eagerly,
+  // the others only when they are first requested.
+  if constexpr (std::is_same_v<TestType, long long> || std::is_same_v<TestType, mpq_class>)
+    REQUIRE(surface->memoryUsage().approximations == before);
+  else
+    REQUIRE(surface->memoryUsage().approximations > before);
+
+  if (surface->convex(halfEdge, true)) {
+    WHEN("We Flip " << halfEdge) {
+      surface->flip(halfEdge);
+
+      THEN("The Approximations Follow the Flip") {
+        for (const auto he : surface->halfEdges())
+          REQUIRE(approximates(he));
+      }
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Cyclic Covers of a Flat Triangulation", "[flat_triangulation][cover]", (long long), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto L = makeL<R2>();
+
+  const int degree = GENERATE(1, 2, 3, 7);
+
+  GIVEN("The Cyclic Cover of Degree " << degree << " of an L") {
+    const auto cover = makeCyclicCover(*L, degree);
+
+    CAPTURE(*cover);
+
+    THEN("It is an Unbranched Cover") {
+      REQUIRE(cover->size() == static_cast<size_t>(degree) * L->size());
+      REQUIRE(cover->area() == degree * L->area());
+      REQUIRE(cover->vertices().size() == static_cast<size_t>(degree));
+      for (const auto& vertex : cover->vertices())
+        REQUIRE(cover->angle(vertex) == 3);
+    }
+
+    if (degree == 1) {
+      THEN("It is the Original Surface") {
+        REQUIRE(*cover == *L);
+      }
+    }
+  }
+}
+
 TEMPLATE_TEST_CASE("Insert into a Flat Triangulation", "[flat_triangulation][insert][slit]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
   using R2 = Vector<TestType>;
 
@@ -350,6 +477,123 @@ TEMPLATE_TEST_CASE("Detect Isomorphic Surfaces", "[flat_triangulation][isomorphi
 
     REQUIRE(!(*surface)->isomorphism(scaled, isomorphism));
     REQUIRE((*surface)->isomorphism(scaled, isomorphism, [](const auto&, const auto&, const auto&, const auto&) { return true; }));
+
+    for (const auto filter : {ISOMORPHISM_FILTER::IDENTITY, ISOMORPHISM_FILTER::UNIMODULAR, ISOMORPHISM_FILTER::ORTHOGONAL, ISOMORPHISM_FILTER::SL2Z}) {
+      REQUIRE((*surface)->isomorphism(**surface, isomorphism, filter));
+      REQUIRE(!(*surface)->isomorphism(scaled, isomorphism, filter));
+    }
+
+    REQUIRE((*surface)->isomorphism(**surface, isomorphism, std::vector<Transformation>{Transformation{1, 0, 0, 1}}));
+    REQUIRE(!(*surface)->isomorphism(scaled, isomorphism, std::vector<Transformation>{Transformation{1, 0, 0, 1}}));
+    REQUIRE((*surface)->isomorphism(scaled, isomorphism, std::vector<Transformation>{Transformation{1, 0, 0, 1}, Transformation{2, 0, 0, 2}}));
+  }
+}
+
+TEMPLATE_TEST_CASE("Detect Reflected Surfaces", "[flat_triangulation][isomorphism]", (long long), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>)) {
+  using T = TestType;
+  using Transformation = std::tuple<T, T, T, T>;
+
+  const auto [name, surface] = GENERATE(makeSurface<T>());
+  const int delaunay = GENERATE(values({0, 1}));
+  const auto isomorphism = delaunay ? ISOMORPHISM::DELAUNAY_CELLS : ISOMORPHISM::FACES;
+
+  if (delaunay)
+    (*surface)->delaunay();
+
+  const FlatTriangulation<T>& original = **surface;
+
+  // The mirror image of the surface under (x, y) ↦ (-x, y). Each half edge
+  // keeps its label but ends up in the face of its negative, so if the
+  // Delaunay cells of the surface have different sizes, the cell of a half
+  // edge in the mirror image has a different number of sides than its cell
+  // in the surface.
+  std::vector<std::tuple<HalfEdge, HalfEdge, HalfEdge>> faces;
+  HalfEdgeSet done;
+  for (const auto he : original.halfEdges()) {
+    if (done.contains(he))
+      continue;
+    const auto a = he;
+    const auto b = original.nextInFace(a);
+    const auto c = original.nextInFace(b);
+    done.insert(a);
+    done.insert(b);
+    done.insert(c);
+    faces.emplace_back(-c, -b, -a);
+  }
+
+  const auto reflected = FlatTriangulation<T>(FlatTriangulationCombinatorial(faces), [&](HalfEdge he) {
+    const auto v = original.fromHalfEdge(he);
+    return Vector<T>(-v.x(), v.y());
+  });
+
+  // Return the matrices of all the isomorphisms from the surface to other
+  // whose determinant has the given sign.
+  const auto matrices = [&](const FlatTriangulation<T>& other, int sign) {
+    std::vector<Transformation> transformations;
+
+    Transformation candidate;
+    auto filter = [&](const T& a, const T& b, const T& c, const T& d) {
+      candidate = Transformation{a, b, c, d};
+      const T det = a * d - b * c;
+      if (sign > 0 ? det < T() : det > T())
+        return false;
+      return std::find(begin(transformations), end(transformations), candidate) == end(transformations);
+    };
+
+    while (original.isomorphism(other, isomorphism, filter))
+      transformations.push_back(candidate);
+
+    return transformations;
+  };
+
+  GIVEN("The Surface " << *name << " and its Mirror Image " << reflected) {
+    const auto reflections = matrices(reflected, -1);
+    REQUIRE(std::find(begin(reflections), end(reflections), Transformation{-1, 0, 0, 1}) != end(reflections));
+    REQUIRE(reflections.size() == matrices(original, 1).size());
+    REQUIRE(matrices(reflected, 1).size() == matrices(original, -1).size());
+  }
+}
+
+TEMPLATE_TEST_CASE("Canonical Form of Surfaces", "[flat_triangulation][isomorphism][canonical]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
+  using T = TestType;
+
+  const auto [name, surface] = GENERATE(makeSurface<T>());
+  const int delaunay = GENERATE(values({0, 1}));
+  const auto isomorphism = delaunay ? ISOMORPHISM::DELAUNAY_CELLS : ISOMORPHISM::FACES;
+
+  if (delaunay)
+    (*surface)->delaunay();
+
+  GIVEN("The Surface " << *name) {
+    const auto canonical = (*surface)->canonical(isomorphism);
+    CAPTURE(canonical.surface());
+
+    THEN("The Canonical Surface is Isomorphic to the Surface") {
+      REQUIRE((*surface)->isomorphism(canonical.surface(), isomorphism));
+      REQUIRE((*surface)->hash(isomorphism) == canonical.surface().hash(isomorphism));
+    }
+
+    THEN("The Canonical Surface is its own Canonical Surface") {
+      REQUIRE(canonical.surface().canonical(isomorphism).surface() == canonical.surface());
+    }
+
+    THEN("Only Translations are Supported") {
+      REQUIRE((*surface)->canonical(isomorphism, ISOMORPHISM_FILTER::IDENTITY).surface() == canonical.surface());
+      REQUIRE_THROWS_AS((*surface)->canonical(isomorphism, ISOMORPHISM_FILTER::ORTHOGONAL), std::logic_error);
+      REQUIRE_THROWS_AS((*surface)->hash(isomorphism, ISOMORPHISM_FILTER::SL2Z), std::logic_error);
+    }
+
+    if (delaunay) {
+      THEN("The Canonical Surface does not Depend on the Triangulation of the Delaunay Cells") {
+        auto flipped = (*surface)->clone();
+        for (auto edge : flipped.edges())
+          if (flipped.delaunay(edge) == DELAUNAY::AMBIGUOUS)
+            flipped.flip(edge.positive());
+
+        REQUIRE(flipped.canonical(isomorphism).surface() == canonical.surface());
+        REQUIRE(flipped.hash(isomorphism) == (*surface)->hash(isomorphism));
+      }
+    }
   }
 }
 
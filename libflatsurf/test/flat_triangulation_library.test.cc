@@ -0,0 +1,168 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Vincent Delecroix
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+
+#include <e-antic/renfxx.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flat_triangulation_library.hpp"
+#include "../flatsurf/flat_triangulation_view.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/vector.hpp"
+#include "external/catch2/single_include/catch2/catch.hpp"
+#include "surfaces.hpp"
+
+namespace flatsurf::test {
+
+namespace {
+
+// A temporary file that is removed when it goes out of scope.
+struct TemporaryFile {
+  TemporaryFile() {
+    char name[] = "/tmp/flatsurf-library-XXXXXX";
+    const int fd = mkstemp(name);
+    REQUIRE(fd != -1);
+    close(fd);
+    path = name;
+  }
+
+  ~TemporaryFile() { std::remove(path.c_str()); }
+
+  std::string path;
+};
+
+template <typename T>
+void checkView(const FlatTriangulationView<T>& view, const FlatTriangulation<T>& surface) {
+  REQUIRE(view.halfEdges() == surface.halfEdges());
+  for (auto halfEdge : surface.halfEdges()) {
+    REQUIRE(view.nextAtVertex(halfEdge) == surface.nextAtVertex(halfEdge));
+    REQUIRE(view.nextInFace(halfEdge) == surface.nextInFace(halfEdge));
+    REQUIRE(view.fromHalfEdge(halfEdge) == surface.fromHalfEdge(halfEdge));
+  }
+  REQUIRE(view.surface() == surface);
+}
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("Library of Flat Triangulations", "[flat_triangulation_library]", (long long), (mpz_class), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const std::vector<FlatTriangulation<T>> surfaces = {
+      makeSquare<R2>()->clone(),
+      makeL<R2>()->clone(),
+      makeMcMullenL3125<R2>()->clone(),
+  };
+
+  TemporaryFile file;
+  FlatTriangulationLibrary<T>::write(file.path, surfaces);
+
+  const FlatTriangulationLibrary<T> library(file.path);
+  REQUIRE(library.size() == surfaces.size());
+
+  for (size_t i = 0; i < surfaces.size(); i++)
+    checkView(library[i], surfaces[i]);
+
+  REQUIRE_THROWS_AS(library[surfaces.size()], std::invalid_argument);
+  REQUIRE_THROWS_AS(library[0].nextAtVertex(HalfEdge(1337)), std::invalid_argument);
+
+  SECTION("Libraries Cannot be Opened with the Wrong Coordinate Type") {
+    if constexpr (std::is_same_v<T, mpq_class>) {
+      REQUIRE_THROWS_AS(FlatTriangulationLibrary<long long>(file.path), std::invalid_argument);
+    } else {
+      REQUIRE_THROWS_AS(FlatTriangulationLibrary<mpq_class>(file.path), std::invalid_argument);
+    }
+  }
+
+  SECTION("Corrupt Libraries Cannot be Opened") {
+    std::ifstream in(file.path, std::ios::binary);
+    const std::string contents{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+
+    // Write contents with the word at index replaced by value and try to
+    // open the result and view its first surface. The offsets of the
+    // records follow the six words of the header.
+    const auto corrupt = [&](size_t index, uint64_t value) {
+      std::string corrupted = contents;
+      std::memcpy(corrupted.data() + index * sizeof(uint64_t), &value, sizeof(uint64_t));
+
+      TemporaryFile damaged;
+      std::ofstream(damaged.path, std::ios::binary) << corrupted;
+      return FlatTriangulationLibrary<T>(damaged.path)[0].surface();
+    };
+
+    uint64_t offsets[4];
+    std::memcpy(offsets, contents.data() + 6 * sizeof(uint64_t), sizeof(offsets));
+
+    REQUIRE_THROWS_AS(corrupt(6, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(corrupt(7, offsets[0]), std::invalid_argument);
+    REQUIRE_THROWS_AS(corrupt(8, offsets[3] + 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(corrupt(9, contents.size()), std::invalid_argument);
+    REQUIRE_THROWS_AS(corrupt(5, uint64_t(-1)), std::invalid_argument);
+
+    // The first record is the square with three edges: the number of edges,
+    // 2 × 6 half edge ids in 6 words, 4 offsets of vectors, and the vectors.
+    REQUIRE_NOTHROW(corrupt(offsets[0], 3));
+    REQUIRE_THROWS_AS(corrupt(offsets[0], 1337), std::invalid_argument);
+    REQUIRE_THROWS_AS(corrupt(offsets[0] + 1, 1337), std::invalid_argument);
+    REQUIRE_THROWS_AS(corrupt(offsets[0] + 7, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(corrupt(offsets[0] + 10, offsets[1]), std::invalid_argument);
+    if constexpr (!std::is_same_v<T, long long>)
+      REQUIRE_THROWS_AS(corrupt(offsets[0] + 11, uint64_t(1) << 40), std::invalid_argument);
+  }
+
+  SECTION("Empty Libraries") {
+    TemporaryFile empty;
+    FlatTriangulationLibrary<T>::write(empty.path, {});
+    REQUIRE(FlatTriangulationLibrary<T>(empty.path).size() == 0);
+  }
+}
+
+TEST_CASE("Library of Flat Triangulations over a Number Field", "[flat_triangulation_library]") {
+  using T = renf_elem_class;
+  using R2 = Vector<T>;
+
+  const std::vector<FlatTriangulation<T>> surfaces = {
+      make123<R2>()->clone(),
+      makeL<R2>()->clone(),
+      make123<R2>()->scale(mpz_class("1234567890123456789012345678901234567890")),
+  };
+
+  TemporaryFile file;
+  FlatTriangulationLibrary<T>::write(file.path, surfaces);
+
+  const FlatTriangulationLibrary<T> library(file.path);
+  REQUIRE(library.size() == surfaces.size());
+
+  for (size_t i = 0; i < surfaces.size(); i++)
+    checkView(library[i], surfaces[i]);
+
+  SECTION("Surfaces in a Library Must be Defined over the Same Number Field") {
+    TemporaryFile mixed;
+    REQUIRE_THROWS_AS(FlatTriangulationLibrary<T>::write(mixed.path, {make123<R2>()->clone(), makeOctagon<R2>()->clone()}), std::invalid_argument);
+  }
+}
+
+}  // namespace flatsurf::test
@@ -29,6 +29,7 @@
 #include "../flatsurf/flow_component.hpp"
 #include "../flatsurf/flow_decomposition.hpp"
 #include "../flatsurf/flow_triangulation.hpp"
+#include "../flatsurf/memory_usage.hpp"
 #include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/saddle_connections.hpp"
 #include "../flatsurf/vector.hpp"
@@ -62,6 +63,17 @@ TEST_CASE("Flow Decompositions Over Number Fields", "[flow_decomposition]") {
     REQUIRE(flowDecomposition.decompose());
 
     REQUIRE(flowDecomposition.components().size() == 5);
+
+    SECTION("Memory Usage is Accounted for by Category") {
+      const auto usage = flowDecomposition.memoryUsage();
+      CAPTURE(usage);
+
+      REQUIRE(usage.surface >= surface->memoryUsage().surface);
+      REQUIRE(usage.collapsed > 0);
+      REQUIRE(usage.decomposition > 0);
+      REQUIRE(usage.connections > 0);
+      REQUIRE(usage.chains > 0);
+    }
   }
 }
 
@@ -0,0 +1,221 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_TEST_RANDOM_SURFACES_HPP
+#define LIBFLATSURF_TEST_RANDOM_SURFACES_HPP
+
+#include <e-antic/renfxx.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "../flatsurf/ccw.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/vector.hpp"
+#include "surfaces.hpp"
+
+namespace flatsurf::test {
+
+// A source of random numbers which produces the same numbers for the same
+// seed on all platforms. (The distributions in <random> are implementation
+// defined, only the engines are not.)
+class RandomSource {
+ public:
+  explicit RandomSource(std::uint64_t seed) :
+    engine(seed) {}
+
+  // Return a random integer in [0, bound).
+  int below(int bound) {
+    return static_cast<int>(engine() % static_cast<std::uint64_t>(bound));
+  }
+
+  // Return a random integer in [lower, upper].
+  int between(int lower, int upper) {
+    return lower + below(upper - lower + 1);
+  }
+
+  // Return a random permutation of {0, …, size - 1}.
+  vector<int> permutation(int size) {
+    vector<int> permutation(size);
+    for (int i = 0; i < size; i++)
+      permutation[i] = i;
+    for (int i = size - 1; i > 0; i--)
+      std::swap(permutation[i], permutation[below(i + 1)]);
+    return permutation;
+  }
+
+  // Return a random permutation of {0, …, size - 1} that consists of a
+  // single cycle.
+  vector<int> cycle(int size) {
+    const auto order = permutation(size);
+    vector<int> cycle(size);
+    for (int i = 0; i < size; i++)
+      cycle[order[i]] = order[(i + 1) % size];
+    return cycle;
+  }
+
+ private:
+  std::mt19937_64 engine;
+};
+
+// Return a random connected cover of the given degree of a closed surface,
+// i.e., the sheets are glued by random permutations along the edges.
+template <typename T>
+auto makeRandomCover(const FlatTriangulation<T>& surface, int degree, std::uint64_t seed) {
+  RandomSource random(seed);
+
+  vector<vector<int>> sheets;
+  // Permuting all the sheets cyclically along the first edge makes sure
+  // that the cover is connected.
+  sheets.push_back(random.cycle(degree));
+  for (size_t e = 1; e < surface.size(); e++)
+    sheets.push_back(random.permutation(degree));
+
+  return makeCover(surface, sheets);
+}
+
+// Return a random origami, i.e., a connected cover of the square torus
+// branched over a single point, made up of the given number of unit squares.
+// Each square is cut along its diagonal into two triangles so the resulting
+// surface has three times as many edges as it has squares.
+template <typename R2>
+auto makeRandomOrigami(int squares, std::uint64_t seed) {
+  RandomSource random(seed);
+
+  // The square torus is made up of the triangles (1, 2, -3) and (-1, -2, 3)
+  // where 1 is the bottom edge, 2 the right edge, and 3 the diagonal of the
+  // square. So, crossing 1 leads into the square below and crossing 2 leads
+  // into the square to the right. The diagonal is never crossed when going
+  // from one square to another.
+  const auto below = random.permutation(squares);
+  const auto right = random.cycle(squares);
+  vector<int> diagonal(squares);
+  for (int i = 0; i < squares; i++)
+    diagonal[i] = i;
+
+  return makeCover(*makeSquare<R2>(), {below, right, diagonal});
+}
+
+// Return a random coordinate whose absolute value is roughly bounded by the
+// given bound. For number fields, the coordinate has an irrational part so
+// that arithmetic does not degenerate to rational arithmetic.
+template <typename T>
+T makeRandomCoordinate(RandomSource& random, int bound) {
+  if constexpr (std::is_same_v<T, eantic::renf_elem_class>) {
+    return renf_elem_class(K, random.between(-bound, bound)) + random.between(-bound, bound) * K->gen();
+  } else {
+    return static_cast<T>(random.between(-bound, bound));
+  }
+}
+
+// Return a random convex polygon with 2·pairs sides whose opposite sides are
+// glued, triangulated by the diagonals from one of its vertices. The
+// resulting surface has 3·pairs - 3 edges.
+template <typename R2>
+auto makeRandomPolygon(int pairs, std::uint64_t seed) {
+  using T = typename R2::Coordinate;
+
+  if (pairs < 2)
+    throw std::invalid_argument("polygon must have at least two pairs of sides");
+
+  RandomSource random(seed);
+
+  // The coordinates must not be too small so that there are enough distinct
+  // directions to choose from.
+  const int bound = 4 + 2 * static_cast<int>(std::sqrt(pairs));
+
+  // The sides of the polygon in the upper half plane, in counterclockwise
+  // order; the remaining sides are their negatives.
+  vector<R2> sides;
+  while (static_cast<int>(sides.size()) < pairs) {
+    while (static_cast<int>(sides.size()) < pairs) {
+      auto side = R2(makeRandomCoordinate<T>(random, bound), makeRandomCoordinate<T>(random, bound));
+      if (side.x() == 0 && side.y() == 0)
+        continue;
+      if (side.y() < 0 || (side.y() == 0 && side.x() < 0))
+        side = -side;
+      sides.push_back(side);
+    }
+
+    std::sort(begin(sides), end(sides), [](const auto& lhs, const auto& rhs) { return lhs.ccw(rhs) == CCW::COUNTERCLOCKWISE; });
+    sides.erase(std::unique(begin(sides), end(sides), [](const auto& lhs, const auto& rhs) { return lhs.ccw(rhs) == CCW::COLLINEAR; }), end(sides));
+  }
+
+  // The half edge going along the side of the polygon from its vertex P_j to
+  // its vertex P_{j+1}. The sides j and j + pairs are glued to form the edge
+  // j + 1.
+  const auto side = [&](int j) {
+    return j < pairs ? HalfEdge(j + 1) : -HalfEdge(j - pairs + 1);
+  };
+
+  // The half edge going along the diagonal from P_0 to P_j for 2 ≤ j ≤ 2·pairs - 2.
+  const auto diagonal = [&](int j) {
+    return HalfEdge(pairs + j - 1);
+  };
+
+  vector<std::tuple<HalfEdge, HalfEdge, HalfEdge>> faces;
+  for (int j = 1; j < 2 * pairs - 1; j++)
+    faces.push_back({j == 1 ? side(0) : diagonal(j), side(j), j + 1 == 2 * pairs - 1 ? side(j + 1) : -diagonal(j + 1)});
+
+  vector<R2> vectors = sides;
+  R2 vertex = sides[0];
+  for (int j = 2; j < 2 * pairs - 1; j++) {
+    vertex += j - 1 < pairs ? sides[j - 1] : -sides[j - 1 - pairs];
+    vectors.push_back(vertex);
+  }
+
+  return std::make_shared<FlatTriangulation<T>>(FlatTriangulationCombinatorial(faces), vectors);
+}
+
+// The kinds of random surfaces that can be created by makeRandomSurface().
+enum class RANDOM_SURFACE {
+  // A random origami, see makeRandomOrigami().
+  ORIGAMI,
+  // A random polygon with opposite sides glued, see makeRandomPolygon().
+  POLYGON,
+  // A random cover of a random polygon with eight sides.
+  COVER,
+};
+
+// Return a random surface of the given kind with roughly the given number of
+// edges. The same seed always produces the same surface.
+template <typename R2>
+auto makeRandomSurface(RANDOM_SURFACE kind, int edges, std::uint64_t seed = 1337) {
+  switch (kind) {
+    case RANDOM_SURFACE::ORIGAMI:
+      return makeRandomOrigami<R2>(std::max(1, edges / 3), seed);
+    case RANDOM_SURFACE::POLYGON:
+      return makeRandomPolygon<R2>(std::max(2, edges / 3 + 1), seed);
+    case RANDOM_SURFACE::COVER:
+      return makeRandomCover(*makeRandomPolygon<R2>(4, seed), std::max(1, edges / 9), seed);
+    default:
+      throw std::logic_error("unknown kind of random surface");
+  }
+}
+
+}  // namespace flatsurf::test
+
+#endif
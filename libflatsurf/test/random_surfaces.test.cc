@@ -0,0 +1,69 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <e-antic/renfxx.h>
+
+#include <exact-real/element.hpp>
+#include <exact-real/integer_ring.hpp>
+#include <unordered_set>
+#include <vector>
+
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/vector.hpp"
+#include "external/catch2/single_include/catch2/catch.hpp"
+#include "random_surfaces.hpp"
+
+namespace flatsurf::test {
+
+TEMPLATE_TEST_CASE("Random Surfaces", "[random_surfaces]", (long long), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto kind = GENERATE(RANDOM_SURFACE::ORIGAMI, RANDOM_SURFACE::POLYGON, RANDOM_SURFACE::COVER);
+  const int edges = GENERATE(10, 100, 1000);
+
+  GIVEN("A Random Surface of Kind " << static_cast<int>(kind) << " with about " << edges << " Edges") {
+    const auto surface = makeRandomSurface<R2>(kind, edges);
+
+    THEN("It has Roughly the Requested Size") {
+      REQUIRE(surface->size() <= static_cast<size_t>(edges));
+      REQUIRE(surface->size() + 9 > static_cast<size_t>(edges));
+    }
+
+    THEN("It is Connected") {
+      std::unordered_set<HalfEdge> reached{HalfEdge(1)};
+      std::vector<HalfEdge> pending{HalfEdge(1)};
+      while (!pending.empty()) {
+        const auto he = pending.back();
+        pending.pop_back();
+        for (const auto next : {-he, surface->nextInFace(he)})
+          if (reached.insert(next).second)
+            pending.push_back(next);
+      }
+      REQUIRE(reached.size() == surface->halfEdges().size());
+    }
+
+    THEN("It is Reproducible") {
+      REQUIRE(*surface == *makeRandomSurface<R2>(kind, edges));
+    }
+  }
+}
+
+}  // namespace flatsurf::test
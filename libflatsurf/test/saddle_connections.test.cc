@@ -21,8 +21,10 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <complex>
 #include <exact-real/element.hpp>
 #include <exact-real/number_field.hpp>
+#include <sstream>
 #include <unordered_set>
 
 #include "../flatsurf/bound.hpp"
@@ -35,9 +37,12 @@
 #include "../flatsurf/saddle_connections.hpp"
 #include "../flatsurf/saddle_connections_by_length.hpp"
 #include "../flatsurf/saddle_connections_by_length_iterator.hpp"
+#include "../flatsurf/saddle_connections_export.hpp"
 #include "../flatsurf/saddle_connections_iterator.hpp"
+#include "../flatsurf/saddle_connections_reader.hpp"
 #include "../flatsurf/saddle_connections_sample.hpp"
 #include "../flatsurf/saddle_connections_sample_iterator.hpp"
+#include "../flatsurf/saddle_connections_writer.hpp"
 #include "../flatsurf/vector.hpp"
 #include "external/catch2/single_include/catch2/catch.hpp"
 #include "generators/saddle_connections_generator.hpp"
@@ -261,4 +266,131 @@ TEMPLATE_TEST_CASE("Saddle Connections on a Surface", "[saddle_connections]", (l
     }
   }
 }
+
+TEMPLATE_TEST_CASE("Streaming Saddle Connections", "[saddle_connections][writer][reader]", (long long), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::NumberField>)) {
+  using T = TestType;
+  using Surface = FlatTriangulation<T>;
+
+  const auto [name, surface_] = GENERATE(makeSurface<T>());
+  const auto surface = *surface_;
+  const auto bound = 8;
+
+  CAPTURE(*name);
+
+  const auto chains = GENERATE(true, false);
+  const auto background = GENERATE(true, false);
+
+  std::stringstream stream;
+
+  std::vector<SaddleConnection<Surface>> expected;
+  for (const auto& connection : surface->connections().bound(bound).byLength())
+    expected.push_back(connection);
+
+  {
+    SaddleConnectionsWriter<Surface> writer(stream, chains, background);
+    writer << surface->connections().bound(bound).byLength();
+    REQUIRE(writer.size() == expected.size());
+    writer.flush();
+  }
+
+  SaddleConnectionsReader reader(*surface, stream);
+  REQUIRE(reader.chains() == chains);
+
+  for (const auto& connection : expected) {
+    REQUIRE(reader.next());
+    REQUIRE(reader.source() == connection.source());
+    REQUIRE(reader.target() == connection.target());
+    if (chains)
+      REQUIRE(reader.connection() == connection);
+    else
+      REQUIRE_THROWS_AS(reader.connection(), std::invalid_argument);
+  }
+
+  REQUIRE(!reader.next());
+}
+
+TEST_CASE("Streaming Saddle Connections with Large Chains", "[saddle_connections][writer][reader]") {
+  using T = mpq_class;
+  using Surface = FlatTriangulation<T>;
+
+  const auto surface = makeSquare<Vector<T>>();
+
+  const auto connection = SaddleConnection<Surface>(*surface, HalfEdge(1));
+  const auto large = SaddleConnection<Surface>(*surface, HalfEdge(1), HalfEdge(1), Chain<Surface>(*surface, HalfEdge(1)) * (mpz_class(1) << 70) + Chain<Surface>(*surface, HalfEdge(2)));
+
+  std::stringstream stream;
+
+  {
+    SaddleConnectionsWriter<Surface> writer(stream);
+    writer << connection;
+    REQUIRE_THROWS_AS(writer << large, std::logic_error);
+    REQUIRE(writer.size() == 1);
+  }
+
+  // The rejected connection must not leave a partial record behind.
+  SaddleConnectionsReader reader(*surface, stream);
+  REQUIRE(reader.next());
+  REQUIRE(reader.connection() == connection);
+  REQUIRE(!reader.next());
+}
+
+TEST_CASE("Streaming Saddle Connections of Another Surface", "[saddle_connections][writer][reader]") {
+  using T = long long;
+  using Surface = FlatTriangulation<T>;
+
+  const auto square = makeSquare<Vector<T>>();
+  const auto L = makeL<Vector<T>>();
+  REQUIRE(L->edges().size() > square->edges().size());
+
+  std::stringstream stream;
+
+  {
+    SaddleConnectionsWriter<Surface> writer(stream);
+    writer << L->connections().bound(8).byLength();
+  }
+
+  // Records that refer to half edges or edges that the surface does not have
+  // must be rejected.
+  SaddleConnectionsReader reader(*square, stream);
+  const auto readAll = [&]() {
+    while (reader.next()) continue;
+  };
+  REQUIRE_THROWS_AS(readAll(), std::invalid_argument);
+}
+
+TEMPLATE_TEST_CASE("Export Saddle Connections", "[saddle_connections][export]", (long long), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::NumberField>)) {
+  using T = TestType;
+
+  const auto [name, surface_] = GENERATE(makeSurface<T>());
+  const auto surface = *surface_;
+
+  CAPTURE(*name);
+
+  const auto connections = surface->connections().bound(8);
+  const SaddleConnectionsExport exported(connections, true);
+
+  const size_t edges = surface->edges().size();
+  REQUIRE(exported.edges() == edges);
+
+  size_t i = 0;
+  for (const auto& connection : connections) {
+    REQUIRE(i < exported.size());
+    REQUIRE(exported.sources()[i] == connection.source().id());
+    REQUIRE(exported.targets()[i] == connection.target().id());
+
+    const auto approximate = static_cast<std::complex<double>>(connection.vector());
+    REQUIRE(approximate.real() == Approx(exported.holonomies()[2 * i]));
+    REQUIRE(approximate.imag() == Approx(exported.holonomies()[2 * i + 1]));
+
+    Vector<T> holonomy;
+    for (auto edge : surface->edges())
+      holonomy += surface->fromHalfEdge(edge.positive()) * mpz_class(static_cast<long>(exported.chains()[i * edges + edge.index()]));
+    REQUIRE(holonomy == connection.vector());
+
+    i++;
+  }
+
+  REQUIRE(i == exported.size());
+}
+
 }  // namespace flatsurf::test
@@ -0,0 +1,111 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <e-antic/renfxx.h>
+
+#include <thread>
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/ccw.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connections.hpp"
+#include "../flatsurf/saddle_connections_iterator.hpp"
+#include "../flatsurf/statistics.hpp"
+#include "../flatsurf/vector.hpp"
+#include "external/catch2/single_include/catch2/catch.hpp"
+#include "surfaces.hpp"
+
+namespace flatsurf::test {
+
+TEST_CASE("Statistics Count Operations", "[statistics]") {
+  using R2 = Vector<eantic::renf_elem_class>;
+
+  const auto square = makeSquare<R2>();
+
+  const auto before = Statistics::thread();
+
+  square->flip(HalfEdge(1));
+  square->flip(HalfEdge(1));
+
+  for (const auto& connection : square->connections().bound(Bound(8, 0)))
+    (void)connection;
+
+  const auto counted = Statistics::thread() - before;
+
+  if (Statistics::enabled()) {
+    REQUIRE(counted.flips == 2);
+    REQUIRE(counted.searchNodesVisited > 0);
+    REQUIRE(counted.approximatePredicates > 0);
+
+    unsigned long long decided = 0;
+    for (const auto& counts : counted.precisions)
+      for (const auto count : counts)
+        decided += count;
+    REQUIRE(decided == counted.approximatePredicates + counted.exactPredicates);
+  } else {
+    REQUIRE(counted == Statistics());
+  }
+}
+
+TEST_CASE("Statistics Record Precision of Predicates", "[statistics]") {
+  using R2 = Vector<eantic::renf_elem_class>;
+
+  const auto a = K->gen();
+  const auto epsilon = mpq_class(1, mpz_class(1) << 80);
+
+  const auto before = Statistics::thread();
+
+  // Decided at the first precision.
+  REQUIRE(R2(a, 1).ccw(R2(1, a)) == CCW::COUNTERCLOCKWISE);
+  // Decided only once the precision has been doubled.
+  REQUIRE(R2(a, 1).ccw(R2(a + epsilon, 1)) == CCW::CLOCKWISE);
+  // Collinear vectors with irrational coordinates cannot be decided with balls.
+  REQUIRE(R2(a, a).ccw(R2(2 * a, 2 * a)) == CCW::COLLINEAR);
+
+  const auto counted = Statistics::thread() - before;
+  const auto& ccw = counted.precisions[static_cast<size_t>(Statistics::PREDICATE::CCW)];
+
+  if (Statistics::enabled()) {
+    REQUIRE(ccw[0] == 1);
+    REQUIRE(ccw[1] == 1);
+    REQUIRE(ccw[Statistics::PRECISIONS] == 1);
+    REQUIRE(counted.exactPredicates == 1);
+  } else {
+    REQUIRE(counted == Statistics());
+  }
+}
+
+TEST_CASE("Statistics Aggregate Threads", "[statistics]") {
+  using R2 = Vector<long long>;
+
+  const auto before = Statistics::total();
+
+  std::thread([]() {
+    const auto square = makeSquare<R2>();
+    square->flip(HalfEdge(1));
+  }).join();
+
+  const auto counted = Statistics::total() - before;
+
+  REQUIRE(counted.flips == (Statistics::enabled() ? 1 : 0));
+}
+
+}  // namespace flatsurf::test
@@ -28,7 +28,9 @@
 #include <exact-real/module.hpp>
 #include <exact-real/number_field.hpp>
 #include <exact-real/real_number.hpp>
+#include <cstdlib>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 #include "../flatsurf/flat_triangulation.hpp"
@@ -288,6 +290,58 @@ auto make1234() {
   return std::make_shared<FlatTriangulation<typename R2::Coordinate>>(std::move(*make1234Combinatorial()), vectors);
 }
 
+// Return the cover of the given closed surface whose sheets are glued
+// according to the given permutations, i.e., when crossing the edge e from
+// the face of its positive half edge in the sheet k, we end up in the sheet
+// sheets[e.index()][k].
+template <typename T>
+auto makeCover(const FlatTriangulation<T>& surface, const vector<vector<int>>& sheets) {
+  const int n = static_cast<int>(surface.size());
+  const int degree = static_cast<int>(sheets.at(0).size());
+
+  vector<vector<int>> inverse(n, vector<int>(degree));
+  for (int e = 0; e < n; e++)
+    for (int sheet = 0; sheet < degree; sheet++)
+      inverse[e][sheets[e][sheet]] = sheet;
+
+  // Return the copy of the half edge he that bounds the copy of its face in
+  // the given sheet.
+  const auto lift = [&](HalfEdge he, int sheet) {
+    const int edge = std::abs(he.id());
+    if (he.id() > 0)
+      return HalfEdge(sheet * n + edge);
+    return -HalfEdge(inverse[edge - 1][sheet] * n + edge);
+  };
+
+  vector<std::tuple<HalfEdge, HalfEdge, HalfEdge>> faces;
+  for (int sheet = 0; sheet < degree; sheet++)
+    for (const auto& [a, b, c] : surface.faces())
+      faces.push_back({lift(a, sheet), lift(b, sheet), lift(c, sheet)});
+
+  return std::make_shared<FlatTriangulation<T>>(FlatTriangulationCombinatorial(faces), [&](HalfEdge he) {
+    const int edge = (std::abs(he.id()) - 1) % n + 1;
+    return surface.fromHalfEdge(HalfEdge(he.id() > 0 ? edge : -edge));
+  });
+}
+
+// Return the cyclic cover of the given closed surface of the given degree.
+// The sheets of the cover are permuted cyclically when crossing the first
+// edge of the surface. For the surfaces above, this produces connected
+// surfaces whose genus and number of edges grow linearly with the degree,
+// which lets us measure how our algorithms scale with the size of a surface
+// while its local geometry stays the same.
+template <typename T>
+auto makeCyclicCover(const FlatTriangulation<T>& surface, int degree) {
+  vector<vector<int>> sheets(surface.size(), vector<int>(degree));
+  for (int sheet = 0; sheet < degree; sheet++) {
+    sheets[0][sheet] = (sheet + 1) % degree;
+    for (size_t e = 1; e < surface.size(); e++)
+      sheets[e][sheet] = sheet;
+  }
+
+  return makeCover(surface, sheets);
+}
+
 }  // namespace flatsurf::test
 
 #endif
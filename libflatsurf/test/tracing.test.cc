@@ -0,0 +1,73 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flow_decomposition.hpp"
+#include "../flatsurf/tracing.hpp"
+#include "../flatsurf/vector.hpp"
+#include "external/catch2/single_include/catch2/catch.hpp"
+#include "surfaces.hpp"
+
+namespace flatsurf::test {
+
+TEST_CASE("Tracing Records Phases of a Flow Decomposition", "[tracing]") {
+  using R2 = Vector<long long>;
+
+  const auto square = makeSquare<R2>();
+
+  char path[] = "/tmp/flatsurf-trace-XXXXXX";
+  const int fd = mkstemp(path);
+  REQUIRE(fd != -1);
+  close(fd);
+
+  Tracing::start(path);
+  REQUIRE(Tracing::enabled());
+
+  auto decomposition = FlowDecomposition<FlatTriangulation<long long>>(square->clone(), R2(1, 2));
+  REQUIRE(decomposition.decompose());
+
+  Tracing::stop();
+  REQUIRE(!Tracing::enabled());
+
+  std::stringstream trace;
+  trace << std::ifstream(path).rdbuf();
+  std::remove(path);
+
+  const std::string json = trace.str();
+  REQUIRE(json.front() == '[');
+  REQUIRE(json.find(']') != std::string::npos);
+  REQUIRE(json.find(R"("name": "FlatTriangulationCollapsed")") != std::string::npos);
+  REQUIRE(json.find(R"("name": "IntervalExchangeTransformation")") != std::string::npos);
+  REQUIRE(json.find(R"("name": "decompositionStep")") != std::string::npos);
+  REQUIRE(json.find(R"("direction": "(1, 2)")") != std::string::npos);
+}
+
+TEST_CASE("Tracing Is Off By Default", "[tracing]") {
+  if (std::getenv("LIBFLATSURF_TRACE") == nullptr)
+    REQUIRE(!Tracing::enabled());
+}
+
+}  // namespace flatsurf::test
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+######################################################################
+#  This file is part of flatsurf.
+#
+#        Copyright (C) 2020 Julian Rüth
+#
+#  flatsurf is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  flatsurf is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+######################################################################
+
+# Measure how long a fresh Python process needs to import pyflatsurf and to
+# run a first small computation, with and without the precompiled dictionary.
+# This is what every short-lived worker of a batch job pays before doing any
+# actual work.
+
+import argparse
+import os
+import statistics
+import subprocess
+import sys
+import time
+
+parser = argparse.ArgumentParser(description='Benchmark the startup time of pyflatsurf')
+parser.add_argument('--runs', type=int, default=5)
+parser.add_argument('--dictionary', type=str, default=None, help='path to the precompiled dictionary; the installed one is used by default')
+
+args = parser.parse_args()
+
+# A first computation that needs the most common instantiations.
+WORKER = r"""
+from pyflatsurf import flatsurf, Surface
+from pyeantic import eantic
+
+K = eantic.renf_class.make("x^2 - 3", "x", "1.73 +/- 0.1")
+R2 = flatsurf.Vector['eantic::renf_elem_class']
+R = lambda x: eantic.renf_elem(K, x)
+square = Surface([[1, 3, 2, -1, -3, -2]], [R2(R(1), R(0)), R2(R(0), R(1)), R2(R(1), R(1))])
+connection = next(iter(square.connections().bound(2)))
+flatsurf.makeFlowDecomposition(square, connection.vector()).decompose(-1)
+"""
+
+def measure(dictionary):
+    env = dict(os.environ)
+    if dictionary is None:
+        env.pop('PYFLATSURF_DICTIONARY', None)
+    else:
+        env['PYFLATSURF_DICTIONARY'] = dictionary
+
+    timings = []
+    for run in range(args.runs):
+        start = time.perf_counter()
+        subprocess.check_call([sys.executable, "-c", WORKER], env=env)
+        timings.append(time.perf_counter() - start)
+    return timings
+
+for name, dictionary in [("without dictionary", "no"), ("with dictionary", args.dictionary)]:
+    timings = measure(dictionary)
+    print("%-20s median %.2fs (min %.2fs, max %.2fs)" % (name, statistics.median(timings), min(timings), max(timings)))
@@ -55,21 +55,166 @@ cppyy.py.add_pythonization(filtered(re.compile("vector<flatsurf::.*>"))(enable_l
 cppyy.py.add_pythonization(filtered(re.compile("FlatTriangulation<.*>"))(wrap_method("__add__")(lambda self, cpp, rhs: cpp(cppyy.gbl.flatsurf.makeOddHalfEdgeMap[cppyy.gbl.flatsurf.Vector[type(self).Coordinate]](self.combinatorial(), rhs)))), "flatsurf")
 
 
+# Long running computations go through the entry points in
+# flatsurf::concurrent. For coordinates that are thread-safe, we call these
+# without holding the GIL. So other Python threads can make progress
+# meanwhile, e.g., when running several flow decompositions in a thread pool.
+# Other coordinates, such as renf_elem_class, keep shared state that Python
+# threads modify whenever they do arithmetic, so we keep the GIL for them.
+def _nogil(name, template):
+    function = getattr(cppyy.gbl.flatsurf.concurrent, name)[template]
+    function.__release_gil__ = _threadsafe(template)
+    return function
+
+_threadsafe_cache = {}
+
+def _threadsafe(template):
+    if template not in _threadsafe_cache:
+        _threadsafe_cache[template] = bool(cppyy.gbl.flatsurf.concurrent.threadsafe[template]())
+    return _threadsafe_cache[template]
+
 # We cannot call decompose() directly due to https://bitbucket.org/wlav/cppyy/issues/273/segfault-in-cpycppyy-anonymous-namespace
-cppyy.py.add_pythonization(filtered(re.compile("FlowDecomposition<.*>"))(add_method("decompose")(lambda self, *args: cppyy.gbl.flatsurf.decomposeFlowDecomposition(self, *args))), "flatsurf")
+cppyy.py.add_pythonization(filtered(re.compile("FlowDecomposition<.*>"))(add_method("decompose")(lambda self, *args: _nogil("decompose", type(self.surface()).__cpp_name__)(self, *args))), "flatsurf")
 cppyy.py.add_pythonization(filtered(re.compile("FlowDecomposition<.*>"))(add_method("cylinders")(lambda self: [component for component in self.components() if component.cylinder()])), "flatsurf")
 cppyy.py.add_pythonization(filtered(re.compile("FlowDecomposition<.*>"))(add_method("minimalComponents")(lambda self: [component for component in self.components() if component.withoutPeriodicTrajectory()])), "flatsurf")
 cppyy.py.add_pythonization(filtered(re.compile("FlowDecomposition<.*>"))(add_method("undeterminedComponents")(lambda self: [component for component in self.components() if not (component.cylinder() == True) and not (component.withoutPeriodicTrajectory() == True)])), "flatsurf")
 cppyy.py.add_pythonization(filtered(re.compile("FlowDecomposition<.*>"))(add_method("__str__")(lambda self: "FlowDecomposition with %d cylinders, %d minimal components and %d undetermined components" % (len(self.cylinders()), len(self.minimalComponents()), len(self.undeterminedComponents())))), "flatsurf")
 
-# We have to workaround issues with complex std::function parameters in cppyy
-cppyy.py.add_pythonization(filtered(re.compile("FlatTriangulation<.*>"))(add_method("isomorphism")(lambda self, other, kind=None, filter_matrix=lambda a,b,c,d: a == 1 and b == 0 and c == 0 and d == 1, filter_map=lambda a, b: True: cppyy.gbl.flatsurf.isomorphism[type(self).Coordinate.__cpp_name__](self, other, kind or cppyy.gbl.flatsurf.ISOMORPHISM.FACES, lambda m: filter_matrix(m.a, m.b, m.c, m.d), filter_map))), "flatsurf")
-
+# We have to workaround issues with complex std::function parameters in cppyy.
+# Filters that are predefined in C++, i.e., an ISOMORPHISM_FILTER or a list of
+# matrices (a, b, c, d), are evaluated without calling into Python for every
+# candidate.
+def _isomorphism(self, other, kind=None, filter_matrix=None, filter_map=None):
+    T = type(self).Coordinate.__cpp_name__
+    if kind is None:
+        kind = cppyy.gbl.flatsurf.ISOMORPHISM.FACES
+    if filter_matrix is None:
+        if filter_map is None:
+            filter_matrix = cppyy.gbl.flatsurf.ISOMORPHISM_FILTER.IDENTITY
+        else:
+            filter_matrix = lambda a, b, c, d: a == d == 1 and b == c == 0
+
+    if not callable(filter_matrix):
+        if filter_map is not None:
+            raise NotImplementedError("filter_map can only be combined with a callable filter_matrix")
+        if isinstance(filter_matrix, (list, tuple)):
+            matrices = std.vector[cppyy.gbl.flatsurf.IsomorphismFilterMatrix[T]]()
+            for (a, b, c, d) in filter_matrix:
+                matrices.push_back(cppyy.gbl.flatsurf.IsomorphismFilterMatrix[T](a, b, c, d))
+            filter_matrix = matrices
+        return _nogil("isomorphism", T)(self, other, kind, filter_matrix)
+
+    if filter_map is None:
+        filter_map = lambda a, b: True
+    return cppyy.gbl.flatsurf.isomorphism[T](self, other, kind, lambda m: filter_matrix(m.a, m.b, m.c, m.d), filter_map)
+
+cppyy.py.add_pythonization(filtered(re.compile("FlatTriangulation<.*>"))(add_method("isomorphism")(_isomorphism)), "flatsurf")
+
+# Flip to the Delaunay triangulation without holding the GIL; delaunay(edge)
+# is cheap and goes to C++ directly.
+cppyy.py.add_pythonization(filtered(re.compile("FlatTriangulation<.*>"))(wrap_method("delaunay")(lambda self, cpp, *args: cpp(*args) if args else _nogil("delaunay", type(self).Coordinate.__cpp_name__)(self))), "flatsurf")
+
+def _collect(self):
+    r"""
+    Return all the saddle connections in this bounded range as a list.
+
+    The enumeration runs without holding the GIL.
+
+    >>> from pyflatsurf import Surface, flatsurf
+    >>> R2 = flatsurf.Vector['long long']
+    >>> square = Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+    >>> len(square.connections().bound(2).collect())
+    8
+
+    """
+    return list(_nogil("connections", type(self.surface()).__cpp_name__)(self))
+
+cppyy.py.add_pythonization(filtered(re.compile("SaddleConnections<.*>"))(add_method("collect")(_collect)), "flatsurf")
+
+# Iterating over saddle connections from Python creates several proxy objects
+# for every saddle connection. Instead, we export all the data of a range of
+# saddle connections in a single call into contiguous buffers and wrap these
+# as NumPy arrays.
+def _vector_to_numpy(vector, dtype):
+    import numpy
+    if vector.size() == 0:
+        return numpy.zeros(0, dtype=dtype)
+    view = vector.data()
+    view.reshape((vector.size(),))
+    return numpy.frombuffer(view, dtype=dtype, count=vector.size()).copy()
+
+def _to_numpy(self, chains=False):
+    r"""
+    Return the saddle connections of this range as NumPy arrays.
+
+    Returns a dict with the double approximations of the ``holonomies`` (an
+    array of shape ``(n, 2)``), the ids of the ``sources`` and ``targets``
+    half edges, and, if ``chains`` is set, the ``chains`` of the saddle
+    connections (an array of shape ``(n, edges)``) whose rows are the
+    coefficients of the exact holonomies in terms of the edge vectors.
+
+    >>> from pyflatsurf import Surface, flatsurf
+    >>> R2 = flatsurf.Vector['long long']
+    >>> square = Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+    >>> exported = square.connections().bound(2).to_numpy(chains=True)
+    >>> exported['holonomies'].shape
+    (8, 2)
+    >>> exported['chains'].shape
+    (8, 3)
+
+    """
+    import numpy
+    Surface = type(self.surface()).__cpp_name__
+    exported = _nogil("exportConnections", Surface)(self, chains)
+    ret = {
+        'holonomies': _vector_to_numpy(exported.holonomies(), numpy.float64).reshape((exported.size(), 2)),
+        'sources': _vector_to_numpy(exported.sources(), numpy.int32),
+        'targets': _vector_to_numpy(exported.targets(), numpy.int32),
+    }
+    if chains:
+        ret['chains'] = _vector_to_numpy(exported.chains(), numpy.int64).reshape((exported.size(), exported.edges()))
+    return ret
+
+cppyy.py.add_pythonization(filtered(re.compile("SaddleConnections(ByLength)?<.*>"))(add_method("to_numpy")(_to_numpy)), "flatsurf")
+
+# Statistics can be turned into a dict to be logged or fed into pandas.
+_STATISTICS = ["flips", "collapses", "trackedNotifications", "approximatePredicates", "exactPredicates", "chainRecomputations", "searchNodesVisited", "searchNodesPruned", "decompositionSteps", "inductionSteps"]
+# The precisions at which predicates were decided are reported as a dict of
+# lists with one entry per precision and a final entry for exact fallbacks.
+_PREDICATES = ["ccw", "orientation", "bound", "length", "chainBound"]
+cppyy.py.add_pythonization(filtered(re.compile("Statistics"))(add_method("asdict")(lambda self: dict({name: int(getattr(self, name)) for name in _STATISTICS}, precisions={name: [int(count) for count in counts] for name, counts in zip(_PREDICATES, self.precisions)}))), "flatsurf")
+
+# MemoryUsage can be turned into a dict of bytes per category (and their total.)
+_MEMORY_USAGE = ["surface", "approximations", "vertical", "collapsed", "decomposition", "connections", "chains"]
+cppyy.py.add_pythonization(filtered(re.compile("MemoryUsage"))(add_method("asdict")(lambda self: dict({name: int(getattr(self, name)) for name in _MEMORY_USAGE}, total=int(self.total())))), "flatsurf")
 
 for path in os.environ.get('PYFLATSURF_INCLUDE','').split(':'):
     if path: cppyy.add_include_path(path)
 
 
+def _load_dictionary():
+    r"""
+    Load the precompiled dictionary for the common instantiations of
+    libflatsurf's templates if it has been built, see src/Makefile.am.
+
+    With the dictionary, cling does not need to JIT compile these classes on
+    every import. The dictionary can be disabled by setting
+    PYFLATSURF_DICTIONARY=no or replaced by setting it to the path of another
+    dictionary library.
+    """
+    dictionary = os.environ.get('PYFLATSURF_DICTIONARY', os.path.join(os.path.dirname(__file__), 'libpyflatsurf_dictionary.so'))
+    if dictionary == 'no' or not os.path.exists(dictionary):
+        return False
+    cppyy.load_reflection_info(dictionary)
+    return True
+
+_load_dictionary()
+
+# The dictionary does not make this include redundant. It only contains the
+# classes selected in dictionary.xml, while the helper functions in cppyy.hpp
+# and the instantiations for the other coordinates still need the header.
+# benchmark/startup.py measures what this costs with and without the
+# dictionary.
 cppyy.include("flatsurf/cppyy.hpp")
 
 
@@ -29,6 +29,7 @@ from pyeantic.sage_conversion import sage_nf_to_eantic, sage_nf_elem_to_eantic
 parser = argparse.ArgumentParser(description='Survey a Triangle')
 parser.add_argument('angles', metavar='N', type=int, nargs='+')
 parser.add_argument('--bound', type=int, default=10)
+parser.add_argument('--write', type=str, default=None, help='write the unfolding to a library at this path for libflatsurf/survey/survey instead of surveying it here')
 
 args = parser.parse_args()
 
@@ -100,6 +101,16 @@ surface = Surface(vertices, vectors)
 
 print(surface)
 
+if args.write:
+    from cppyy.gbl import std
+    T = 'eantic::renf_elem_class'
+    surfaces = std.vector[flatsurf.FlatTriangulation[T]]()
+    surfaces.push_back(surface)
+    flatsurf.FlatTriangulationLibrary[T].write(args.write, surfaces)
+    print("Wrote unfolding to %s"%(args.write,))
+    import sys
+    sys.exit(0)
+
 for connection in surface.saddle_connections(flatsurf.Bound(args.bound, 0)):
     print("Investigating in direction %s"%(connection.vector()))
     decomposition = flatsurf.makeFlowDecomposition(surface, connection.vector())
@@ -141,10 +141,32 @@ def test_isomorphism():
     assert L.isomorphism(L, filter_matrix=lambda a, b, c, d: a == -1 and b == 0 and c == 0 and d == -1)
     assert not L.isomorphism(L, filter_matrix=lambda a, b, c, d: a*d - b*c not in [-1, 1])
 
+def test_isomorphism_native_filter():
+    vector = flatsurf.Vector['mpq_class']
+    L = surfaces.L(vector)
+    assert L.isomorphism(L, filter_matrix=flatsurf.ISOMORPHISM_FILTER.IDENTITY)
+    assert L.isomorphism(L, filter_matrix=flatsurf.ISOMORPHISM_FILTER.SL2Z)
+    assert L.isomorphism(L, filter_matrix=[(-1, 0, 0, -1)])
+    assert not L.isomorphism(L, filter_matrix=[(2, 0, 0, 2)])
+
+def test_isomorphism_filter_map():
+    vector = flatsurf.Vector['mpq_class']
+    L = surfaces.L(vector)
+    assert L.isomorphism(L, filter_map=lambda a, b: a == b)
+    assert not L.isomorphism(L, filter_map=lambda a, b: False)
+    assert L.isomorphism(L, filter_matrix=lambda a, b, c, d: a == d == -1 and b == c == 0, filter_map=lambda a, b: a != b)
+
 def test_serialization():
     hexagon = surfaces.random_hexagon()
 
     from pickle import loads, dumps
     assert loads(dumps(hexagon)) == hexagon
 
+def test_memory_usage():
+    hexagon = surfaces.random_hexagon()
+
+    usage = hexagon.memoryUsage().asdict()
+    assert usage["surface"] > 0
+    assert usage["total"] == sum(bytes for (category, bytes) in usage.items() if category != "total")
+
 if __name__ == '__main__': sys.exit(pytest.main(sys.argv))
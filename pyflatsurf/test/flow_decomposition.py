@@ -127,4 +127,25 @@ def test_undetermined():
     decomposition.decompose(-1)
     assert len(decomposition.undeterminedComponents()) == 0
 
+def test_threads():
+    r"""
+    Run several decompositions concurrently; decompose() releases the GIL
+    for coordinates that are thread-safe such as mpq_class.
+    """
+    from concurrent.futures import ThreadPoolExecutor
+
+    S = surfaces.L(flatsurf.Vector['mpq_class'])
+    directions = [connection.vector() for connection in S.connections().bound(8).collect()]
+
+    def decompose(v):
+        decomposition = flatsurf.makeFlowDecomposition(S, v)
+        decomposition.decompose(-1)
+        return len(decomposition.cylinders()), len(decomposition.minimalComponents())
+
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        decompositions = list(pool.map(decompose, directions))
+
+    assert decompositions == [decompose(v) for v in directions]
+    assert len(decompositions) > 0
+
 if __name__ == '__main__': sys.exit(pytest.main(sys.argv))
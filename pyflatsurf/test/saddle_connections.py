@@ -70,6 +70,21 @@ def test_hexagon_exactreal():
     connections = surface.connections().bound(16).sector(flatsurf.HalfEdge(1))
     assert len([1 for c in connections]) >= 10
 
+def test_to_numpy():
+    import numpy
+    surface = surfaces.L(flatsurf.Vector['mpq_class'])
+    connections = surface.connections().bound(16).byLength()
+    exported = connections.to_numpy(chains=True)
+
+    assert exported['holonomies'].shape == (len(exported['sources']), 2)
+    assert exported['chains'].shape == (len(exported['sources']), surface.size())
+
+    for i, connection in enumerate(connections):
+        assert exported['sources'][i] == connection.source().id()
+        assert exported['targets'][i] == connection.target().id()
+        assert exported['holonomies'][i][0] == pytest.approx(connection.vector().x().get_d())
+        assert exported['holonomies'][i][1] == pytest.approx(connection.vector().y().get_d())
+
 def test_printing():
     for coefficients in ['long long', 'mpz_class', 'mpq_class', 'eantic::renf_elem_class', 'exactreal::Element<exactreal::IntegerRing>', 'exactreal::Element<exactreal::RationalField>', 'exactreal::Element<exactreal::NumberField>']:
         surface = surfaces.square(flatsurf.Vector[coefficients])
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+######################################################################
+# This file is part of flatsurf.
+#
+#       Copyright (C) 2020 Julian Rüth
+#
+# flatsurf is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# flatsurf is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+######################################################################
+
+import sys
+import pytest
+
+from pyflatsurf import flatsurf
+import surfaces
+
+def test_flips():
+    square = surfaces.square(flatsurf.Vector['mpq_class'])
+
+    before = flatsurf.Statistics.thread()
+    square.flip(flatsurf.HalfEdge(1))
+    counted = flatsurf.Statistics.thread() - before
+
+    assert counted.flips == (1 if flatsurf.Statistics.enabled() else 0)
+    assert counted.asdict()["flips"] == counted.flips
+
+def test_total():
+    total = flatsurf.Statistics.total().asdict()
+    thread = flatsurf.Statistics.thread().asdict()
+    assert all(total[name] >= thread[name] for name in total if name != "precisions")
+
+def test_precisions():
+    hexagon = surfaces.hexagon()
+
+    before = flatsurf.Statistics.thread()
+    for connection in hexagon.connections().bound(8):
+        pass
+    counted = (flatsurf.Statistics.thread() - before).asdict()
+
+    decided = sum(sum(counts) for counts in counted["precisions"].values())
+    assert decided == counted["approximatePredicates"] + counted["exactPredicates"]
+
+if __name__ == '__main__': sys.exit(pytest.main(sys.argv))
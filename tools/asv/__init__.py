@@ -32,4 +32,8 @@ if not ASV_PROJECT_DIR:
     else:
         ASV_PROJECT_DIR = join(os.path.dirname(os.path.abspath(__file__)), "..", "..")
 
-locals().update(create_wrappers(join(ASV_PROJECT_DIR, "libflatsurf", "benchmark", "benchmark")))
+# Report the timings recorded by tools/cppbench.py instead of running the
+# benchmarks again, e.g., to show a run recorded on a dedicated machine.
+CPPASV_RESULTS = os.environ.get('CPPASV_RESULTS', None)
+
+locals().update(create_wrappers(join(ASV_PROJECT_DIR, "libflatsurf", "benchmark", "benchmark"), CPPASV_RESULTS))
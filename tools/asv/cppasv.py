@@ -28,16 +28,26 @@
 
 import subprocess
 
-def create_wrappers(benchmark):
+def create_wrappers(benchmark, results=None):
     r"""
     Return ASV compatible benchmark classes that contain a `track_time` method
     for each benchmark exported by the Google Benchmark binary `benchmark`.
+
+    If `results` is the path of the JSON output of a previous run of
+    `benchmark`, the benchmarks are not run again but report the median of
+    the timings recorded there.
     """
-    benchmarks = subprocess.check_output([benchmark, "--benchmark_list_tests"]).decode('UTF-8').split('\n')
+    if results is None:
+        benchmarks = subprocess.check_output([benchmark, "--benchmark_list_tests"]).decode('UTF-8').split('\n')
+    else:
+        import json
+        with open(results) as recorded:
+            results = recorded_times(json.load(recorded))
+        benchmarks = list(results)
 
     benchmarks = [benchmark.strip().split('/') for benchmark in benchmarks if benchmark.strip()]
 
-    benchmarks = create_time_methods(benchmark, benchmarks)
+    benchmarks = create_time_methods(benchmark, benchmarks, results)
 
     benchmarks = { sanitize_benchmark_name(benchmark): benchmarks[benchmark] for benchmark in benchmarks }
 
@@ -65,13 +75,33 @@ def sanitize_benchmark_name(name):
 
     return name
 
-def create_time_methods(benchmark, benchmarks):
+def recorded_times(results):
+    r"""
+    Return a mapping from benchmark names to the median of their CPU times in
+    ns in the Google Benchmark JSON output `results`.
+    """
+    import statistics
+    units = { "ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9 }
+
+    times = {}
+    for benchmark in results["benchmarks"]:
+        if benchmark.get("run_type", "iteration") != "iteration":
+            continue
+        name = benchmark.get("run_name", benchmark["name"])
+        times.setdefault(name, []).append(benchmark["cpu_time"] * units[benchmark["time_unit"]])
+
+    return { name: statistics.median(time) for (name, time) in times.items() }
+
+def create_time_methods(benchmark, benchmarks, results=None):
     r"""
     Return a mapping from sanitized benchmark names to Python methods that run that benchmark.
     """
     toplevel = set(b[0] for b in benchmarks)
 
-    time_methods = { name: create_time_method(benchmark, name) for name in toplevel }
+    if results is None:
+        time_methods = { name: create_time_method(benchmark, name) for name in toplevel }
+    else:
+        time_methods = { name: create_recorded_time_method(results, name) for name in toplevel }
     
     params = { name: [tuple(b[1:]) for b in benchmarks if b[0] == name] for name in toplevel }
 
@@ -81,6 +111,26 @@ def create_time_methods(benchmark, benchmarks):
 
     return time_methods
 
+def create_recorded_time_method(results, name):
+    r"""
+    Return a method that reports the time recorded for the Google Benchmark called `name` in `results`.
+    """
+    def recorded_benchmark(self, params=None):
+        if params:
+            return results[f"{name}/{params.replace(', ', '/')}"]
+        # Benchmarks with a single set of parameters are not parametrized in ASV.
+        matches = [key for key in results if key == name or key.startswith(f"{name}/")]
+        assert(len(matches) == 1)
+        return results[matches[0]]
+
+    recorded_benchmark.unit = "ns"
+    recorded_benchmark.version = 0
+    recorded_benchmark.repeat = 1
+    recorded_benchmark.number = 1
+    recorded_benchmark.min_run_count = 1
+
+    return recorded_benchmark
+
 def create_time_method(benchmark, name):
     r"""
     Return a method that runs the benchmark binary `benchmark` on the Google Benchmark called `name`.
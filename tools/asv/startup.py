@@ -0,0 +1,52 @@
+# -*- coding: utf-8 -*-
+#*********************************************************************
+#  This file is part of flatsurf.
+#
+#        Copyright (C) 2020 Julian Rüth
+#
+#  Flatsurf is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 2 of the License, or
+#  (at your option) any later version.
+#
+#  Flatsurf is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+#*********************************************************************
+
+# Time the Python side next to the C++ benchmarks in the same dashboard. Like
+# pyflatsurf/benchmark/startup.py, this measures how long a fresh process
+# needs to import pyflatsurf and to run a first small computation.
+
+import importlib.util
+import subprocess
+import sys
+import time
+
+WORKER = r"""
+from pyflatsurf import flatsurf, Surface
+R2 = flatsurf.Vector['long long']
+square = Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+flatsurf.makeFlowDecomposition(square, R2(1, 2)).decompose(-1)
+"""
+
+class PyflatsurfStartup:
+    unit = "s"
+
+    repeat = 1
+    number = 1
+    min_run_count = 1
+
+    def setup(self):
+        if importlib.util.find_spec("pyflatsurf") is None:
+            # Tells ASV to skip this benchmark since pyflatsurf is not installed in this environment.
+            raise NotImplementedError("pyflatsurf is not installed")
+
+    def track_startup(self):
+        start = time.perf_counter()
+        subprocess.check_call([sys.executable, "-c", WORKER])
+        return time.perf_counter() - start
@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+######################################################################
+#  This file is part of flatsurf.
+#
+#        Copyright (C) 2020 Julian Rüth
+#
+#  flatsurf is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  flatsurf is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+######################################################################
+
+# Track the performance of the C++ benchmarks in libflatsurf/benchmark over
+# time without any external services.
+#
+# `run` executes the Google Benchmark binary with repetitions and stores its
+# JSON output as <results>/<commit>.json. `baseline` marks such a run as the
+# reference. `compare` reports the benchmarks whose timings differ
+# significantly between two runs and exits with a non-zero status if any of
+# them got slower. Runs in the results directory can also be shown in the asv
+# dashboard, see tools/asv.
+
+import argparse
+import datetime
+import json
+import math
+import os
+import statistics
+import subprocess
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+UNITS = {"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def git(*args):
+    return subprocess.check_output(["git", "-C", ROOT] + list(args)).decode("UTF-8").strip()
+
+
+def commit(revision="HEAD"):
+    r"""
+    Return the full hash of `revision` with a `-dirty` suffix if `revision`
+    is the checked out commit and the working tree has uncommitted changes.
+    """
+    sha = git("rev-parse", revision)
+    if revision == "HEAD" and git("status", "--porcelain", "--untracked-files=no"):
+        sha += "-dirty"
+    return sha
+
+
+def path(results, revision):
+    r"""
+    Return the file in `results` holding the run for `revision`; `revision`
+    can be anything that git understands or the name of a stored run.
+    """
+    if os.path.exists(os.path.join(results, revision + ".json")):
+        return os.path.join(results, revision + ".json")
+    return os.path.join(results, commit(revision) + ".json")
+
+
+def samples(run):
+    r"""
+    Return a mapping from benchmark names to the CPU time in ns of each of
+    their repetitions in the Google Benchmark JSON output `run`.
+    """
+    times = {}
+    for benchmark in run["benchmarks"]:
+        if benchmark.get("run_type", "iteration") != "iteration":
+            continue
+        name = benchmark.get("run_name", benchmark["name"])
+        times.setdefault(name, []).append(benchmark["cpu_time"] * UNITS[benchmark["time_unit"]])
+    return times
+
+
+def mann_whitney(xs, ys):
+    r"""
+    Return the two-sided p-value of the Mann-Whitney U test that the samples
+    `xs` and `ys` come from the same distribution.
+
+    We use the normal approximation with a correction for ties which is
+    reasonably accurate from about five repetitions on.
+    """
+    n, m = len(xs), len(ys)
+    ranked = sorted([(x, 0) for x in xs] + [(y, 1) for y in ys])
+
+    ranks = [0.] * len(ranked)
+    ties = 0
+    i = 0
+    while i < len(ranked):
+        j = i
+        while j + 1 < len(ranked) and ranked[j + 1][0] == ranked[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2 + 1
+        ties += (j - i + 1) ** 3 - (j - i + 1)
+        i = j + 1
+
+    u = sum(rank for rank, (_, sample) in zip(ranks, ranked) if sample == 0) - n * (n + 1) / 2
+
+    variance = n * m / 12 * ((n + m + 1) - ties / ((n + m) * (n + m - 1)))
+    if variance == 0:
+        return 1.
+    z = (abs(u - n * m / 2) - .5) / math.sqrt(variance)
+    return math.erfc(max(z, 0) / math.sqrt(2))
+
+
+def run(args):
+    os.makedirs(args.results, exist_ok=True)
+
+    command = [args.binary, "--benchmark_format=json", f"--benchmark_repetitions={args.repetitions}"]
+    if args.filter:
+        command.append(f"--benchmark_filter={args.filter}")
+    if args.min_time:
+        command.append(f"--benchmark_min_time={args.min_time}")
+
+    output = json.loads(subprocess.check_output(command))
+
+    sha = commit()
+    output["flatsurf"] = {
+        "commit": sha,
+        "date": datetime.datetime.now(datetime.timezone.utc).isoformat(),
+        "command": command,
+    }
+
+    target = os.path.join(args.results, sha + ".json")
+    with open(target, "w") as results:
+        json.dump(output, results, indent=2)
+
+    print(f"Recorded {len(samples(output))} benchmarks in {target}")
+
+
+def baseline(args):
+    source = path(args.results, args.revision)
+    if not os.path.exists(source):
+        raise ValueError(f"no benchmark run recorded in {source}")
+
+    with open(os.path.join(args.results, "baseline"), "w") as marker:
+        marker.write(os.path.basename(source)[:-len(".json")] + "\n")
+
+    print(f"Using {source} as the baseline")
+
+
+def compare(args):
+    reference = args.baseline
+    if reference is None:
+        with open(os.path.join(args.results, "baseline")) as marker:
+            reference = marker.read().strip()
+
+    with open(path(args.results, reference)) as results:
+        before = samples(json.load(results))
+    with open(path(args.results, args.contender)) as results:
+        after = samples(json.load(results))
+
+    regressions = 0
+    inconclusive = 0
+    for name in sorted(set(before) & set(after)):
+        old, new = statistics.median(before[name]), statistics.median(after[name])
+        change = new / old - 1 if old else 0
+
+        if len(before[name]) < 2 or len(after[name]) < 2:
+            # Without repetitions we cannot say anything about the noise, so
+            # we cannot tell whether a change is significant.
+            p = 1.
+            inconclusive += 1
+            verdict = "inconclusive" if abs(change) >= args.threshold else ""
+        else:
+            p = mann_whitney(before[name], after[name])
+            if p >= args.alpha or abs(change) < args.threshold:
+                verdict = ""
+            elif change > 0:
+                verdict = "SLOWER"
+                regressions += 1
+            else:
+                verdict = "faster"
+
+        if verdict or args.verbose:
+            print(f"{name:<80} {old:>14.0f}ns {new:>14.0f}ns {change:>+8.1%} p={p:.3f} {verdict}")
+
+    for name in sorted(set(before) - set(after)):
+        print(f"{name:<80} only in the baseline")
+    for name in sorted(set(after) - set(before)):
+        print(f"{name:<80} only in the contender")
+
+    if inconclusive:
+        print(f"{inconclusive} benchmarks have fewer than 2 repetitions in one of the runs so their changes are inconclusive; record the runs with a higher --repetitions", file=sys.stderr)
+
+    if regressions:
+        print(f"{regressions} benchmarks got significantly slower", file=sys.stderr)
+        sys.exit(1)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Record and compare runs of the libflatsurf C++ benchmarks")
+    parser.add_argument("--results", default=os.path.join(ROOT, ".benchmark", "results"), help="directory holding the recorded runs")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    parser_run = commands.add_parser("run", help="run the benchmarks and record the timings for the current commit")
+    parser_run.add_argument("--binary", default=os.path.join(ROOT, "libflatsurf", "benchmark", "benchmark"), help="the Google Benchmark binary")
+    parser_run.add_argument("--repetitions", type=int, default=10, help="how often to repeat each benchmark to estimate the noise")
+    parser_run.add_argument("--filter", default=None, help="only run benchmarks matching this regular expression")
+    parser_run.add_argument("--min-time", default=None, help="minimum time in seconds per repetition")
+    parser_run.set_defaults(handler=run)
+
+    parser_baseline = commands.add_parser("baseline", help="use a recorded run as the baseline of future comparisons")
+    parser_baseline.add_argument("revision", nargs="?", default="HEAD")
+    parser_baseline.set_defaults(handler=baseline)
+
+    parser_compare = commands.add_parser("compare", help="report benchmarks that changed significantly")
+    parser_compare.add_argument("baseline", nargs="?", default=None, help="the reference run; defaults to the recorded baseline")
+    parser_compare.add_argument("contender", nargs="?", default="HEAD", help="the run to check; defaults to the current commit")
+    parser_compare.add_argument("--alpha", type=float, default=.05, help="significance level of the Mann-Whitney U test")
+    parser_compare.add_argument("--threshold", type=float, default=.05, help="ignore relative changes of the median smaller than this")
+    parser_compare.add_argument("--verbose", action="store_true", help="also show benchmarks that did not change")
+    parser_compare.set_defaults(handler=compare)
+
+    args = parser.parse_args(argv)
+    args.handler(args)
+
+
+if __name__ == "__main__":
+    main()